@@ -205,6 +205,22 @@ class HMCSystem(SubSystem):
     serial_link_speed = Param.UInt64(10, "Gbs/s speed of each lane of"
             "serial link")
 
+    # Packets are sent over the links as 16-byte FLITs, with one FLIT for
+    # the header and tail of every packet, so a 64-byte read is a 1-FLIT
+    # request and a 5-FLIT response [1]. Set it to '16B' to model this,
+    # the default of 0 serializes the bytes of the packets as before
+    link_flit_size = Param.MemorySize('0B', "Size of the link FLITs, "
+            "0 for no FLITs")
+
+    # Every packet is protected by a CRC, and a corrupted packet is sent
+    # again after a link-level retry. The retry latency covers the error
+    # notification to the transmitter and the replay from its retry
+    # buffer (Assumption)
+    link_flit_error_rate = Param.Float(0.0, "Probability of a FLIT being "
+            "corrupted on the link")
+    link_retry_latency = Param.Latency('30ns', "Latency of a link-level "
+            "retry")
+
    #*****************************PERFORMANCE MONITORING************************
     # The main monitor behind the HMC Controller
     enable_global_monitor = Param.Bool(False, "The main monitor behind the "
@@ -250,6 +266,16 @@ def config_host_hmc(options, system):
     except:
         pass;
 
+    try:
+        system.hmc_host.link_flit_size = options.link_flit_size
+    except:
+        pass;
+
+    try:
+        system.hmc_host.link_flit_error_rate = options.link_error_rate
+    except:
+        pass;
+
     # Serial link Controller with 16 SerDes links at 10 Gbps
     # with serial link ranges w.r.t to architecture
     system.hmc_host.seriallink = [SerialLink(ranges = options.ser_ranges[i],
@@ -257,7 +283,10 @@ def config_host_hmc(options, system):
         resp_size=system.hmc_host.link_buffer_size_rsp,
         num_lanes=system.hmc_host.num_lanes_per_link,
         link_speed=system.hmc_host.serial_link_speed,
-        delay=system.hmc_host.total_ctrl_latency)
+        delay=system.hmc_host.total_ctrl_latency,
+        flit_size=system.hmc_host.link_flit_size,
+        flit_error_rate=system.hmc_host.link_flit_error_rate,
+        retry_latency=system.hmc_host.link_retry_latency)
         for i in xrange(system.hmc_host.num_serial_links)]
 
     # enable global monitor
@@ -98,6 +98,7 @@ def create_mem_ctrl(cls, r, i, nbr_mem_ctrls, intlv_bits, intlv_size):
     """
 
     import math
+    from m5.util import fatal
     intlv_low_bit = int(math.log(intlv_size, 2))
 
     # Use basic hashing for the channel selection, and preferably use
@@ -117,6 +118,18 @@ def create_mem_ctrl(cls, r, i, nbr_mem_ctrls, intlv_bits, intlv_size):
         # for
         ctrl.channels = nbr_mem_ctrls
 
+        # A custom address mapping may hash every channel bit from
+        # its own set of address bits
+        channel_masks = [ long(m) for m in ctrl.addr_map_channel ]
+        if channel_masks and nbr_mem_ctrls > 1:
+            if len(channel_masks) != intlv_bits:
+                fatal("%s has %d channel masks for %d channels" %
+                      (cls.__name__, len(channel_masks), nbr_mem_ctrls))
+            ctrl.range = m5.objects.AddrRange(r.start, size = r.size(),
+                                              masks = channel_masks,
+                                              intlvMatch = i)
+            return ctrl
+
         # If the channel bits are appearing after the column
         # bits, we need to add the appropriate number of bits
         # for the row buffer size
@@ -178,16 +191,18 @@ def config_mem(options, system):
         subsystem.kernel_addr_check = False
         return
 
-    nbr_mem_ctrls = options.mem_channels
+    cls = get(options.mem_type)
+    mem_ctrls = []
+
+    # Memories with independent sub-channels, such as DDR5, model each
+    # sub-channel with its own controller
+    nbr_mem_ctrls = options.mem_channels * getattr(cls, '_subchannels', 1)
     import math
     from m5.util import fatal
     intlv_bits = int(math.log(nbr_mem_ctrls, 2))
     if 2 ** intlv_bits != nbr_mem_ctrls:
         fatal("Number of memory channels must be a power of 2")
 
-    cls = get(options.mem_type)
-    mem_ctrls = []
-
     if options.elastic_trace_en and not issubclass(cls, \
                                                     m5.objects.SimpleMemory):
         fatal("When elastic trace is enabled, configure mem-type as "
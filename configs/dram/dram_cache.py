@@ -0,0 +1,151 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import MemConfig
+
+# this script puts a DRAM cache, with its tags and data in an HBM
+# stack, in front of a DDR4 channel, and drives it with random traffic
+# that mostly goes to a working set that fits in the cache
+
+parser = optparse.OptionParser()
+
+parser.add_option("--cache-mem-type", type="choice",
+                  default="HBM_1000_4H_1x128",
+                  choices=MemConfig.mem_names(),
+                  help = "type of memory holding the cache")
+
+parser.add_option("--far-mem-type", type="choice", default="DDR4_2400_8x8",
+                  choices=MemConfig.mem_names(),
+                  help = "type of the far memory")
+
+parser.add_option("--cache-size", type="string", default="64MB",
+                  help = "capacity of the stacked DRAM")
+
+parser.add_option("--far-size", type="string", default="1GB",
+                  help = "capacity of the far memory")
+
+parser.add_option("--assoc", type="int", default=1,
+                  help = "ways per set, 1 being an Alloy cache")
+
+parser.add_option("--no-predictor", action="store_true",
+                  help = "disable the miss predictor")
+
+parser.add_option("--hot-size", type="string", default="32MB",
+                  help = "size of the working set")
+
+parser.add_option("--hot-perc", type="int", default=90,
+                  help = "percentage of the time spent in the working set")
+
+parser.add_option("--rd_perc", type="int", default=70,
+                  help = "Percentage of read commands")
+
+parser.add_option("--duration", type="string", default="1ms",
+                  help = "simulated time")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print "Error: script doesn't take any positional arguments"
+    sys.exit(1)
+
+far_range = AddrRange(0, size = options.far_size)
+hot_size = long(MemorySize(options.hot_size))
+
+if hot_size > far_range.size():
+    fatal("The working set does not fit in the far memory")
+
+# the stacked DRAM sits outside the address map of the system
+cache_range = AddrRange(0x100000000, size = options.cache_size)
+
+system = System(membus = IOXBar(width = 32))
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+system.mem_ranges = [far_range]
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+system.dram_cache = DRAMCache(cache_range = cache_range,
+                              assoc = options.assoc,
+                              miss_predictor = not options.no_predictor)
+
+system.cache_mem = MemConfig.get(options.cache_mem_type)(range = cache_range,
+                                                         in_addr_map = False)
+system.far_mem = MemConfig.get(options.far_mem_type)(range = far_range)
+
+system.membus.master = system.dram_cache.slave
+system.dram_cache.cache_port = system.cache_mem.port
+system.dram_cache.far_port = system.far_mem.port
+
+# alternate between a random state over the working set and one over
+# the entire far memory, staying in each for 1 us
+period = 1000000
+itt = 10000
+
+cfg_file_name = "configs/dram/dram_cache.cfg"
+cfg_file = open(cfg_file_name, 'w')
+
+cfg_file.write("STATE 0 %d RANDOM %d %d %d 64 %d %d 0\n" %
+               (period, options.rd_perc, far_range.start,
+                far_range.start + hot_size - 1, itt, itt))
+cfg_file.write("STATE 1 %d RANDOM %d %d %d 64 %d %d 0\n" %
+               (period, options.rd_perc, far_range.start, far_range.end,
+                itt, itt))
+cfg_file.write("INIT 0\n")
+
+hot = options.hot_perc / 100.0
+for state in range(2):
+    cfg_file.write("TRANSITION %d 0 %f\n" % (state, hot))
+    cfg_file.write("TRANSITION %d 1 %f\n" % (state, 1 - hot))
+
+cfg_file.close()
+
+system.tgen = TrafficGen(config_file = cfg_file_name)
+system.tgen.port = system.membus.slave
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+m5.simulate(long(Latency(options.duration).value * 1000000000000))
+
+print "DRAM cache run done at tick %d" % m5.curTick()
@@ -0,0 +1,186 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import optparse
+import os
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import MemConfig
+
+# this script compares the refresh modes of a DRAM controller
+# configuration, by driving one controller per mode with the same
+# saturating random traffic, and reporting the bandwidth each one
+# achieves, relative to the all-bank refresh, along with the number of
+# same-bank or per-bank refreshes and refresh management commands
+
+parser = optparse.OptionParser()
+
+parser.add_option("--mem-type", type="choice", default="DDR5_4400_4x8",
+                  choices=MemConfig.mem_names(),
+                  help = "type of memory to use")
+
+parser.add_option("--rd_perc", type="int", default=100,
+                  help = "Percentage of read commands")
+
+parser.add_option("--rfm-raaimt", type="int", default=0,
+                  help = "Activates that trigger a refresh management "
+                  "command in an extra run with the default refresh mode, "
+                  "0 leaves that run out")
+
+parser.add_option("--duration", type="string", default="1ms",
+                  help = "simulated time")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print "Error: script doesn't take any positional arguments"
+    sys.exit(1)
+
+cls = MemConfig.get(options.mem_type)
+
+if not issubclass(cls, m5.objects.DRAMCtrl):
+    fatal("This script assumes the memory is a DRAMCtrl subclass")
+
+# an instance to look at the timings
+ctrl = cls()
+
+banks = ctrl.banks_per_rank.value
+bank_groups = ctrl.bank_groups_per_rank.value
+tREFI = ctrl.tREFI.value
+tRP = ctrl.tRP.value
+tRFCsb = ctrl.tRFCsb.value
+
+# each run is a refresh mode and an RFM threshold, and the all-bank
+# refresh is the baseline the others are compared to
+runs = [('all_bank', 0)]
+
+# same-bank and per-bank refresh split tREFI over the bank sets, and
+# every set has to be refreshed before the next one is due
+if tRFCsb == 0:
+    print "%s has no tRFCsb, only all-bank refresh is run" % \
+        options.mem_type
+else:
+    if bank_groups > 1:
+        if tREFI / (banks / bank_groups) > tRP + tRFCsb:
+            runs.append(('same_bank', 0))
+        else:
+            print "tREFI is too short for same-bank refresh"
+    if tREFI / banks > tRP + tRFCsb:
+        runs.append(('per_bank', 0))
+    else:
+        print "tREFI is too short for per-bank refresh"
+
+if options.rfm_raaimt:
+    if ctrl.tRFM.value == 0:
+        fatal("%s has no tRFM for refresh management" % options.mem_type)
+    runs.append((ctrl.refresh_mode.value, options.rfm_raaimt))
+
+system = System(membus = IOXBar(width = 32))
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+# 256 MB per controller, one after the other
+system.mem_ranges = [AddrRange(i * 0x10000000, size = '256MB')
+                     for i in range(len(runs))]
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+system.mem_ctrls = [cls(range = r, refresh_mode = mode, rfm_raaimt = rfm)
+                    for (r, (mode, rfm)) in zip(system.mem_ranges, runs)]
+
+for mem_ctrl in system.mem_ctrls:
+    # there is no point slowing things down by saving any data
+    mem_ctrl.null = True
+    mem_ctrl.port = system.membus.master
+
+# match the maximum bandwidth of the memory with 64 byte requests, the
+# parameter is in seconds and we need it in ticks (ps)
+burst_size = int((ctrl.devices_per_rank.value *
+                  ctrl.device_bus_width.value *
+                  ctrl.burst_length.value) / 8)
+itt = int(ctrl.tBURST.value * 1000000000000 * 64 / burst_size)
+
+duration = long(Latency(options.duration).value * 1000000000000)
+
+# one traffic generator per controller, each with its own
+# configuration file, staying in a single random state for the
+# entire run
+system.tgen = []
+for (i, r) in enumerate(system.mem_ranges):
+    cfg_file_name = os.path.join(m5.options.outdir, "refresh-%d.cfg" % i)
+    cfg_file = open(cfg_file_name, 'w')
+    cfg_file.write("STATE 0 %d RANDOM %d %d %d 64 %d %d 0\n" %
+                   (duration, options.rd_perc, r.start, r.end, itt, itt))
+    cfg_file.write("INIT 0\n")
+    cfg_file.write("TRANSITION 0 0 1\n")
+    cfg_file.close()
+
+    system.tgen.append(TrafficGen(config_file = cfg_file_name))
+    system.tgen[i].port = system.membus.slave
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+m5.simulate(duration)
+m5.stats.dump()
+
+# pick the controller stats out of the dump we just did
+stats = {}
+for line in open(os.path.join(m5.options.outdir, 'stats.txt')):
+    if line.startswith('---------- End'):
+        break
+    fields = line.split()
+    if len(fields) > 1 and fields[0].startswith('system.mem_ctrls'):
+        stats[fields[0]] = float(fields[1])
+
+def ctrl_stat(i, name):
+    return stats.get('system.mem_ctrls%d.%s' % (i, name), 0)
+
+base_bw = ctrl_stat(0, 'avgRdBW') + ctrl_stat(0, 'avgWrBW')
+
+print "%s refresh modes, %d%% reads:" % (options.mem_type, options.rd_perc)
+print "%-10s %6s %10s %8s %10s %8s" % ("mode", "RAAIMT", "MB/s", "vs all",
+                                       "bank refs", "RFMs")
+for (i, (mode, rfm)) in enumerate(runs):
+    bw = ctrl_stat(i, 'avgRdBW') + ctrl_stat(i, 'avgWrBW')
+    gap = (bw - base_bw) / base_bw * 100 if base_bw else 0
+    print "%-10s %6d %10.2f %+7.2f%% %10d %8d" % \
+        (mode, rfm, bw, gap, ctrl_stat(i, 'bankSetRefreshes'),
+         ctrl_stat(i, 'refreshMgmtCmds'))
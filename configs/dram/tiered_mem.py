@@ -0,0 +1,153 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import MemConfig
+
+# this script drives a two-tier memory, a DRAM in front of an NVM in a
+# flat address space, with random traffic that mostly goes to a hot
+# region initially placed in the slow tier, and shows how the tiered
+# memory moves the hot pages to the fast tier
+
+parser = optparse.OptionParser()
+
+parser.add_option("--fast-mem-type", type="choice", default="DDR4_2400_8x8",
+                  choices=MemConfig.mem_names(),
+                  help = "type of memory of the fast tier")
+
+parser.add_option("--slow-mem-type", type="choice", default="NVM_2400_1x64",
+                  choices=MemConfig.mem_names(),
+                  help = "type of memory of the slow tier")
+
+parser.add_option("--fast-size", type="string", default="256MB",
+                  help = "capacity of the fast tier")
+
+parser.add_option("--slow-size", type="string", default="1GB",
+                  help = "capacity of the slow tier")
+
+parser.add_option("--hot-size", type="string", default="32MB",
+                  help = "size of the hot region, at the start of the "
+                  "slow tier")
+
+parser.add_option("--hot-perc", type="int", default=90,
+                  help = "percentage of the time spent in the hot region")
+
+parser.add_option("--policy", type="choice", default="epoch",
+                  choices=["epoch", "threshold"],
+                  help = "page migration policy")
+
+parser.add_option("--rd_perc", type="int", default=70,
+                  help = "Percentage of read commands")
+
+parser.add_option("--duration", type="string", default="10ms",
+                  help = "simulated time")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print "Error: script doesn't take any positional arguments"
+    sys.exit(1)
+
+# the flat address space, with the fast tier first
+fast_range = AddrRange(0, size = options.fast_size)
+slow_range = AddrRange(fast_range.end + 1, size = options.slow_size)
+hot_size = long(MemorySize(options.hot_size))
+
+if hot_size > slow_range.size():
+    fatal("The hot region does not fit in the slow tier")
+
+system = System(membus = IOXBar(width = 32))
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+system.mem_ranges = [fast_range, slow_range]
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+# the tiered memory fronts a crossbar with one controller per tier
+system.tiered_mem = TieredMemory(fast_range = fast_range,
+                                 slow_range = slow_range,
+                                 policy = options.policy)
+system.tier_xbar = NoncoherentXBar(width = 32, frontend_latency = 0,
+                                   forward_latency = 0,
+                                   response_latency = 0)
+
+system.fast_mem = MemConfig.get(options.fast_mem_type)(range = fast_range)
+system.slow_mem = MemConfig.get(options.slow_mem_type)(range = slow_range)
+
+system.membus.master = system.tiered_mem.slave
+system.tiered_mem.master = system.tier_xbar.slave
+system.tier_xbar.master = system.fast_mem.port
+system.tier_xbar.master = system.slow_mem.port
+
+# alternate between a random state over the hot region and one over
+# the entire address space, staying in each for 1 us
+period = 1000000
+itt = 10000
+
+cfg_file_name = "configs/dram/tiered_mem.cfg"
+cfg_file = open(cfg_file_name, 'w')
+
+cfg_file.write("STATE 0 %d RANDOM %d %d %d 64 %d %d 0\n" %
+               (period, options.rd_perc, slow_range.start,
+                slow_range.start + hot_size - 1, itt, itt))
+cfg_file.write("STATE 1 %d RANDOM %d %d %d 64 %d %d 0\n" %
+               (period, options.rd_perc, fast_range.start,
+                slow_range.end, itt, itt))
+cfg_file.write("INIT 0\n")
+
+hot = options.hot_perc / 100.0
+for state in range(2):
+    cfg_file.write("TRANSITION %d 0 %f\n" % (state, hot))
+    cfg_file.write("TRANSITION %d 1 %f\n" % (state, 1 - hot))
+
+cfg_file.close()
+
+system.tgen = TrafficGen(config_file = cfg_file_name)
+system.tgen.port = system.membus.slave
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+m5.simulate(long(Latency(options.duration).value * 1000000000000))
+
+print "Tiered memory run done at tick %d" % m5.curTick()
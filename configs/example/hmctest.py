@@ -46,6 +46,14 @@ parser.add_option("--num_cross", type = "int", default = 4,
                   help = "1: number of crossbar in HMC=1;\
                   4: number of crossbar = 4")
 
+parser.add_option("--link-flit-size", type = "string", default = "0B",
+                  help = "size of the FLITs on the serial links, 0 for \
+                  no FLITs")
+
+parser.add_option("--link-error-rate", type = "float", default = 0.0,
+                  help = "probability of a FLIT failing the CRC check on \
+                  the serial links")
+
 parser.add_option("--tlm-memory", type = "string",
                   help="use external port for SystemC TLM cosimulation")
 
@@ -40,6 +40,17 @@ def define_options(parser):
                       help="check configs/topologies for complete set")
     parser.add_option("--mesh-rows", type="int", default=0,
                       help="the number of rows in the mesh topology")
+    parser.add_option("--topology-generator", type="choice",
+                      default="torus3d",
+                      choices=['torus3d', 'fat_tree', 'flattened_butterfly',
+                               'dragonfly'],
+                      help="topology built in C++ by --topology=Generated")
+    parser.add_option("--topology-dims", type="string", default="4,4,4",
+                      help="""comma separated shape of the generated
+                            topology. torus3d: x,y,z. fat_tree: k,n
+                            (k-ary n-tree). flattened_butterfly: k0,k1,...
+                            dragonfly: a,h,g (routers per group, global
+                            links per router, groups).""")
     parser.add_option("--network", type="choice", default="simple",
                       choices=['simple', 'garnet2.0'],
                       help="'simple'|'garnet2.0'")
@@ -54,6 +65,9 @@ def define_options(parser):
                             Has to be >= 1.
                             Can be over-ridden on a per link basis
                             in the topology file.""")
+    parser.add_option("--global-link-latency", action="store", type="int",
+                      default=1,
+                      help="latency of the generated dragonfly global links.")
     parser.add_option("--link-width-bits", action="store", type="int",
                       default=128,
                       help="width in bits for all links inside garnet.")
@@ -65,7 +79,11 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: West-first adaptive (for Mesh)
+                            4: Odd-even adaptive (for Mesh)
+                            5: Fully adaptive with XY escape VCs (for Mesh,
+                               needs --vcs-per-vnet >= 2)""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -73,6 +91,57 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--garnet-analytic", action="store_true",
+                      default=False,
+                      help="""start garnet in the analytic latency model.
+                            Use switch_network_mode() to move between the
+                            analytic and detailed models at runtime.""")
+    parser.add_option("--garnet-analytic-window", action="store",
+                      type="int", default=1000,
+                      help="""packets per calibration window of the
+                            analytic garnet model.""")
+    parser.add_option("--garnet-parallel", action="store_true",
+                      default=False,
+                      help="""evaluate the garnet routers of a cycle
+                            together, with per-router random route
+                            choices; the results do not depend on
+                            --garnet-threads, but differ from those without
+                            this option.""")
+    parser.add_option("--garnet-threads", action="store", type="int",
+                      default=1,
+                      help="""host threads evaluating the garnet routers of
+                            a cycle; above 1 implies --garnet-parallel.""")
+    parser.add_option("--route-algorithm", type="choice",
+                      default="all_pairs",
+                      choices=['all_pairs', 'per_destination'],
+                      help="""algorithm used to build the weight-based
+                            routing tables. 'per_destination' runs one
+                            shortest-path search per destination and scales
+                            to large topologies.""")
+    parser.add_option("--route-threads", action="store", type="int",
+                      default=1,
+                      help="""host threads used to build the routing tables
+                            with --route-algorithm=per_destination.""")
+    parser.add_option("--network-trace", action="store", type="string",
+                      default="",
+                      help="""write the messages injected into the garnet
+                            network to this binary trace.""")
+    parser.add_option("--replay-network-trace", action="store",
+                      type="string", default="",
+                      help="""inject this garnet network trace instead of
+                            the protocol traffic (see
+                            configs/example/garnet_trace_replay.py).""")
+    parser.add_option("--replay-window", action="store", type="int",
+                      default=4096,
+                      help="""trace records buffered ahead of the replay
+                            point.""")
+    parser.add_option("--noc-power", action="store_true", default=False,
+                      help="""attach DSENT power models to the garnet
+                            routers and internal links.""")
+    parser.add_option("--noc-power-period", action="store", type="string",
+                      default="1us",
+                      help="""period at which the router and link activity
+                            is turned into power with --noc-power.""")
 
 
 def create_network(options, ruby):
@@ -101,12 +170,26 @@ def create_network(options, ruby):
 
 def init_network(options, network, InterfaceClass):
 
+    network.route_algorithm = options.route_algorithm
+    network.route_threads = options.route_threads
+
     if options.network == "garnet2.0":
         network.num_rows = options.mesh_rows
         network.vcs_per_vnet = options.vcs_per_vnet
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.analytic_mode = options.garnet_analytic
+        network.analytic_window = options.garnet_analytic_window
+        network.parallel_routers = options.garnet_parallel or \
+            options.garnet_threads > 1
+        network.router_threads = options.garnet_threads
+        network.network_trace_file = options.network_trace
+        network.replay_trace_file = options.replay_network_trace
+        network.replay_window = options.replay_window
+
+        if options.noc_power:
+            attach_power_models(options, network)
 
     if options.network == "simple":
         network.setup_buffers()
@@ -120,3 +203,40 @@ def init_network(options, network, InterfaceClass):
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+def attach_power_models(options, network):
+    """Give every garnet router and internal link a DSENT power model.
+
+    The models report to a SubSystem of the network; a ThermalDomain can be
+    set on it to feed temperatures back into the leakage figures.
+    """
+    network.power_subsystem = SubSystem()
+
+    def power_model(cls, **kwargs):
+        # One model per power state: ON, CLK_GATED, SRAM_RETENTION, OFF
+        return PowerModel(pm=[cls(**kwargs),
+                              cls(dynamic=False, **kwargs),
+                              cls(dynamic=False, **kwargs),
+                              cls(dynamic=False, leakage=False, **kwargs)])
+
+    for router in network.routers:
+        router.power_model = power_model(DSENTRouterPowerModel,
+            sample_period=options.noc_power_period)
+        router.default_p_state = "ON"
+
+    for link in network.int_links:
+        link.network_link.power_model = power_model(DSENTLinkPowerModel,
+            sample_period=options.noc_power_period,
+            link_width_bits=options.link_width_bits)
+        link.network_link.default_p_state = "ON"
+
+def switch_network_mode(network, analytic):
+    """Switch a garnet network between its detailed and analytic models.
+
+    The system is drained first so that no message is in flight while the
+    model changes; simulation resumes with the next call to m5.simulate().
+    """
+    if network.isAnalyticMode() == analytic:
+        return
+    m5.drain()
+    network.setAnalyticMode(analytic)
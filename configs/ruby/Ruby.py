@@ -61,6 +61,23 @@ def define_options(parser):
     parser.add_option("--access-backing-store", action="store_true", default=False,
                       help="Should ruby maintain a second copy of memory")
 
+    parser.add_option("--ruby-functional-warmup", action="store_true",
+                      default=False,
+                      help="Restore checkpointed cache contents through the "
+                           "protocol's functional warmup hooks")
+    parser.add_option("--ruby-warmup-trace", action="store", type="string",
+                      default="",
+                      help="Trace of blocks to functionally install in the "
+                           "caches on startup")
+    parser.add_option("--ruby-protocol-trace", action="store",
+                      type="string", default="",
+                      help="Write a binary trace of the SLICC transitions "
+                           "to this file")
+    parser.add_option("--ruby-protocol-trace-machines", action="store",
+                      type="string", default="",
+                      help="Comma separated machine types to trace "
+                           "(default: all)")
+
     # Options related to cache structure
     parser.add_option("--ports", action="store", type="int", default=4,
                       help="used of transitions per cycle which is a proxy \
@@ -76,6 +93,16 @@ def define_options(parser):
     parser.add_option("--recycle-latency", type="int", default=10,
                       help="Recycle latency for ruby controller input buffers")
 
+    # directory options
+    parser.add_option("--dir-page-size", type="string", default="4kB",
+                      help="granularity at which directory entries are "
+                           "allocated")
+    parser.add_option("--sparse-dir-entries", type="int", default=0,
+                      help="capacity of the sparse directory model per "
+                           "directory, 0 to disable")
+    parser.add_option("--sparse-dir-assoc", type="int", default=16,
+                      help="associativity of the sparse directory model")
+
     protocol = buildEnv['PROTOCOL']
     exec "import %s" % protocol
     eval("%s.define_options(parser)" % protocol)
@@ -105,6 +132,9 @@ def setup_memory_controllers(system, ruby, dir_cntrls, options):
     # contiguous address range as of now.
     for dir_cntrl in dir_cntrls:
         dir_cntrl.directory.numa_high_bit = numa_bit
+        dir_cntrl.directory.page_size = options.dir_page_size
+        dir_cntrl.directory.sparse_entries = options.sparse_dir_entries
+        dir_cntrl.directory.sparse_assoc = options.sparse_dir_assoc
 
         crossbar = None
         if len(system.mem_ranges) > 1:
@@ -202,6 +232,13 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
 
+    ruby.functional_warmup = options.ruby_functional_warmup
+    ruby.warmup_trace = options.ruby_warmup_trace
+    ruby.protocol_trace_file = options.ruby_protocol_trace
+    if options.ruby_protocol_trace_machines:
+        ruby.protocol_trace_machines = \
+            options.ruby_protocol_trace_machines.split(',')
+
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
         ruby.access_backing_store = True
@@ -0,0 +1,86 @@
+# Copyright (c) 2010 Advanced Micro Devices, Inc.
+#               2016 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.objects import *
+from m5.util import fatal
+
+from BaseTopology import SimpleTopology
+
+# Creates a 3D torus, fat-tree, flattened butterfly or dragonfly
+# (--topology-generator, shaped by --topology-dims). Only the routers and
+# the links to the controllers are created here; the internal links are
+# generated in C++ by the network (see Topology::generateLinks), so very
+# large networks do not need one Python object per link.
+
+class Generated(SimpleTopology):
+    description='Generated'
+
+    def __init__(self, controllers):
+        self.nodes = controllers
+
+    def makeTopology(self, options, network, IntLink, ExtLink, Router):
+        nodes = self.nodes
+
+        generator = options.topology_generator
+        dims = [int(d) for d in options.topology_dims.split(',')]
+
+        # Routers of the topology, and those the controllers attach to
+        if generator == 'torus3d' or generator == 'flattened_butterfly':
+            num_routers = reduce(lambda x, y: x * y, dims, 1)
+            num_endpoints = num_routers
+        elif generator == 'fat_tree':
+            k, n = dims
+            num_endpoints = k ** (n - 1)
+            num_routers = n * num_endpoints
+        elif generator == 'dragonfly':
+            a, h, g = dims
+            num_routers = a * g
+            num_endpoints = num_routers
+        else:
+            fatal("Unknown topology generator %s" % generator)
+
+        link_latency = options.link_latency # used by simple and garnet
+        router_latency = options.router_latency # only used by garnet
+
+        routers = [Router(router_id=i, latency = router_latency) \
+            for i in range(num_routers)]
+        network.routers = routers
+
+        # Spread the controllers over the endpoint routers
+        ext_links = []
+        for (i, n) in enumerate(nodes):
+            ext_links.append(ExtLink(link_id=i, ext_node=n,
+                                     int_node=routers[i % num_endpoints],
+                                     latency = link_latency))
+        network.ext_links = ext_links
+        network.int_links = []
+
+        network.topology_generator = generator
+        network.generator_dims = dims
+        network.generator_link_latency = link_latency
+        network.generator_global_latency = options.global_link_latency
@@ -289,6 +289,28 @@ namespace DSENT
         return buildModel(config, tech_model);
     }
 
+    Model *initialize(const char *config_file_name,
+                      map<String, String> &config,
+                      const map<String, String> &overrides)
+    {
+        Log::allocate("/tmp/dsent.log");
+
+        LibUtil::readFile(config_file_name, config);
+        for (const auto &it : overrides) {
+            config[it.first] = it.second;
+        }
+
+        TechModel *tech_model = constructTechModel(config);
+        return buildModel(config, tech_model);
+    }
+
+    double query(const String &query_str, Model *ms_model)
+    {
+        const Result* result = (const Result*)processQuery(
+            query_str + "@0", ms_model, false);
+        return result->calculateSum();
+    }
+
     void finalize(map<String, String> &config, Model *ms_model)
     {
         // Delete the model
@@ -59,6 +59,16 @@ namespace DSENT
     Model *initialize(const char *config_file_name,
                       std::map<String, String> &config);
 
+    // Same as above, but entries of the config file are replaced by the
+    // given overrides before the model is built.
+    Model *initialize(const char *config_file_name,
+                      std::map<String, String> &config,
+                      const std::map<String, String> &overrides);
+
+    // Evaluate a single query, e.g. Energy>>Router:WriteBuffer, and
+    // return the sum of its result.
+    double query(const String &query_str, Model *ms_model);
+
     void finalize(std::map<String, String> &config,
                   Model *ms_model);
 
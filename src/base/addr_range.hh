@@ -64,7 +64,9 @@
  * matching value. In addition, to prevent uniformly strided address
  * patterns from a very biased interleaving, we also allow basic
  * XOR-based hashing by specifying an additional set of bits to XOR
- * with before matching.
+ * with before matching. For the hashes of real memory controllers,
+ * every interleaving bit can instead be the parity of an arbitrary
+ * set of address bits, given as a mask per bit.
  *
  * The AddrRange is also able to coalesce a number of interleaved
  * ranges to a contiguous range.
@@ -93,6 +95,11 @@ class AddrRange
     /// with.
     uint8_t intlvMatch;
 
+    /// The masks of the address bits XORed into each interleaving
+    /// bit, from the least significant one up, used instead of the
+    /// slices when not empty
+    std::vector<Addr> masks;
+
   public:
 
     AddrRange()
@@ -129,6 +136,20 @@ class AddrRange
         }
     }
 
+    AddrRange(Addr _start, Addr _end, const std::vector<Addr>& _masks,
+              uint8_t _intlv_match)
+        : _start(_start), _end(_end), intlvHighBit(0), xorHighBit(0),
+          intlvBits(_masks.size()), intlvMatch(_intlv_match), masks(_masks)
+    {
+        // sanity checks
+        fatal_if(intlvBits && intlvMatch >= ULL(1) << intlvBits,
+                 "Match value %d does not fit in %d interleaving bits\n",
+                 intlvMatch, intlvBits);
+
+        for (auto mask : masks)
+            fatal_if(mask == 0, "Interleaving masks must not be empty\n");
+    }
+
     AddrRange(Addr _start, Addr _end)
         : _start(_start), _end(_end), intlvHighBit(0), xorHighBit(0),
           intlvBits(0), intlvMatch(0)
@@ -151,6 +172,7 @@ class AddrRange
             intlvHighBit = ranges.front().intlvHighBit;
             xorHighBit = ranges.front().xorHighBit;
             intlvBits = ranges.front().intlvBits;
+            masks = ranges.front().masks;
 
             if (ranges.size() != (ULL(1) << intlvBits))
                 fatal("Got %d ranges spanning %d interleaving bits\n",
@@ -173,6 +195,7 @@ class AddrRange
             intlvHighBit = 0;
             xorHighBit = 0;
             intlvBits = 0;
+            masks.clear();
         }
     }
 
@@ -186,7 +209,16 @@ class AddrRange
     /**
      * Determine if the range interleaving is hashed or not.
      */
-    bool hashed() const { return interleaved() && xorHighBit != 0; }
+    bool hashed() const
+    {
+        return interleaved() && (xorHighBit != 0 || !masks.empty());
+    }
+
+    /**
+     * Get the masks of the interleaving bits, empty if the
+     * interleaving uses slices of the address.
+     */
+    const std::vector<Addr>& intlvMasks() const { return masks; }
 
     /**
      * Determing the interleaving granularity of the range.
@@ -195,7 +227,14 @@ class AddrRange
      */
     uint64_t granularity() const
     {
-        return ULL(1) << (intlvHighBit - intlvBits + 1);
+        if (masks.empty())
+            return ULL(1) << (intlvHighBit - intlvBits + 1);
+
+        // the lowest address bit in any of the masks
+        Addr all = 0;
+        for (auto mask : masks)
+            all |= mask;
+        return all & -all;
     }
 
     /**
@@ -239,7 +278,15 @@ class AddrRange
     std::string to_string() const
     {
         if (interleaved()) {
-            if (hashed()) {
+            if (!masks.empty()) {
+                // the masks from the most significant bit down, as the
+                // slices are shown
+                std::string str = csprintf("[%#llx : %#llx], [", _start,
+                                           _end);
+                for (int i = masks.size() - 1; i >= 0; i--)
+                    str += csprintf("%#llx%s", masks[i], i ? ", " : "");
+                return str + csprintf("] = %d", intlvMatch);
+            } else if (hashed()) {
                 return csprintf("[%#llx : %#llx], [%d : %d] XOR [%d : %d] = %d",
                                 _start, _end,
                                 intlvHighBit, intlvHighBit - intlvBits + 1,
@@ -269,7 +316,8 @@ class AddrRange
         return r._start == _start && r._end == _end &&
             r.intlvHighBit == intlvHighBit &&
             r.xorHighBit == xorHighBit &&
-            r.intlvBits == intlvBits;
+            r.intlvBits == intlvBits &&
+            r.masks == masks;
     }
 
     /**
@@ -334,7 +382,12 @@ class AddrRange
         if (!interleaved()) {
             return in_range;
         } else if (in_range) {
-            if (!hashed()) {
+            if (!masks.empty()) {
+                uint8_t sel = 0;
+                for (int i = 0; i < masks.size(); i++)
+                    sel |= (popCount(a & masks[i]) & 1) << i;
+                return sel == intlvMatch;
+            } else if (!hashed()) {
                 return bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ==
                     intlvMatch;
             } else {
@@ -376,6 +429,7 @@ class AddrRange
         if (intlvBits != 0) {
             if (intlvHighBit != r.intlvHighBit) return false;
             if (intlvMatch   != r.intlvMatch)   return false;
+            if (masks        != r.masks)        return false;
         }
         return true;
     }
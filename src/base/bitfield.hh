@@ -181,12 +181,16 @@ findLsbSet(uint64_t val) {
     int lsb = 0;
     if (!val)
         return sizeof(val) * 8;
+#if defined(__GNUC__)
+    lsb = __builtin_ctzll(val);
+#else
     if (!bits(val, 31,0)) { lsb += 32; val >>= 32; }
     if (!bits(val, 15,0)) { lsb += 16; val >>= 16; }
     if (!bits(val, 7,0))  { lsb += 8;  val >>= 8;  }
     if (!bits(val, 3,0))  { lsb += 4;  val >>= 4;  }
     if (!bits(val, 1,0))  { lsb += 2;  val >>= 2;  }
     if (!bits(val, 0,0))  { lsb += 1; }
+#endif
     return lsb;
 }
 
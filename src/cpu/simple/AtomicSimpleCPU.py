@@ -62,6 +62,9 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    # backdoors are granted by the memories, through the crossbars and
+    # the caches when these are bypassed (atomic_noncaching mode)
+    backdoor = Param.Bool(False, "Access memory through backdoors")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -99,7 +99,8 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       simulate_inst_stalls(p->simulate_inst_stalls),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem), dcache_access(false), dcache_latency(0),
+      fastmem(p->fastmem), useBackdoors(p->backdoor),
+      dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
     _status = Idle;
@@ -150,10 +151,35 @@ AtomicSimpleCPU::threadSnoop(PacketPtr pkt, ThreadID sender)
     }
 }
 
+Tick
+AtomicSimpleCPU::sendPacket(MasterPort& port, PacketPtr pkt)
+{
+    if (!useBackdoors)
+        return port.sendAtomic(pkt);
+
+    // as with fastmem, accesses through a backdoor take no time
+    if (backdoors.access(pkt))
+        return 0;
+
+    MemBackdoorPtr backdoor = nullptr;
+    Tick latency = port.sendAtomicBackdoor(pkt, backdoor);
+    if (backdoor) {
+        DPRINTF(SimpleCPU, "Granted a backdoor to %s\n",
+                backdoor->range().to_string());
+        backdoors.add(backdoor);
+    }
+    return latency;
+}
+
 void
 AtomicSimpleCPU::drainResume()
 {
     assert(!tickEvent.scheduled());
+
+    // the memory mode may have changed, and with it the backdoors
+    // the memory system grants
+    backdoors.clear();
+
     if (switchedOut())
         return;
 
@@ -378,7 +404,7 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
                 if (fastmem && system->isMemAddr(pkt.getAddr()))
                     system->getPhysMem().access(&pkt);
                 else
-                    dcache_latency += dcachePort.sendAtomic(&pkt);
+                    dcache_latency += sendPacket(dcachePort, &pkt);
             }
             dcache_access = true;
 
@@ -497,7 +523,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                     if (fastmem && system->isMemAddr(pkt.getAddr()))
                         system->getPhysMem().access(&pkt);
                     else
-                        dcache_latency += dcachePort.sendAtomic(&pkt);
+                        dcache_latency += sendPacket(dcachePort, &pkt);
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
@@ -617,7 +643,7 @@ AtomicSimpleCPU::tick()
                     if (fastmem && system->isMemAddr(ifetch_pkt.getAddr()))
                         system->getPhysMem().access(&ifetch_pkt);
                     else
-                        icache_latency = icachePort.sendAtomic(&ifetch_pkt);
+                        icache_latency = sendPacket(icachePort, &ifetch_pkt);
 
                     assert(!ifetch_pkt.isError());
 
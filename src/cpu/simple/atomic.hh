@@ -45,6 +45,7 @@
 
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -168,6 +169,14 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+
+    /**
+     * Do the plain memory accesses through the backdoors granted by
+     * the memories, without sending any packets.
+     */
+    const bool useBackdoors;
+    MemBackdoorSet backdoors;
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
@@ -189,6 +198,14 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     /** Perform snoop for other cpu-local thread contexts. */
     void threadSnoop(PacketPtr pkt, ThreadID sender);
 
+    /**
+     * Send an atomic packet, or do the access through a backdoor if
+     * we have one for it, asking for one otherwise.
+     *
+     * @return Latency of the access
+     */
+    Tick sendPacket(MasterPort& port, PacketPtr pkt);
+
   public:
 
     DrainState drain() override;
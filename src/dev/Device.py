@@ -49,6 +49,9 @@ class DmaDevice(PioDevice):
     cxx_header = "dev/dma_device.hh"
     abstract = True
     dma = MasterPort("DMA port")
+    # in atomic mode, access memory through the backdoors granted by
+    # the memories, see AtomicSimpleCPU
+    backdoor = Param.Bool(False, "Access memory through backdoors")
 
 
 class IsaFake(BasicPioDevice):
@@ -53,10 +53,11 @@
 #include "mem/port_proxy.hh"
 #include "sim/system.hh"
 
-DmaPort::DmaPort(MemObject *dev, System *s)
+DmaPort::DmaPort(MemObject *dev, System *s, bool use_backdoors)
     : MasterPort(dev->name() + ".dma", dev),
       device(dev), sys(s), masterId(s->getMasterId(dev->name())),
-      sendEvent(this), pendingCount(0), inRetry(false)
+      sendEvent(this), pendingCount(0), inRetry(false),
+      useBackdoors(use_backdoors)
 { }
 
 void
@@ -116,7 +117,7 @@ DmaPort::recvTimingResp(PacketPtr pkt)
 }
 
 DmaDevice::DmaDevice(const Params *p)
-    : PioDevice(p), dmaPort(this, sys)
+    : PioDevice(p), dmaPort(this, sys, p->backdoor)
 { }
 
 void
@@ -138,6 +139,14 @@ DmaPort::drain()
     }
 }
 
+void
+DmaPort::drainResume()
+{
+    // the memory mode may have changed, and with it the backdoors
+    // the memory system grants
+    backdoors.clear();
+}
+
 void
 DmaPort::recvReqRetry()
 {
@@ -251,7 +260,15 @@ DmaPort::sendDma()
 
             DPRINTF(DMA, "Sending  DMA for addr: %#x size: %d\n",
                     pkt->req->getPaddr(), pkt->req->getSize());
-            Tick lat = sendAtomic(pkt);
+            Tick lat = 0;
+            if (!useBackdoors) {
+                lat = sendAtomic(pkt);
+            } else if (!backdoors.access(pkt)) {
+                MemBackdoorPtr backdoor = nullptr;
+                lat = sendAtomicBackdoor(pkt, backdoor);
+                if (backdoor)
+                    backdoors.add(backdoor);
+            }
 
             handleResp(pkt, lat);
         }
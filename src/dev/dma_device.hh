@@ -132,6 +132,10 @@ class DmaPort : public MasterPort, public Drainable
      * send whatever it is that it's sending. */
     bool inRetry;
 
+    /** In atomic mode, access memory through the backdoors it grants */
+    const bool useBackdoors;
+    MemBackdoorSet backdoors;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt) override;
@@ -141,7 +145,7 @@ class DmaPort : public MasterPort, public Drainable
 
   public:
 
-    DmaPort(MemObject *dev, System *s);
+    DmaPort(MemObject *dev, System *s, bool use_backdoors = false);
 
     RequestPtr dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                          uint8_t *data, Tick delay, Request::Flags flag = 0);
@@ -149,6 +153,7 @@ class DmaPort : public MasterPort, public Drainable
     bool dmaPending() const { return pendingCount > 0; }
 
     DrainState drain() override;
+    void drainResume() override;
 };
 
 class DmaDevice : public PioDevice
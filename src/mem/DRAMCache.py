@@ -0,0 +1,68 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+
+from m5.params import *
+from m5.proxy import *
+from MemObject import MemObject
+
+# A DRAM cache keeps its tags and data in a stacked DRAM, e.g. HBM, in
+# front of a larger far memory. The cache port connects to the
+# controller of the stacked DRAM, which is not part of the address map
+# itself (in_addr_map = False), and the far port to the memory it
+# caches, whose ranges the cache presents on its slave port.
+#
+# With a single way, the tag and data of a line are read as one access
+# (Alloy cache). With more ways, the tags of a set are read first and
+# the data of the hit way next (Loh-Hill and Unison caches).
+class DRAMCache(MemObject):
+    type = 'DRAMCache'
+    cxx_header = 'mem/dram_cache.hh'
+
+    system = Param.System(Parent.any, "System the cache belongs to")
+
+    slave = SlavePort("Slave port")
+    cache_port = MasterPort("Port to the stacked DRAM")
+    far_port = MasterPort("Port to the far memory")
+
+    cache_range = Param.AddrRange("Address range of the stacked DRAM")
+
+    assoc = Param.Unsigned(1, "Ways per set")
+    line_size = Param.Unsigned(Parent.cache_line_size, "Line size in bytes")
+    # the tags of a set are stored ahead of its data, and a set takes
+    # assoc * (tag_size + line_size) bytes of the stacked DRAM
+    tag_size = Param.MemorySize('8B', "Space taken by the tag of a way")
+
+    # saturating counters indexed by the PC, or by the requestor for
+    # requests without one, start the far memory read of a predicted
+    # miss in parallel with the tag lookup
+    miss_predictor = Param.Bool(True, "Predict misses to hide their lookup")
+    predictor_entries = Param.Unsigned(256, "Entries of the miss predictor")
+
+    max_transactions = Param.Unsigned(32, "Requests handled at once")
+    latency = Param.Latency('2ns', "Controller latency added to responses")
@@ -48,22 +48,33 @@ from m5.params import *
 from AbstractMemory import *
 
 # Enum for memory scheduling algorithms, currently First-Come
-# First-Served and a First-Row Hit then First-Come First-Served
-class MemSched(Enum): vals = ['fcfs', 'frfcfs']
+# First-Served, a First-Row Hit then First-Come First-Served, and the
+# application-aware BLISS, ATLAS, Thread-Cluster Memory scheduling and
+# PAR-BS, which prioritise the requestors (masters) of the packets
+class MemSched(Enum): vals = ['fcfs', 'frfcfs', 'bliss', 'atlas', 'tcm',
+                             'parbs']
 
 # Enum for the address mapping. With Ch, Ra, Ba, Ro and Co denoting
 # channel, rank, bank, row and column, respectively, and going from
 # MSB to LSB.  Available are RoRaBaChCo and RoRaBaCoCh, that are
 # suitable for an open-page policy, optimising for sequential accesses
 # hitting in the open row. For a closed-page policy, RoCoRaBaCh
-# maximises parallelism.
-class AddrMap(Enum): vals = ['RoRaBaChCo', 'RoRaBaCoCh', 'RoCoRaBaCh']
+# maximises parallelism. Custom takes every channel, rank, bank group,
+# bank and row bit from the addr_map_* masks of the controller.
+class AddrMap(Enum): vals = ['RoRaBaChCo', 'RoRaBaCoCh', 'RoCoRaBaCh',
+                             'Custom']
 
 # Enum for the page policy, either open, open_adaptive, close, or
 # close_adaptive.
 class PageManage(Enum): vals = ['open', 'open_adaptive', 'close',
                                 'close_adaptive']
 
+# Refresh granularity. All-bank refresh closes and refreshes every
+# bank of a rank at once, same-bank refresh (DDR5 REFsb) refreshes one
+# bank in every bank group, and per-bank refresh (LPDDR REFpb) a single
+# bank, while the other banks of the rank keep serving requests
+class RefreshMode(Enum): vals = ['all_bank', 'same_bank', 'per_bank']
+
 # DRAMCtrl is a single-channel single-ported DRAM controller model
 # that aims to model the most important system-level performance
 # effects of a DRAM without getting into too much detail of the DRAM
@@ -72,6 +83,12 @@ class DRAMCtrl(AbstractMemory):
     type = 'DRAMCtrl'
     cxx_header = "mem/dram_ctrl.hh"
 
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+      void setStatisticalMode(bool statistical);
+''')
+
     # single-ported on the system interface side, instantiate with a
     # bus in front of the controller for multiple ports
     port = SlavePort("Slave port")
@@ -100,6 +117,54 @@ class DRAMCtrl(AbstractMemory):
     addr_mapping = Param.AddrMap('RoRaBaCoCh', "Address mapping policy")
     page_policy = Param.PageManage('open_adaptive', "Page management policy")
 
+    # with the Custom address mapping, every bit of the rank, bank group,
+    # bank and row is the parity (XOR) of the physical address bits set
+    # in one mask, listed from the least significant bit up, e.g. a bank
+    # bit of 0x21000 is address bit 12 XOR bit 17; with bank groups the
+    # bank masks give the bank within its group; the channel is selected
+    # by the interleaving of the controller address range, which
+    # MemConfig builds from the channel masks when there are any
+    addr_map_channel = VectorParam.Addr([], "Address masks of the channel "
+                                        "bits")
+    addr_map_rank = VectorParam.Addr([], "Address masks of the rank bits")
+    addr_map_bank_group = VectorParam.Addr([], "Address masks of the bank "
+                                           "group bits")
+    addr_map_bank = VectorParam.Addr([], "Address masks of the bank bits")
+    addr_map_row = VectorParam.Addr([], "Address masks of the row bits")
+
+    # application-aware schedulers; BLISS blacklists a requestor that is
+    # served too many bursts in a row until the next clearing
+    bliss_blacklist_threshold = Param.Unsigned(4, "Consecutive bursts of "
+                                               "a requestor before BLISS "
+                                               "blacklists it")
+    bliss_clearing_interval = Param.Latency("10us", "Interval at which "
+                                            "BLISS clears the blacklist")
+
+    # PAR-BS marks a batch of the oldest bursts of every requestor to
+    # every bank, and ranks the requestors shortest job first
+    parbs_marking_cap = Param.Unsigned(5, "Bursts per requestor and bank "
+                                       "marked in a PAR-BS batch")
+
+    # ATLAS ranks the requestors by least attained service every quantum,
+    # and serves packets that have waited too long first
+    atlas_quantum = Param.Latency("1ms", "ATLAS ranking quantum")
+    atlas_history_weight = Param.Float(0.875, "Weight of the previous "
+                                       "quanta in the attained service")
+    atlas_starvation_threshold = Param.Latency("25us", "Time after which "
+                                               "an ATLAS packet is served "
+                                               "first")
+
+    # TCM splits the requestors into a latency-sensitive cluster, which
+    # is always served first, and a bandwidth-sensitive cluster, which
+    # is shuffled
+    tcm_quantum = Param.Latency("250us", "TCM clustering quantum")
+    tcm_cluster_threshold = Param.Float(0.2, "Fraction of the bandwidth "
+                                        "used by the latency-sensitive "
+                                        "cluster")
+    tcm_shuffle_interval = Param.Latency("200ns", "Interval at which the "
+                                         "bandwidth-sensitive cluster "
+                                         "is shuffled")
+
     # enforce a limit on the number of accesses per row
     max_accesses_per_row = Param.Unsigned(16, "Max accesses per row before "
                                           "closing");
@@ -114,6 +179,13 @@ class DRAMCtrl(AbstractMemory):
     static_frontend_latency = Param.Latency("10ns", "Static frontend latency")
     static_backend_latency = Param.Latency("10ns", "Static backend latency")
 
+    # the statistical mode serves timing requests with a latency drawn
+    # from an analytic model of the row hits and the data bus, which is
+    # calibrated on the bursts of the detailed mode and far cheaper to
+    # simulate, e.g. for warming up caches; setStatisticalMode() picks
+    # the mode to use when resuming from the next drain
+    statistical_mode = Param.Bool(False, "Start in the statistical mode")
+
     # the physical organisation of the DRAM
     device_bus_width = Param.Unsigned("data bus width in bits for each DRAM "\
                                       "device/chip")
@@ -190,6 +262,18 @@ class DRAMCtrl(AbstractMemory):
     # to be sent. It is 7.8 us for a 64ms refresh requirement
     tREFI = Param.Latency("Refresh command interval")
 
+    # with same-bank or per-bank refresh, every set of banks is
+    # refreshed once per tREFI, taking tRFCsb; a rank in a low-power
+    # state still uses an all-bank refresh
+    refresh_mode = Param.RefreshMode('all_bank', "Refresh granularity")
+    tRFCsb = Param.Latency("0ns", "Same-bank or per-bank refresh cycle time")
+
+    # refresh management (RFM), once a bank has accumulated this many
+    # activates (RAAIMT), each refresh paying back as many, it is kept
+    # closed for tRFM after its next precharge; 0 disables RFM
+    rfm_raaimt = Param.Unsigned(0, "Activates that trigger an RFM")
+    tRFM = Param.Latency("0ns", "Refresh management command time")
+
     # write-to-read, same rank turnaround penalty
     tWTR = Param.Latency("Write to read, same rank switching time")
 
@@ -699,6 +783,127 @@ class DDR4_2400_4x16(DDR4_2400_16x4):
     IDD5 = '280mA'
     IDD3P1 = '41mA'
 
+# A single DDR5-4400 x32 sub-channel (one command and address bus),
+# with timings based on the JEDEC DDR5-4400B speed bin for a 16 Gbit
+# x8 device. A DDR5 DIMM has two independent sub-channels, and
+# MemConfig creates _subchannels controllers per memory channel.
+# Total sub-channel capacity is 16GB
+# 4 devices/rank * 2 ranks/channel * 2GB/device = 16GB/sub-channel
+class DDR5_4400_4x8(DRAMCtrl):
+    # Number of DRAMCtrl instances per DIMM channel
+    _subchannels = 2
+
+    # size of device
+    device_size = '2GB'
+
+    # 4x8 configuration, 4 devices each with an 8-bit interface
+    device_bus_width = 8
+
+    # DDR5 is a BL16 device, giving 64 bytes on a 32-bit sub-channel
+    burst_length = 16
+
+    # Each device has a page (row buffer) size of 1 Kbyte (1K columns x8)
+    device_rowbuffer_size = '1kB'
+
+    # 4x8 configuration, so 4 devices
+    devices_per_rank = 4
+
+    ranks_per_channel = 2
+
+    # 16 Gbit DDR5 has 8 bank groups with 4 banks each (x4 and x8)
+    bank_groups_per_rank = 8
+    banks_per_rank = 32
+
+    # override the default buffer sizes and go for something larger to
+    # accommodate the larger bank count
+    write_buffer_size = 128
+    read_buffer_size = 64
+
+    # 2200 MHz
+    tCK = '0.454ns'
+
+    # 16 beats across an x32 interface translates to 8 clocks @ 2200 MHz
+    # With bank group architectures, tBURST represents the CAS-to-CAS
+    # delay for bursts to different bank groups (tCCD_S)
+    tBURST = '3.636ns'
+
+    # CAS-to-CAS delay for bursts to the same bank group is
+    # MAX(8 CK, 5ns)
+    tCCD_L = '5ns'
+
+    # DDR5-4400B 36-36-36
+    tRCD = '16.364ns'
+    tCL = '16.364ns'
+    tRP = '16.364ns'
+    tRAS = '32ns'
+
+    # RRD_S (different bank group) is 8 CK
+    tRRD = '3.636ns'
+
+    # RRD_L (same bank group) is MAX(8 CK, 5ns)
+    tRRD_L = '5ns'
+
+    # tFAW for 1K page is MAX(32 CK, 13.333ns)
+    tXAW = '14.545ns'
+    activation_limit = 4
+
+    # 16 Gbit, normal refresh mode (tRFC1), with the same-bank refresh
+    # of one bank in each bank group taking tRFCsb
+    tRFC = '295ns'
+    tREFI = '3.9us'
+    refresh_mode = 'same_bank'
+    tRFCsb = '130ns'
+
+    # refresh management is only needed on parts that require it, set
+    # rfm_raaimt to enable it, an RFM to the bank takes tRFCsb
+    tRFM = '130ns'
+
+    tWR = '30ns'
+
+    # Here using the average of WTR_S (2.5ns) and WTR_L (10ns)
+    tWTR = '6.25ns'
+
+    # Greater of 12 CK or 7.5 ns
+    tRTP = '7.5ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK, @2200 MHz = 0.909 ns
+    tRTW = '0.909ns'
+
+    # Default different rank bus delay to 2 CK, @2200 MHz = 0.909 ns
+    tCS = '0.909ns'
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '7.5ns'
+
+    # self refresh exit time
+    # tRFC + 10ns = 305ns
+    tXS = '305ns'
+
+    # The DRAMPower model has no notion of the DDR5 same-bank refresh
+    # and sub-channels, so no currents are given
+
+# A single DDR5-4400 x32 sub-channel with 16 Gbit x4 devices.
+# Total sub-channel capacity is 32GB
+# 8 devices/rank * 2 ranks/channel * 2GB/device = 32GB/sub-channel
+class DDR5_4400_8x4(DDR5_4400_4x8):
+    # 8x4 configuration, 8 devices each with a 4-bit interface
+    device_bus_width = 4
+    devices_per_rank = 8
+
+    # Each device has a page (row buffer) size of 1 Kbyte (2K columns x4)
+    device_rowbuffer_size = '1kB'
+
+# The x4 DDR5 sub-channel in the optional BL32 mode, where a single
+# burst moves 128 bytes
+class DDR5_4400_8x4_BL32(DDR5_4400_8x4):
+    burst_length = 32
+
+    # 32 beats across an x32 interface translates to 16 clocks @ 2200 MHz
+    tBURST = '7.272ns'
+
+    # BL32 plus the same bank group penalty of BL16
+    tCCD_L = '8.636ns'
+
 # A single LPDDR2-S4 x32 interface (one command/address bus), with
 # default timings based on a LPDDR2-1066 4 Gbit part (Micron MT42L128M32D1)
 # in a 1x32 configuration.
@@ -967,6 +1172,89 @@ class LPDDR3_1600_1x32(DRAMCtrl):
     VDD = '1.8V'
     VDD2 = '1.2V'
 
+# A single LPDDR5 x16 interface (one command/address bus), with
+# default timings based on the JEDEC LPDDR5-6400 timings of an 8 Gbit
+# part in the 16 bank, bank group mode with BL32.
+class LPDDR5_6400_1x16_BG_BL32(DRAMCtrl):
+    # No DLL for LPDDR5
+    dll = False
+
+    # size of device
+    device_size = '1GB'
+
+    # 1x16 configuration, 1 device with a 16-bit interface
+    device_bus_width = 16
+
+    # BL32 gives 64 bytes on a 16-bit interface
+    burst_length = 32
+
+    # Each device has a page (row buffer) size of 2KB
+    device_rowbuffer_size = '2kB'
+
+    # 1x16 configuration, so 1 device
+    devices_per_rank = 1
+
+    ranks_per_channel = 1
+
+    # bank group mode, 4 bank groups with 4 banks each
+    bank_groups_per_rank = 4
+    banks_per_rank = 16
+
+    # 800 MHz CK, with a 3200 MHz WCK for the data
+    tCK = '1.25ns'
+
+    # 32 beats at 6400 MT/s
+    tBURST = '5ns'
+
+    # CAS-to-CAS delay for BL32 bursts to the same bank group, 8 CK
+    tCCD_L = '10ns'
+
+    tRCD = '18ns'
+
+    # 17 CK read latency @ 800 MHz
+    tCL = '21.25ns'
+
+    tRAS = '42ns'
+    tWR = '34ns'
+
+    # Greater of 4 CK or 7.5 ns
+    tRTP = '7.5ns'
+
+    # Pre-charge one bank 18 ns (all banks 21 ns)
+    tRP = '18ns'
+
+    # 8 Gbit, all-bank refresh 210ns, the per-bank refresh used while
+    # the device is active 120ns
+    tRFC = '210ns'
+    tREFI = '3.9us'
+    refresh_mode = 'per_bank'
+    tRFCsb = '120ns'
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '7ns'
+
+    # self refresh exit time, tRFC + 7.5ns
+    tXS = '217.5ns'
+
+    # Here using the average of WTR_S (6.25ns) and WTR_L (12ns)
+    tWTR = '9.125ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK, @800 MHz = 2.5 ns
+    tRTW = '2.5ns'
+
+    # Default different rank bus delay to 2 CK, @800 MHz = 2.5 ns
+    tCS = '2.5ns'
+
+    # Activate to activate is 5ns irrespective of the bank group
+    tRRD = '5ns'
+    tRRD_L = '5ns'
+
+    tXAW = '20ns'
+    activation_limit = 4
+
+    # The DRAMPower model does not capture the LPDDR5 per-bank refresh
+    # and WCK clocking, so no currents are given
+
 # A single GDDR5 x64 interface, with
 # default timings based on a GDDR5-4000 1 Gbit part (SK Hynix
 # H5GQ1H24AFR) in a 2x32 configuration.
@@ -1183,3 +1471,184 @@ class HBM_1000_4H_1x64(HBM_1000_4H_1x128):
 
     # self refresh exit time
     tXS = '65ns'
+
+# A single HBM2 x64 pseudo-channel at 2Gbps, with timings based on the
+# HBM2 JEDEC spec (JESD235B) where publically available and otherwise
+# inherited from the HBM gen1 classes.
+# An 8H stack of 8Gb dies is defined, 8GB of memory in total.
+# Note: As for HBM_1000_4H_1x64, a unique controller is instantiated
+# per pseudo-channel, and the command bus shared by the two
+# pseudo-channels of a channel is not modelled.
+class HBM2_2000_8H_1x64(HBM_1000_4H_1x64):
+    # 8 channels of 2 pseudo-channels, with the capacity set to
+    # (full_stack_capacity / 16)
+    # To use all 16 pseudo channels, set 'channels' parameter to 16 in
+    # system configuration
+    device_size = '512MB'
+
+    # 8Gb dies have 16 banks per pseudo-channel in 4 bank groups
+    banks_per_rank = 16
+    bank_groups_per_rank = 4
+
+    # 1000 MHz for 2Gbps DDR data rate
+    tCK = '1ns'
+
+    # BL4 at DDR @ 1000 MHz means 4 * 1ns / 2 = 2ns
+    tBURST = '2ns'
+
+    # 4 CK for CAS to CAS within a bank group
+    tCCD_L = '4ns'
+
+    tRCD = '14ns'
+    tCL = '14ns'
+    tRP = '14ns'
+    tRAS = '33ns'
+
+    tRRD = '4ns'
+    tRRD_L = '6ns'
+    tXAW = '16ns'
+    activation_limit = 4
+
+    # value for 8Gb device from JEDEC spec
+    tRFC = '350ns'
+
+    tWR = '15ns'
+    tRTP = '5ns'
+    tWTR = '7.5ns'
+    tRTW = '2ns'
+
+    # single rank per pseudo-channel
+    tCS = '0ns'
+
+    tXP = '8ns'
+    tXS = '360ns'
+
+# A single HBM3 x32 pseudo-channel at 6.4Gbps, with timings based on
+# the HBM3 JEDEC spec (JESD238) where publically available.
+# HBM3 has 16 independent 64-bit channels per stack, each split into
+# two 32-bit pseudo-channels, and always operates in pseudo-channel
+# mode. An 8H stack of 16Gb dies is defined, 16GB of memory in total.
+# Note: A unique controller is instantiated per pseudo-channel, and
+# the command bus shared by the two pseudo-channels of a channel is
+# not modelled.
+class HBM3_6400_8H_1x32(HBM2_2000_8H_1x64):
+    # 16 channels of 2 pseudo-channels, with the capacity set to
+    # (full_stack_capacity / 32)
+    # To use all 32 pseudo channels, set 'channels' parameter to 32 in
+    # system configuration
+    device_size = '512MB'
+
+    # 32-bit pseudo-channel interface
+    device_bus_width = 32
+
+    # HBM3 pseudo-channels use BL8, 32 bytes per burst
+    burst_length = 8
+
+    device_rowbuffer_size = '1kB'
+
+    banks_per_rank = 16
+    bank_groups_per_rank = 4
+
+    # 1600 MHz command clock, with 4 data beats per clock for 6.4Gbps
+    tCK = '0.625ns'
+
+    # BL8 at 4 beats per clock means 8 * 0.625ns / 4 = 1.25ns
+    tBURST = '1.25ns'
+
+    # 4 CK for CAS to CAS within a bank group
+    tCCD_L = '2.5ns'
+
+    tRCD = '14ns'
+    tCL = '14ns'
+    tRP = '14ns'
+    tRAS = '33ns'
+
+    tRRD = '2.5ns'
+    tRRD_L = '3.75ns'
+    tXAW = '15ns'
+    activation_limit = 4
+
+    # value for 16Gb device from JEDEC spec
+    tRFC = '350ns'
+
+    tWR = '15ns'
+    tRTP = '3.75ns'
+    tWTR = '5ns'
+    tRTW = '1.25ns'
+
+    tXP = '7.5ns'
+    tXS = '360ns'
+
+# A single x64 channel of non-volatile memory behind a DDR4-2400
+# interface, approximating a 3D XPoint class part, e.g. as the slow
+# tier of a TieredMemory. Reading the array into the small internal
+# buffer takes hundreds of ns and writing it back around half a
+# microsecond, while the interface timings are those of DDR4-2400.
+# Total channel capacity is 64GB
+# 8 devices/rank * 1 rank/channel * 8GB/device = 64GB/channel
+class NVM_2400_1x64(DRAMCtrl):
+    # size of device
+    device_size = '8GB'
+
+    # 8x8 configuration, 8 devices each with an 8-bit interface
+    device_bus_width = 8
+
+    # BL8 DDR4 interface
+    burst_length = 8
+
+    # Small internal buffer of 256 bytes per device
+    device_rowbuffer_size = '256B'
+
+    # 8x8 configuration, so 8 devices
+    devices_per_rank = 8
+
+    ranks_per_channel = 1
+
+    banks_per_rank = 16
+
+    # the buffers are small, and rarely hit twice
+    page_policy = 'close_adaptive'
+
+    # 1200 MHz
+    tCK = '0.833ns'
+
+    # 8 beats across an x64 interface translates to 4 clocks @ 1200 MHz
+    tBURST = '3.332ns'
+
+    # reading the array into the buffer
+    tRCD = '150ns'
+    tCL = '14.16ns'
+    tRAS = '150ns'
+
+    # the buffer is not restored, so closing it is quick, but writes
+    # have to reach the array first
+    tRP = '2ns'
+    tWR = '500ns'
+
+    # Greater of 4 CK or 7.5 ns
+    tRTP = '7.5ns'
+
+    tRRD = '3.332ns'
+    tXAW = '13.328ns'
+    activation_limit = 4
+
+    # non-volatile, so refresh is as good as disabled
+    tRFC = '5ns'
+    tREFI = '1s'
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '6ns'
+
+    # self refresh exit time
+    tXS = '15ns'
+
+    tWTR = '5ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK, @1200 MHz = 1.666 ns
+    tRTW = '1.666ns'
+
+    # Default different rank bus delay to 2 CK, @1200 MHz = 1.666 ns
+    tCS = '1.666ns'
+
+    # DRAMPower does not model non-volatile memories, so no currents
+    # are given
@@ -63,3 +63,18 @@ class SerialLink(MemObject):
         "link. (aka. lane width)")
     link_speed = Param.UInt64(1, "Gb/s Speed of each parallel lane inside the"
         "serial link. (aka. lane speed)")
+
+    # With a non-zero FLIT size, the link is packetized as in HMC: a
+    # packet is sent as whole FLITs, with one FLIT for its header and
+    # tail, and the payload only for the packets that carry data, e.g.
+    # a read request is a single FLIT. Otherwise every packet is
+    # serialized as its size in bytes.
+    flit_size = Param.MemorySize('0B', "Size of the link FLITs, 0 if the "
+        "link is not packetized")
+
+    # Every FLIT is protected by the CRC of its packet, and a packet
+    # failing the check at the receiver is sent again after a link-level
+    # retry, which also holds up the packets behind it
+    flit_error_rate = Param.Float(0.0, "Probability of a FLIT being "
+        "corrupted on the link")
+    retry_latency = Param.Latency('0ns', "Latency of a link-level retry")
@@ -0,0 +1,69 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+from m5.params import *
+from m5.proxy import *
+from AddrMapper import AddrMapper
+
+# Migration policies of the tiered memory. With 'epoch', the hottest
+# pages of the slow tier are selected at the end of every epoch, and
+# with 'threshold' a slow page is migrated as soon as its accesses in
+# the current epoch reach the hot threshold.
+class TierPolicy(Enum): vals = ['epoch', 'threshold']
+
+# A tiered memory presents a flat address space made of a fast (DRAM)
+# and a slow (e.g. NVM) tier. The master port connects to a crossbar
+# with one controller per tier, each responding to the range of its
+# tier. Hot pages of the slow tier are swapped with cold pages of the
+# fast tier, and the pages are copied with timing requests through the
+# master port, competing with the demand traffic for bandwidth.
+class TieredMemory(AddrMapper):
+    type = 'TieredMemory'
+    cxx_header = 'mem/tiered_memory.hh'
+
+    system = Param.System(Parent.any, "System the memory belongs to")
+
+    fast_range = Param.AddrRange("Address range of the fast tier")
+    slow_range = Param.AddrRange("Address range of the slow tier")
+
+    page_size = Param.MemorySize('4kB', "Migration granularity")
+
+    policy = Param.TierPolicy('epoch', "Migration policy")
+    epoch = Param.Latency('100us', "Access tracking epoch")
+    # the access counts are halved at the end of every epoch
+    hot_threshold = Param.Unsigned(8, "Access count of a hot page")
+    migrations_per_epoch = Param.Unsigned(16, "Maximum page migrations "
+                                          "started per epoch")
+
+    # the copy is done in blocks, with a limited number in flight,
+    # which bounds the bandwidth a migration takes from the demand
+    # traffic; the fixed latency covers the remapping, e.g. the TLB
+    # shootdown, before the pages are accessible again
+    migration_block = Param.MemorySize('64B', "Size of the copy requests")
+    migration_reqs = Param.Unsigned(8, "Copy requests in flight")
+    migration_latency = Param.Latency('2us', "Remapping cost of a migration")
@@ -85,6 +85,20 @@ class BaseXBar(MemObject):
     use_default_range = Param.Bool(False, "Perform address mapping for " \
                                        "the default port")
 
+    # A layer is normally released by the next packet once its
+    # occupancy is over, and only schedules a release event when a
+    # port waits for it. Releasing it with an event after every packet
+    # gives the same timing at a higher cost, and is kept to check
+    # exactly that.
+    lazy_release = Param.Bool(True, "Release the layers on the next " \
+                                  "packet rather than with an event")
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+      void setLazyRelease(bool lazy);
+''')
+
 class NoncoherentXBar(BaseXBar):
     type = 'NoncoherentXBar'
     cxx_header = "mem/noncoherent_xbar.hh"
@@ -58,7 +58,7 @@ using namespace std;
 AbstractMemory::AbstractMemory(const Params *p) :
     MemObject(p), range(params()->range), pmemAddr(NULL),
     confTableReported(p->conf_table_reported), inAddrMap(p->in_addr_map),
-    kvmMap(p->kvm_map), _system(NULL)
+    kvmMap(p->kvm_map), backdoor(params()->range, NULL), _system(NULL)
 {
 }
 
@@ -74,6 +74,10 @@ AbstractMemory::init()
 void
 AbstractMemory::setBackingStore(uint8_t* pmem_addr)
 {
+    // the holders of the backdoor have to ask for the new one
+    backdoor.invalidate();
+    backdoor.ptr(pmem_addr);
+
     pmemAddr = pmem_addr;
 }
 
@@ -215,9 +219,11 @@ AbstractMemory::trackLoadLocked(PacketPtr pkt)
         }
     }
 
-    // no record for this xc: need to allocate a new one
+    // no record for this xc: need to allocate a new one, and stop
+    // the accesses through the backdoor as they would not clear it
     DPRINTF(LLSC, "Adding lock record: context %d addr %#x\n",
             req->contextId(), paddr);
+    backdoor.invalidate();
     lockedAddrList.push_front(LockedAddr(req));
 }
 
@@ -49,6 +49,7 @@
 #ifndef __ABSTRACT_MEMORY_HH__
 #define __ABSTRACT_MEMORY_HH__
 
+#include "mem/backdoor.hh"
 #include "mem/mem_object.hh"
 #include "params/AbstractMemory.hh"
 #include "sim/stats.hh"
@@ -121,6 +122,9 @@ class AbstractMemory : public MemObject
 
     std::list<LockedAddr> lockedAddrList;
 
+    // Backdoor to the backing store, granted to atomic requests
+    MemBackdoor backdoor;
+
     // helper function for checkLockedAddrs(): we really want to
     // inline a quick check for an empty locked addr list (hopefully
     // the common case), and do the full list search (if necessary) in
@@ -227,7 +231,24 @@ class AbstractMemory : public MemObject
     /**
      * Add a locked address to allow for checkpointing.
      */
-    void addLockedAddr(LockedAddr addr) { lockedAddrList.push_back(addr); }
+    void addLockedAddr(LockedAddr addr)
+    {
+        backdoor.invalidate();
+        lockedAddrList.push_back(addr);
+    }
+
+    /**
+     * Grant a backdoor to the backing store. None is granted while
+     * load-locked addresses are tracked, as the accesses through a
+     * backdoor would not clear them.
+     *
+     * @param bd Set to the backdoor if one is granted
+     */
+    void getBackdoor(MemBackdoorPtr& bd)
+    {
+        if (pmemAddr && lockedAddrList.empty())
+            bd = &backdoor;
+    }
 
     /** read the system pointer
      * Implemented for completeness with the setter
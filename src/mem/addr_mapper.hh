@@ -207,7 +207,7 @@ class AddrMapper : public MemObject
     /** Instance of slave port, i.e. on the CPU side */
     MapperSlavePort slavePort;
 
-    void recvFunctional(PacketPtr pkt);
+    virtual void recvFunctional(PacketPtr pkt);
 
     void recvFunctionalSnoop(PacketPtr pkt);
 
@@ -215,9 +215,9 @@ class AddrMapper : public MemObject
 
     Tick recvAtomicSnoop(PacketPtr pkt);
 
-    bool recvTimingReq(PacketPtr pkt);
+    virtual bool recvTimingReq(PacketPtr pkt);
 
-    bool recvTimingResp(PacketPtr pkt);
+    virtual bool recvTimingResp(PacketPtr pkt);
 
     void recvTimingSnoopReq(PacketPtr pkt);
 
@@ -227,7 +227,7 @@ class AddrMapper : public MemObject
 
     bool isSnooping() const;
 
-    void recvReqRetry();
+    virtual void recvReqRetry();
 
     void recvRespRetry();
 
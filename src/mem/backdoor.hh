@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * MemBackdoor declaration
+ */
+
+#ifndef __MEM_BACKDOOR_HH__
+#define __MEM_BACKDOOR_HH__
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "mem/packet.hh"
+
+/**
+ * A backdoor is a grant, from a memory, to access the host memory
+ * backing an address range directly, without sending any packets.
+ * Backdoors are handed out to atomic requests by the memories, and
+ * passed on by the crossbars and caches that do not need to see the
+ * accesses. A memory invalidates its backdoor when the accesses would
+ * no longer be correct, e.g. when the backing store is replaced, and
+ * the holders of the backdoor are told through their callbacks.
+ */
+class MemBackdoor
+{
+
+  public:
+
+    typedef std::function<void(const MemBackdoor&)> InvalidationCallback;
+
+    /** Handle to a registered callback, used to remove it again */
+    typedef uint64_t CallbackId;
+
+    MemBackdoor(const AddrRange& range, uint8_t* ptr)
+        : _range(range), _ptr(ptr), nextCallbackId(0)
+    { }
+
+    /** Address range covered by the backdoor */
+    const AddrRange& range() const { return _range; }
+
+    /** Host address of the start of the range */
+    uint8_t* ptr() const { return _ptr; }
+    void ptr(uint8_t* ptr) { _ptr = ptr; }
+
+    /**
+     * Does the backdoor cover a block of memory. An interleaved range
+     * only covers the blocks that do not cross an interleaving
+     * boundary.
+     */
+    bool
+    covers(Addr addr, unsigned size) const
+    {
+        return _range.contains(addr) && _range.contains(addr + size - 1);
+    }
+
+    /** Host address of a simulated address in the range */
+    uint8_t* hostAddr(Addr addr) const { return _ptr + addr - _range.start(); }
+
+    /**
+     * Ask to be told when the backdoor is no longer valid. A callback
+     * is called at most once, and is removed when called.
+     *
+     * @param cb Callback to call on invalidation
+     * @return Handle to remove the callback before it is called
+     */
+    CallbackId
+    addInvalidationCallback(InvalidationCallback cb)
+    {
+        callbacks.emplace_back(nextCallbackId, cb);
+        return nextCallbackId++;
+    }
+
+    /**
+     * Stop being told about the invalidation, e.g. when the holder
+     * forgets the backdoor. Removing a callback that has already been
+     * called has no effect.
+     */
+    void
+    removeInvalidationCallback(CallbackId id)
+    {
+        callbacks.remove_if(
+            [id](const std::pair<CallbackId, InvalidationCallback>& cb) {
+                return cb.first == id;
+            });
+    }
+
+    /**
+     * Tell the holders that the backdoor is no longer valid, after
+     * which they have to ask for it again.
+     */
+    void
+    invalidate()
+    {
+        std::list<std::pair<CallbackId, InvalidationCallback>> cbs;
+        cbs.swap(callbacks);
+        for (auto& cb : cbs)
+            cb.second(*this);
+    }
+
+  private:
+
+    const AddrRange _range;
+    uint8_t* _ptr;
+
+    std::list<std::pair<CallbackId, InvalidationCallback>> callbacks;
+    CallbackId nextCallbackId;
+
+};
+
+typedef MemBackdoor* MemBackdoorPtr;
+
+/**
+ * The backdoors held by a requestor, e.g. a CPU or DMA port, which
+ * are forgotten as soon as they are invalidated.
+ */
+class MemBackdoorSet
+{
+
+  public:
+
+    MemBackdoorSet() { }
+
+    /**
+     * The callbacks refer to the set, so remove them before the set
+     * goes, as the memories usually outlive the requestors.
+     */
+    ~MemBackdoorSet() { clear(); }
+
+    // The callbacks refer to this set, so a copy would not be told
+    MemBackdoorSet(const MemBackdoorSet&) = delete;
+    MemBackdoorSet& operator=(const MemBackdoorSet&) = delete;
+
+    /** Remember a backdoor, and forget it once invalidated */
+    void
+    add(MemBackdoorPtr backdoor)
+    {
+        if (find(backdoor) != backdoors.end())
+            return;
+
+        auto id = backdoor->addInvalidationCallback(
+            [this](const MemBackdoor& bd) {
+                auto it = find(&bd);
+                if (it != backdoors.end())
+                    backdoors.erase(it);
+            });
+        backdoors.emplace_back(backdoor, id);
+    }
+
+    /**
+     * Forget all the backdoors, e.g. when the memory mode may have
+     * changed and they might no longer be allowed. The callbacks are
+     * removed as well, so that they do not pile up on backdoors that
+     * are added again later.
+     */
+    void
+    clear()
+    {
+        for (auto& entry : backdoors)
+            entry.first->removeInvalidationCallback(entry.second);
+        backdoors.clear();
+    }
+
+    /**
+     * Do a plain read or write through one of the backdoors, turning
+     * the packet into a response as the memory would.
+     *
+     * @param pkt Packet performing the access
+     * @return true if a backdoor did the access
+     */
+    bool
+    access(PacketPtr pkt) const
+    {
+        // anything else has side effects on the memory or the memory
+        // system, such as locked addresses
+        if ((pkt->cmd != MemCmd::ReadReq && pkt->cmd != MemCmd::WriteReq) ||
+            pkt->req->isLockedRMW())
+            return false;
+
+        for (auto& entry : backdoors) {
+            MemBackdoorPtr backdoor = entry.first;
+            if (backdoor->covers(pkt->getAddr(), pkt->getSize())) {
+                uint8_t* host_addr = backdoor->hostAddr(pkt->getAddr());
+                if (pkt->isRead())
+                    pkt->setData(host_addr);
+                else
+                    pkt->writeData(host_addr);
+
+                if (pkt->needsResponse())
+                    pkt->makeResponse();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+  private:
+
+    typedef std::vector<std::pair<MemBackdoorPtr, MemBackdoor::CallbackId>>
+        BackdoorList;
+
+    BackdoorList::iterator
+    find(const MemBackdoor* backdoor)
+    {
+        return std::find_if(backdoors.begin(), backdoors.end(),
+                            [backdoor](const BackdoorList::value_type& e) {
+                                return e.first == backdoor;
+                            });
+    }
+
+    /** The backdoors, with the handles of their callbacks */
+    BackdoorList backdoors;
+
+};
+
+#endif //__MEM_BACKDOOR_HH__
@@ -2568,6 +2568,17 @@ Cache::CpuSidePort::recvAtomic(PacketPtr pkt)
     return cache->recvAtomic(pkt);
 }
 
+Tick
+Cache::CpuSidePort::recvAtomicBackdoor(PacketPtr pkt,
+                                       MemBackdoorPtr& backdoor)
+{
+    // a bypassed cache holds no data, and can pass on a backdoor
+    if (cache->system->bypassCaches())
+        return cache->memSidePort->sendAtomicBackdoor(pkt, backdoor);
+
+    return cache->recvAtomic(pkt);
+}
+
 void
 Cache::CpuSidePort::recvFunctional(PacketPtr pkt)
 {
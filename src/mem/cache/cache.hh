@@ -94,6 +94,9 @@ class Cache : public BaseCache
 
         virtual Tick recvAtomic(PacketPtr pkt);
 
+        virtual Tick recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr& backdoor);
+
         virtual void recvFunctional(PacketPtr pkt);
 
         virtual AddrRangeList getAddrRanges() const;
@@ -182,6 +182,13 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     // determine how long to be crossbar layer is busy
     Tick packetFinishTime = clockEdge(Cycles(1)) + pkt->payloadDelay;
 
+    // remember where to route the response to, before snooping, so
+    // that a cache responding with a copy of the packet also carries
+    // the route
+    const bool push_route = !is_express_snoop && pkt->needsResponse();
+    if (push_route)
+        pushRoute(pkt, slave_port_id);
+
     if (!system->bypassCaches()) {
         assert(pkt->snoopDelay == 0);
 
@@ -227,6 +234,11 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     const bool expect_snoop_resp = !cache_responding && pkt->cacheResponding();
     bool expect_response = pkt->needsResponse() && !pkt->cacheResponding();
 
+    // if a cache is responding, the route travels with its copy of
+    // the packet, and is not passed on with the request
+    if (push_route && expect_snoop_resp)
+        pkt->popSenderState();
+
     const bool sink_packet = sinkPacket(pkt);
 
     // in certain cases the crossbar is responsible for responding
@@ -276,6 +288,10 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         // restore the header delay
         pkt->headerDelay = old_header_delay;
 
+        // the request will be presented again
+        if (push_route && !expect_snoop_resp)
+            popRoute(pkt);
+
         DPRINTF(CoherentXBar, "%s: src %s packet %s RETRY\n", __func__,
                 src_port->name(), pkt->print());
 
@@ -285,28 +301,6 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     } else {
         // express snoops currently bypass the crossbar state entirely
         if (!is_express_snoop) {
-            // if this particular request will generate a snoop
-            // response
-            if (expect_snoop_resp) {
-                // we should never have an exsiting request outstanding
-                assert(outstandingSnoop.find(pkt->req) ==
-                       outstandingSnoop.end());
-                outstandingSnoop.insert(pkt->req);
-
-                // basic sanity check on the outstanding snoops
-                panic_if(outstandingSnoop.size() > 512,
-                         "Outstanding snoop requests exceeded 512\n");
-            }
-
-            // remember where to route the normal response to
-            if (expect_response || expect_snoop_resp) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = slave_port_id;
-
-                panic_if(routeTo.size() > 512,
-                         "Routing table exceeds 512 packets\n");
-            }
-
             // update the layer state and schedule an idle event
             reqLayers[master_port_id]->succeededTiming(packetFinishTime);
         }
@@ -330,6 +324,9 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         assert(pkt->needsResponse());
         assert(success);
 
+        // the response does not go through the routing
+        popRoute(pkt);
+
         pkt->makeResponse();
 
         if (snoopFilter && !system->bypassCaches()) {
@@ -353,9 +350,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     MasterPort *src_port = masterPorts[master_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID slave_port_id = route_lookup->second;
+    const PortID slave_port_id = getRoute(pkt).port;
     assert(slave_port_id != InvalidPortID);
     assert(slave_port_id < respLayers.size());
 
@@ -389,15 +384,15 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
         snoopFilter->updateResponse(pkt, *slavePorts[slave_port_id]);
     }
 
+    // the response is routed, so take back the route state
+    popRoute(pkt);
+
     // send the packet through the destination slave port and pay for
     // any outstanding header delay
     Tick latency = pkt->headerDelay;
     pkt->headerDelay = 0;
     slavePorts[slave_port_id]->schedTimingResp(pkt, curTick() + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     respLayers[slave_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -433,6 +428,12 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID master_port_id)
 
     assert(pkt->snoopDelay == 0);
 
+    // remember how to route a response, before snooping, so that a
+    // cache responding with a copy of the packet also carries the
+    // route
+    if (!cache_responding)
+        pushRoute(pkt, master_port_id, true);
+
     if (snoopFilter) {
         // let the Snoop Filter work its magic and guide probing
         auto sf_res = snoopFilter->lookupSnoop(pkt);
@@ -454,10 +455,14 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID master_port_id)
     pkt->headerDelay += pkt->snoopDelay;
     pkt->snoopDelay = 0;
 
-    // if we can expect a response, remember how to route it
-    if (!cache_responding && pkt->cacheResponding()) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = master_port_id;
+    // the snoop request goes back to where it came from, and if we
+    // can expect a response, the route travels with the copy of the
+    // responding cache, otherwise it is no longer needed
+    if (!cache_responding) {
+        if (pkt->cacheResponding())
+            pkt->popSenderState();
+        else
+            popRoute(pkt);
     }
 
     // a snoop request came from a connected slave device (one of
@@ -475,17 +480,14 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     SlavePort* src_port = slavePorts[slave_port_id];
 
     // get the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID dest_port_id = route_lookup->second;
+    const RouteState& route = getRoute(pkt);
+    const PortID dest_port_id = route.port;
     assert(dest_port_id != InvalidPortID);
 
     // determine if the response is from a snoop request we
-    // created as the result of a normal request (in which case it
-    // should be in the outstandingSnoop), or if we merely forwarded
-    // someone else's snoop request
-    const bool forwardAsSnoop = outstandingSnoop.find(pkt->req) ==
-        outstandingSnoop.end();
+    // created as the result of a normal request, or if we merely
+    // forwarded someone else's snoop request
+    const bool forwardAsSnoop = route.snoop;
 
     // test if the crossbar should be considered occupied for the
     // current port, note that the check is bypassed if the response
@@ -532,6 +534,9 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     // determine how long to be crossbar layer is busy
     Tick packetFinishTime = clockEdge(Cycles(1)) + pkt->payloadDelay;
 
+    // the response is routed, so take back the route state
+    popRoute(pkt);
+
     // forward it either as a snoop response or a normal response
     if (forwardAsSnoop) {
         // this is a snoop response to a snoop request we forwarded,
@@ -556,7 +561,6 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
         // i.e. from a coherent master connected to the crossbar, and
         // since we created the snoop request as part of recvTiming,
         // this should now be a normal response again
-        outstandingSnoop.erase(pkt->req);
 
         // this is a snoop response from a coherent master, hence it
         // should never go back to where the snoop response came from,
@@ -582,9 +586,6 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
         respLayers[dest_port_id]->succeededTiming(packetFinishTime);
     }
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     // stats updates
     transDist[pkt_cmd]++;
     snoops++;
@@ -632,7 +633,8 @@ CoherentXBar::recvReqRetry(PortID master_port_id)
 }
 
 Tick
-CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
+CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id,
+                         MemBackdoorPtr* backdoor)
 {
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             slavePorts[slave_port_id]->name(), pkt->print());
@@ -684,8 +686,13 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
                 pkt->print());
     } else {
         if (!pointOfCoherency || pkt->isRead() || pkt->isWrite()) {
-            // forward the request to the appropriate destination
-            response_latency = masterPorts[master_port_id]->sendAtomic(pkt);
+            // forward the request to the appropriate destination, and
+            // only pass on a request for a backdoor when the caches are
+            // bypassed, as the accesses through it are not snooped
+            MasterPort* master_port = masterPorts[master_port_id];
+            response_latency = backdoor && system->bypassCaches() ?
+                master_port->sendAtomicBackdoor(pkt, *backdoor) :
+                master_port->sendAtomic(pkt);
         } else {
             // if it does not need a response we sink the packet above
             assert(pkt->needsResponse());
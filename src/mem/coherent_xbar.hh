@@ -51,8 +51,6 @@
 #ifndef __MEM_COHERENT_XBAR_HH__
 #define __MEM_COHERENT_XBAR_HH__
 
-#include <unordered_set>
-
 #include "mem/snoop_filter.hh"
 #include "mem/xbar.hh"
 #include "params/CoherentXBar.hh"
@@ -125,6 +123,14 @@ class CoherentXBar : public BaseXBar
         virtual Tick recvAtomic(PacketPtr pkt)
         { return xbar.recvAtomic(pkt, id); }
 
+        /**
+         * When receiving an atomic request asking for a backdoor,
+         * pass it to the crossbar.
+         */
+        virtual Tick recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr& backdoor)
+        { return xbar.recvAtomic(pkt, id, &backdoor); }
+
         /**
          * When receiving a functional request, pass it to the crossbar.
          */
@@ -255,13 +261,6 @@ class CoherentXBar : public BaseXBar
 
     std::vector<QueuedSlavePort*> snoopPorts;
 
-    /**
-     * Store the outstanding requests that we are expecting snoop
-     * responses from so we can determine which snoop responses we
-     * generated and which ones were merely forwarded.
-     */
-    std::unordered_set<RequestPtr> outstandingSnoop;
-
     /**
      * Keep a pointer to the system to be allow to querying memory system
      * properties.
@@ -330,7 +329,8 @@ class CoherentXBar : public BaseXBar
 
     /** Function called by the port when the crossbar is recieving a Atomic
       transaction.*/
-    Tick recvAtomic(PacketPtr pkt, PortID slave_port_id);
+    Tick recvAtomic(PacketPtr pkt, PortID slave_port_id,
+                    MemBackdoorPtr* backdoor = nullptr);
 
     /** Function called by the port when the crossbar is recieving an
         atomic snoop transaction.*/
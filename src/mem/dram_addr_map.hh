@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * DRAMAddrMap declaration
+ */
+
+#ifndef __MEM_DRAM_ADDR_MAP_HH__
+#define __MEM_DRAM_ADDR_MAP_HH__
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * The custom address mapping of a DRAM controller, in which every
+ * channel, rank, bank group, bank and row bit is the parity (XOR) of
+ * the physical address bits set in one mask. The masks of a field are
+ * listed from its least significant bit up, and a mask with a single
+ * bit set takes that address bit as it is.
+ *
+ * The channel is picked by the crossbar, from the interleaving of the
+ * address ranges of the controllers, and the channel masks are only
+ * kept to check the ranges against them.
+ */
+class DRAMAddrMap
+{
+
+  public:
+
+    DRAMAddrMap(const std::vector<Addr>& channel_masks,
+                const std::vector<Addr>& rank_masks,
+                const std::vector<Addr>& bank_group_masks,
+                const std::vector<Addr>& bank_masks,
+                const std::vector<Addr>& row_masks)
+        : channelMasks(channel_masks), rankMasks(rank_masks),
+          bankGroupMasks(bank_group_masks), bankMasks(bank_masks),
+          rowMasks(row_masks)
+    { }
+
+    const std::vector<Addr> channelMasks;
+    const std::vector<Addr> rankMasks;
+    const std::vector<Addr> bankGroupMasks;
+    /** Masks of the bank within its bank group */
+    const std::vector<Addr> bankMasks;
+    const std::vector<Addr> rowMasks;
+
+    /**
+     * Gather the parity of the address bits selected by each mask into
+     * the corresponding bit of the result.
+     */
+    static uint64_t
+    hash(Addr addr, const std::vector<Addr>& masks)
+    {
+        uint64_t val = 0;
+        for (int i = 0; i < masks.size(); i++)
+            val |= uint64_t(popCount(addr & masks[i]) & 1) << i;
+        return val;
+    }
+
+    /**
+     * Check that the masks of a field tell all its values apart, i.e.
+     * that there are a power of two values, one mask per bit, and no
+     * empty mask.
+     *
+     * @param masks Masks of the field
+     * @param values Number of values of the field, e.g. the ranks
+     * @return true if the masks fit the field
+     */
+    static bool
+    fits(const std::vector<Addr>& masks, unsigned values)
+    {
+        return isPowerOf2(values) && masks.size() == floorLog2(values) &&
+            std::find(masks.begin(), masks.end(), 0) == masks.end();
+    }
+
+    unsigned rank(Addr addr) const { return hash(addr, rankMasks); }
+    unsigned bankGroup(Addr addr) const
+    { return hash(addr, bankGroupMasks); }
+    unsigned bank(Addr addr) const { return hash(addr, bankMasks); }
+    unsigned row(Addr addr) const { return hash(addr, rowMasks); }
+
+};
+
+#endif //__MEM_DRAM_ADDR_MAP_HH__
@@ -0,0 +1,793 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * DRAMCache definitions
+ */
+
+#include "mem/dram_cache.hh"
+
+#include <cstring>
+
+#include "base/cast.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/DRAMCache.hh"
+#include "debug/Drain.hh"
+#include "sim/system.hh"
+
+// the miss predictor uses 3-bit counters, and predicts a miss from
+// the middle of their range
+static const uint8_t predictorMax = 7;
+static const uint8_t predictorThreshold = 4;
+
+// every transaction has at most a few requests queued on each of the
+// master ports, and the packet queues do not take more than 100
+static const unsigned maxTransactionsLimit = 32;
+
+DRAMCache::DRAMCache(const DRAMCacheParams* p)
+    : MemObject(p),
+      cpuSidePort(name() + ".slave", *this),
+      cachePort(name() + ".cache_port", *this),
+      farPort(name() + ".far_port", *this),
+      masterId(p->system->getMasterId(name())),
+      cacheRange(p->cache_range), lineSize(p->line_size),
+      assoc(p->assoc), tagSize(p->tag_size),
+      tagBytes(p->assoc * p->tag_size),
+      setBytes(p->assoc * (p->tag_size + p->line_size)),
+      numSets(p->cache_range.size() /
+              (p->assoc * (p->tag_size + p->line_size))),
+      maxTransactions(p->max_transactions), latency(p->latency),
+      lines(numSets * p->assoc),
+      predictor(p->miss_predictor ? p->predictor_entries : 0, 0),
+      numTransactions(0), retryReq(false)
+{
+    fatal_if(!isPowerOf2(lineSize), "%s: line size %d is not a power of "
+             "two\n", name(), lineSize);
+    fatal_if(assoc == 0, "%s: the cache needs at least one way\n", name());
+    fatal_if(cacheRange.interleaved(), "%s: the stacked DRAM range %s "
+             "cannot be interleaved\n", name(), cacheRange.to_string());
+    fatal_if(numSets == 0, "%s: the stacked DRAM range %s does not hold a "
+             "single set of %d bytes\n", name(), cacheRange.to_string(),
+             setBytes);
+    fatal_if(p->miss_predictor && p->predictor_entries == 0,
+             "%s: the miss predictor needs at least one entry\n", name());
+    fatal_if(maxTransactions == 0 || maxTransactions > maxTransactionsLimit,
+             "%s: max_transactions must be between 1 and %d\n", name(),
+             maxTransactionsLimit);
+}
+
+DRAMCache::~DRAMCache()
+{
+    for (auto& s : sets) {
+        for (auto t : s.second)
+            delete t;
+    }
+}
+
+void
+DRAMCache::init()
+{
+    MemObject::init();
+
+    if (!cpuSidePort.isConnected() || !cachePort.isConnected() ||
+        !farPort.isConnected())
+        fatal("%s: DRAM cache is not connected on all ports\n", name());
+
+    cpuSidePort.sendRangeChange();
+}
+
+BaseMasterPort&
+DRAMCache::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "cache_port") {
+        return cachePort;
+    } else if (if_name == "far_port") {
+        return farPort;
+    } else {
+        return MemObject::getMasterPort(if_name, idx);
+    }
+}
+
+BaseSlavePort&
+DRAMCache::getSlavePort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "slave") {
+        return cpuSidePort;
+    } else {
+        return MemObject::getSlavePort(if_name, idx);
+    }
+}
+
+bool
+DRAMCache::findLine(Addr line_addr, unsigned& way) const
+{
+    unsigned set = setOf(line_addr);
+    for (unsigned w = 0; w < assoc; ++w) {
+        const Line& line = lines[set * assoc + w];
+        if (line.valid && line.addr == line_addr) {
+            way = w;
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned
+DRAMCache::findVictim(unsigned set) const
+{
+    unsigned victim = 0;
+    for (unsigned w = 0; w < assoc; ++w) {
+        const Line& line = lines[set * assoc + w];
+        if (!line.valid)
+            return w;
+        if (line.lastUse < lines[set * assoc + victim].lastUse)
+            victim = w;
+    }
+    return victim;
+}
+
+unsigned
+DRAMCache::predictorIndex(PacketPtr pkt) const
+{
+    // prefer the PC, as misses correlate with the instruction, and
+    // fall back on the requestor for requests without one
+    Addr key = pkt->req->hasPC() ? pkt->req->getPC() :
+        pkt->req->masterId();
+    return (key ^ (key >> 12)) % predictor.size();
+}
+
+bool
+DRAMCache::recvTimingReq(PacketPtr pkt)
+{
+    DPRINTF(DRAMCache, "recvTimingReq: %s 0x%x\n", pkt->cmdString(),
+            pkt->getAddr());
+
+    // a cache above will respond, and we have no memory access to do
+    if (pkt->cacheResponding()) {
+        pendingDelete.reset(pkt);
+        return true;
+    }
+
+    // as AbstractMemory::access does, sink the requests that read and
+    // write nothing, such as the clean evictions a crossbar that is not
+    // the point of coherency passes on
+    if (!(pkt->isRead() || pkt->isWrite())) {
+        DPRINTF(DRAMCache, "Nothing to do for %s\n", pkt->cmdString());
+        if (pkt->needsResponse()) {
+            pkt->makeResponse();
+            cpuSidePort.schedTimingResp(pkt, curTick() + latency);
+        } else {
+            pendingDelete.reset(pkt);
+        }
+        return true;
+    }
+
+    Addr line_addr = lineOf(pkt->getAddr());
+    panic_if(lineOf(pkt->getAddr() + pkt->getSize() - 1) != line_addr,
+             "%s: %s 0x%x of %d bytes crosses a %d byte line\n", name(),
+             pkt->cmdString(), pkt->getAddr(), pkt->getSize(), lineSize);
+
+    if (numTransactions == maxTransactions) {
+        DPRINTF(DRAMCache, "Too many transactions, not accepting\n");
+        retryReq = true;
+        return false;
+    }
+
+    Transaction* t = new Transaction;
+    t->pkt = pkt;
+    t->lineAddr = line_addr;
+    t->set = setOf(line_addr);
+    t->offset = pkt->getAddr() - line_addr;
+    t->size = pkt->getSize();
+    t->isRead = pkt->isRead();
+    t->isWrite = pkt->isWrite();
+    t->isClean = pkt->cmd == MemCmd::WritebackClean;
+    t->hit = false;
+    t->way = 0;
+    t->lookupDone = false;
+    t->farRead = false;
+    t->farDone = false;
+    t->victimRead = false;
+    t->victimDone = false;
+    t->filled = false;
+    t->outstanding = 0;
+    t->data.resize(lineSize);
+    t->victimAddr = 0;
+    t->writeBack = false;
+    t->entryTime = curTick();
+
+    // writes carry their data, and may not need a response at all
+    if (t->isWrite) {
+        pkt->writeData(&t->data[t->offset]);
+        if (!pkt->needsResponse()) {
+            pendingDelete.reset(pkt);
+            t->pkt = nullptr;
+        }
+    }
+
+    ++numTransactions;
+
+    // requests to a set are handled in order, one at a time
+    auto& queue = sets[t->set];
+    queue.push_back(t);
+    if (queue.size() == 1)
+        startTransaction(t);
+
+    return true;
+}
+
+void
+DRAMCache::startTransaction(Transaction* t)
+{
+    unsigned way;
+    t->hit = findLine(t->lineAddr, way);
+    t->way = t->hit ? way : findVictim(t->set);
+
+    DPRINTF(DRAMCache, "Lookup of line 0x%x in set %d\n", t->lineAddr,
+            t->set);
+
+    // a predicted miss does not wait for the tags to go to far memory
+    if (t->isRead && !predictor.empty() &&
+        predictor[predictorIndex(t->pkt)] >= predictorThreshold) {
+        DPRINTF(DRAMCache, "Predicted miss, reading far memory early\n");
+        t->farRead = true;
+        ++earlyFarReads;
+        sendAccess(t, ReadFar, t->lineAddr, lineSize);
+    }
+
+    // a direct-mapped cache reads the tag and data together
+    sendAccess(t, LookupTags, tagAddr(t->set),
+               assoc == 1 ? setBytes : tagBytes);
+}
+
+void
+DRAMCache::lookupDone(Transaction* t, PacketPtr pkt)
+{
+    t->lookupDone = true;
+
+    // train the predictor on the outcome
+    if (t->isRead && !predictor.empty()) {
+        uint8_t& counter = predictor[predictorIndex(t->pkt)];
+        if (t->hit && counter > 0)
+            --counter;
+        else if (!t->hit && counter < predictorMax)
+            ++counter;
+    }
+
+    Line& line = lines[t->set * assoc + t->way];
+
+    if (t->hit) {
+        DPRINTF(DRAMCache, "Hit on line 0x%x in way %d\n", t->lineAddr,
+                t->way);
+        line.lastUse = curTick();
+
+        if (t->isRead) {
+            ++readHits;
+            if (t->farRead)
+                ++wastedFarReads;
+
+            if (assoc == 1) {
+                std::memcpy(t->data.data(), pkt->getConstPtr<uint8_t>() +
+                            tagBytes, lineSize);
+                respond(t);
+            } else {
+                sendAccess(t, ReadData,
+                           dataAddr(t->set, t->way) + t->offset, t->size);
+            }
+        } else if (t->isClean) {
+            // the line already holds the data
+            ++writeHits;
+        } else {
+            ++writeHits;
+            line.dirty = true;
+            sendAccess(t, WriteCache, dataAddr(t->set, t->way) + t->offset,
+                       t->size, &t->data[t->offset]);
+        }
+        return;
+    }
+
+    DPRINTF(DRAMCache, "Miss on line 0x%x, replacing way %d\n",
+            t->lineAddr, t->way);
+
+    if (t->isRead) {
+        ++readMisses;
+    } else {
+        ++writeMisses;
+
+        // only whole lines are allocated on a write
+        if (t->size != lineSize) {
+            t->filled = true;
+            sendAccess(t, WriteFar, t->lineAddr + t->offset, t->size,
+                       &t->data[t->offset]);
+            return;
+        }
+    }
+
+    if (t->isRead && !t->farRead) {
+        t->farRead = true;
+        ++lateFarReads;
+        sendAccess(t, ReadFar, t->lineAddr, lineSize);
+    }
+
+    if (line.valid && line.dirty) {
+        t->writeBack = true;
+        t->victimAddr = line.addr;
+        t->victimData.resize(lineSize);
+
+        // a direct-mapped cache already has the victim at hand
+        if (assoc == 1) {
+            std::memcpy(t->victimData.data(), pkt->getConstPtr<uint8_t>() +
+                        tagBytes, lineSize);
+            t->victimDone = true;
+        } else {
+            t->victimRead = true;
+            sendAccess(t, ReadVictim, dataAddr(t->set, t->way), lineSize);
+        }
+    }
+
+    tryFill(t);
+}
+
+void
+DRAMCache::sendAccess(Transaction* t, Access access, Addr addr,
+                      unsigned size, const uint8_t* data)
+{
+    bool write = access == WriteCache || access == WriteFar;
+
+    Request* req = new Request(addr, size, 0, masterId);
+    PacketPtr pkt = new Packet(req, write ? MemCmd::WriteReq :
+                               MemCmd::ReadReq);
+    pkt->allocate();
+
+    // tags are only kept by the controller, and written as zeroes
+    if (write) {
+        if (data) {
+            pkt->setData(data);
+        } else {
+            std::memset(pkt->getPtr<uint8_t>(), 0, size);
+        }
+    }
+
+    pkt->pushSenderState(new AccessState(t, access));
+    ++t->outstanding;
+
+    bool far = access == ReadFar || access == WriteFar;
+    (far ? farPort : cachePort).schedTimingReq(pkt, curTick());
+}
+
+void
+DRAMCache::tryFill(Transaction* t)
+{
+    // the requestor gets a read miss as soon as the lookup confirms it
+    if (t->isRead && t->pkt && t->lookupDone && t->farDone)
+        respond(t);
+
+    if (t->filled || !t->lookupDone || (t->isRead && !t->farDone) ||
+        (t->writeBack && !t->victimDone))
+        return;
+
+    t->filled = true;
+
+    if (t->writeBack) {
+        DPRINTF(DRAMCache, "Writing back dirty line 0x%x\n", t->victimAddr);
+        ++writeBacks;
+        sendAccess(t, WriteFar, t->victimAddr, lineSize,
+                   t->victimData.data());
+    }
+
+    Line& line = lines[t->set * assoc + t->way];
+    line.addr = t->lineAddr;
+    line.valid = true;
+    line.dirty = t->isWrite && !t->isClean;
+    line.lastUse = curTick();
+
+    // install the line, writing the tag and data of a direct-mapped
+    // cache together
+    if (assoc == 1) {
+        std::vector<uint8_t> tad(setBytes, 0);
+        std::memcpy(&tad[tagBytes], t->data.data(), lineSize);
+        sendAccess(t, WriteCache, tagAddr(t->set), setBytes, tad.data());
+    } else {
+        sendAccess(t, WriteCache, dataAddr(t->set, t->way), lineSize,
+                   t->data.data());
+        sendAccess(t, WriteCache, tagAddr(t->set) + t->way * tagSize,
+                   tagSize);
+    }
+}
+
+void
+DRAMCache::respond(Transaction* t)
+{
+    PacketPtr pkt = t->pkt;
+    t->pkt = nullptr;
+
+    DPRINTF(DRAMCache, "Responding to %s 0x%x\n", pkt->cmdString(),
+            pkt->getAddr());
+
+    if (t->isRead)
+        totReadLat += curTick() + latency - t->entryTime;
+
+    pkt->makeResponse();
+    if (pkt->hasData() && pkt->isRead())
+        pkt->setData(&t->data[t->offset]);
+
+    cpuSidePort.schedTimingResp(pkt, curTick() + latency);
+}
+
+void
+DRAMCache::recvTimingResp(PacketPtr pkt)
+{
+    AccessState* state = safe_cast<AccessState*>(pkt->popSenderState());
+    Transaction* t = state->t;
+
+    assert(t->outstanding != 0);
+    --t->outstanding;
+
+    switch (state->access) {
+      case LookupTags:
+        lookupDone(t, pkt);
+        break;
+
+      case ReadData:
+        pkt->writeData(&t->data[t->offset]);
+        respond(t);
+        break;
+
+      case ReadVictim:
+        pkt->writeData(t->victimData.data());
+        t->victimDone = true;
+        tryFill(t);
+        break;
+
+      case ReadFar:
+        t->farDone = true;
+        // an early read is of no use if the line turns out to hit
+        if (!t->hit) {
+            pkt->writeData(t->data.data());
+            tryFill(t);
+        }
+        break;
+
+      case WriteCache:
+      case WriteFar:
+        // writes are acknowledged once they reach either memory
+        if (t->pkt && t->isWrite)
+            respond(t);
+        break;
+    }
+
+    delete state;
+    delete pkt->req;
+    delete pkt;
+
+    tryRetire(t);
+}
+
+void
+DRAMCache::tryRetire(Transaction* t)
+{
+    if (!t->lookupDone || t->pkt || t->outstanding ||
+        !(t->hit || t->filled))
+        return;
+
+    auto it = sets.find(t->set);
+    assert(it != sets.end() && it->second.front() == t);
+    it->second.pop_front();
+
+    Transaction* next = nullptr;
+    if (it->second.empty())
+        sets.erase(it);
+    else
+        next = it->second.front();
+
+    delete t;
+    --numTransactions;
+
+    if (next)
+        startTransaction(next);
+
+    if (retryReq) {
+        retryReq = false;
+        cpuSidePort.sendRetryReq();
+    }
+
+    if (numTransactions == 0 && drainState() == DrainState::Draining) {
+        DPRINTF(Drain, "DRAM cache done draining\n");
+        signalDrainDone();
+    }
+}
+
+Tick
+DRAMCache::accessUntimed(PacketPtr pkt, bool functional)
+{
+    Addr line_addr = lineOf(pkt->getAddr());
+    unsigned way;
+    Tick lat = 0;
+
+    // a functional write also has to reach the copies of the line
+    // held by the transactions of its set, or a fill or write-back
+    // still in flight would later put the old data back
+    if (functional && pkt->isWrite()) {
+        unsigned offset = pkt->getAddr() - line_addr;
+        auto it = sets.find(setOf(line_addr));
+        if (it != sets.end()) {
+            for (auto t : it->second) {
+                if (t->filled)
+                    continue;
+                if (t->lineAddr == line_addr)
+                    pkt->writeData(&t->data[offset]);
+                if (t->writeBack && t->victimAddr == line_addr)
+                    pkt->writeData(&t->victimData[offset]);
+            }
+        }
+    }
+
+    // lines present in the cache are accessed in their frame, and the
+    // others in far memory, in both cases looking at what is still
+    // queued to the memory first
+    if (findLine(line_addr, way)) {
+        Line& line = lines[setOf(line_addr) * assoc + way];
+        if (pkt->isWrite() && pkt->cmd != MemCmd::WritebackClean)
+            line.dirty = true;
+
+        Addr orig_addr = pkt->getAddr();
+        pkt->setAddr(dataAddr(setOf(line_addr), way) +
+                     (orig_addr - line_addr));
+        if (!functional)
+            lat = cachePort.sendAtomic(pkt);
+        else if (!cachePort.checkFunctional(pkt))
+            cachePort.sendFunctional(pkt);
+        pkt->setAddr(orig_addr);
+    } else {
+        if (!functional)
+            lat = farPort.sendAtomic(pkt);
+        else if (!farPort.checkFunctional(pkt))
+            farPort.sendFunctional(pkt);
+    }
+
+    return lat;
+}
+
+Tick
+DRAMCache::recvAtomic(PacketPtr pkt)
+{
+    DPRINTF(DRAMCache, "recvAtomic: %s 0x%x\n", pkt->cmdString(),
+            pkt->getAddr());
+
+    panic_if(pkt->cacheResponding(), "%s: should not see packets where a "
+             "cache is responding\n", name());
+
+    if (!(pkt->isRead() || pkt->isWrite())) {
+        if (pkt->needsResponse())
+            pkt->makeResponse();
+        return latency;
+    }
+
+    // atomic accesses do not allocate, and are not meant to be
+    // accurate, only to keep the content right
+    return latency + accessUntimed(pkt, false);
+}
+
+void
+DRAMCache::recvFunctional(PacketPtr pkt)
+{
+    if (!cpuSidePort.checkFunctional(pkt))
+        accessUntimed(pkt, true);
+}
+
+DrainState
+DRAMCache::drain()
+{
+    if (numTransactions != 0) {
+        DPRINTF(Drain, "DRAM cache not drained, %d transactions\n",
+                numTransactions);
+        return DrainState::Draining;
+    } else {
+        return DrainState::Drained;
+    }
+}
+
+void
+DRAMCache::serialize(CheckpointOut &cp) const
+{
+    // the stacked DRAM checkpoints the tags and data it holds, and we
+    // only keep our copy of the tags, and the predictor, in line
+    std::vector<Addr> line_addr(lines.size());
+    std::vector<bool> line_valid(lines.size());
+    std::vector<bool> line_dirty(lines.size());
+    std::vector<Tick> line_last_use(lines.size());
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        line_addr[i] = lines[i].addr;
+        line_valid[i] = lines[i].valid;
+        line_dirty[i] = lines[i].dirty;
+        line_last_use[i] = lines[i].lastUse;
+    }
+
+    SERIALIZE_CONTAINER(line_addr);
+    SERIALIZE_CONTAINER(line_valid);
+    SERIALIZE_CONTAINER(line_dirty);
+    SERIALIZE_CONTAINER(line_last_use);
+    SERIALIZE_CONTAINER(predictor);
+}
+
+void
+DRAMCache::unserialize(CheckpointIn &cp)
+{
+    std::vector<Addr> line_addr;
+    std::vector<bool> line_valid;
+    std::vector<bool> line_dirty;
+    std::vector<Tick> line_last_use;
+
+    UNSERIALIZE_CONTAINER(line_addr);
+    UNSERIALIZE_CONTAINER(line_valid);
+    UNSERIALIZE_CONTAINER(line_dirty);
+    UNSERIALIZE_CONTAINER(line_last_use);
+
+    fatal_if(line_addr.size() != lines.size() ||
+             line_valid.size() != lines.size() ||
+             line_dirty.size() != lines.size() ||
+             line_last_use.size() != lines.size(),
+             "%s: checkpoint has %d lines, but the cache has %d\n", name(),
+             line_addr.size(), lines.size());
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        lines[i].addr = line_addr[i];
+        lines[i].valid = line_valid[i];
+        lines[i].dirty = line_dirty[i];
+        lines[i].lastUse = line_last_use[i];
+    }
+
+    std::vector<uint8_t> predictor_state;
+    arrayParamIn(cp, "predictor", predictor_state);
+    fatal_if(predictor_state.size() != predictor.size(),
+             "%s: checkpoint has %d predictor entries, but the cache has "
+             "%d\n", name(), predictor_state.size(), predictor.size());
+    predictor = predictor_state;
+}
+
+void
+DRAMCache::regStats()
+{
+    MemObject::regStats();
+
+    using namespace Stats;
+
+    readHits
+        .name(name() + ".readHits")
+        .desc("Read requests that hit in the cache");
+
+    readMisses
+        .name(name() + ".readMisses")
+        .desc("Read requests that missed in the cache");
+
+    writeHits
+        .name(name() + ".writeHits")
+        .desc("Write requests that hit in the cache");
+
+    writeMisses
+        .name(name() + ".writeMisses")
+        .desc("Write requests that missed in the cache");
+
+    hitRate
+        .name(name() + ".hitRate")
+        .desc("Fraction of the requests that hit in the cache")
+        .precision(4);
+
+    hitRate = (readHits + writeHits) /
+        (readHits + readMisses + writeHits + writeMisses);
+
+    writeBacks
+        .name(name() + ".writeBacks")
+        .desc("Dirty lines written back to far memory");
+
+    earlyFarReads
+        .name(name() + ".earlyFarReads")
+        .desc("Far memory reads started on a predicted miss");
+
+    wastedFarReads
+        .name(name() + ".wastedFarReads")
+        .desc("Far memory reads started on a mispredicted miss");
+
+    lateFarReads
+        .name(name() + ".lateFarReads")
+        .desc("Far memory reads started after the tag lookup");
+
+    totReadLat
+        .name(name() + ".totReadLat")
+        .desc("Total ticks spent on read requests");
+
+    avgReadLat
+        .name(name() + ".avgReadLat")
+        .desc("Average ticks per read request")
+        .precision(2);
+
+    avgReadLat = totReadLat / (readHits + readMisses);
+}
+
+DRAMCache::CpuSidePort::CpuSidePort(const std::string& name,
+                                    DRAMCache& _cache)
+    : QueuedSlavePort(name, &_cache, queue), queue(_cache, *this),
+      cache(_cache)
+{ }
+
+Tick
+DRAMCache::CpuSidePort::recvAtomic(PacketPtr pkt)
+{
+    return cache.recvAtomic(pkt);
+}
+
+void
+DRAMCache::CpuSidePort::recvFunctional(PacketPtr pkt)
+{
+    cache.recvFunctional(pkt);
+}
+
+bool
+DRAMCache::CpuSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return cache.recvTimingReq(pkt);
+}
+
+AddrRangeList
+DRAMCache::CpuSidePort::getAddrRanges() const
+{
+    // the cache is transparent, and covers all of far memory
+    return cache.farPort.getAddrRanges();
+}
+
+DRAMCache::MemSidePort::MemSidePort(const std::string& name,
+                                    DRAMCache& _cache)
+    : QueuedMasterPort(name, &_cache, _reqQueue, _snoopRespQueue),
+      _reqQueue(_cache, *this), _snoopRespQueue(_cache, *this),
+      cache(_cache)
+{ }
+
+bool
+DRAMCache::MemSidePort::recvTimingResp(PacketPtr pkt)
+{
+    cache.recvTimingResp(pkt);
+    return true;
+}
+
+void
+DRAMCache::MemSidePort::recvRangeChange()
+{
+    if (this == &cache.farPort)
+        cache.cpuSidePort.sendRangeChange();
+}
+
+DRAMCache*
+DRAMCacheParams::create()
+{
+    return new DRAMCache(this);
+}
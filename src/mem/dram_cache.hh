@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * DRAMCache declaration
+ */
+
+#ifndef __MEM_DRAM_CACHE_HH__
+#define __MEM_DRAM_CACHE_HH__
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/mem_object.hh"
+#include "mem/qport.hh"
+#include "params/DRAMCache.hh"
+
+/**
+ * A DRAM cache controller keeping both the tags and the data of its
+ * lines in a stacked DRAM, e.g. HBM, in front of a far memory. The
+ * stacked DRAM is a DRAMCtrl behind the cache port, and the far memory
+ * one behind the far port, so all the DRAM timing comes from the two
+ * controllers.
+ *
+ * Every set is laid out contiguously in the stacked DRAM, its tags
+ * followed by the data of its ways, so the tags and data of a set
+ * normally share a row. A direct-mapped cache reads the tag and data
+ * of its single way as one tag-and-data (TAD) access, as in the Alloy
+ * cache. A set-associative cache reads the tags of the set first, and
+ * then the data of the hit way, as in Loh-Hill and Unison caches.
+ *
+ * The controller keeps a copy of the tags to know the outcome of the
+ * lookup, but only acts on it once the tag read is done. A miss
+ * predictor, indexed by the PC or the requestor, starts the far memory
+ * read of a predicted miss in parallel with the tag read.
+ *
+ * Reads and whole-line writes allocate, with a write-back of dirty
+ * victims, and partial writes that miss go around the cache.
+ * Requests to a set are handled one at a time, in order.
+ */
+class DRAMCache : public MemObject
+{
+
+  public:
+
+    DRAMCache(const DRAMCacheParams* p);
+
+    ~DRAMCache();
+
+    BaseMasterPort& getMasterPort(const std::string& if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    BaseSlavePort& getSlavePort(const std::string& if_name,
+                                PortID idx = InvalidPortID) override;
+
+    void init() override;
+
+    void regStats() override;
+
+    DrainState drain() override;
+
+    void serialize(CheckpointOut &cp) const override;
+
+    void unserialize(CheckpointIn &cp) override;
+
+  private:
+
+    class CpuSidePort : public QueuedSlavePort
+    {
+
+        RespPacketQueue queue;
+        DRAMCache& cache;
+
+      public:
+
+        CpuSidePort(const std::string& name, DRAMCache& _cache);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt);
+
+        void recvFunctional(PacketPtr pkt);
+
+        bool recvTimingReq(PacketPtr pkt);
+
+        AddrRangeList getAddrRanges() const;
+
+    };
+
+    class MemSidePort : public QueuedMasterPort
+    {
+
+        ReqPacketQueue _reqQueue;
+        SnoopRespPacketQueue _snoopRespQueue;
+        DRAMCache& cache;
+
+      public:
+
+        MemSidePort(const std::string& name, DRAMCache& _cache);
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt);
+
+        void recvRangeChange();
+
+    };
+
+    /** A line of the cache, as recorded in its tags */
+    struct Line
+    {
+        Addr addr;
+        bool valid;
+        bool dirty;
+        Tick lastUse;
+
+        Line() : addr(0), valid(false), dirty(false), lastUse(0)
+        { }
+    };
+
+    /**
+     * A request in flight, from the tag lookup to the last access it
+     * needs to either of the memories.
+     */
+    struct Transaction
+    {
+        /** The request, until it is responded to */
+        PacketPtr pkt;
+
+        Addr lineAddr;
+        unsigned set;
+
+        /** Bytes of the line the request accesses */
+        unsigned offset;
+        unsigned size;
+
+        bool isRead;
+        bool isWrite;
+        /** A write back of a line that is not dirty */
+        bool isClean;
+
+        /** Outcome of the lookup, and the way hit or replaced */
+        bool hit;
+        unsigned way;
+
+        bool lookupDone;
+        bool farRead;
+        bool farDone;
+        bool victimRead;
+        bool victimDone;
+        bool filled;
+
+        /** Requests to the memories still in flight */
+        unsigned outstanding;
+
+        /** The line, and the dirty line it replaces */
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> victimData;
+        Addr victimAddr;
+        bool writeBack;
+
+        Tick entryTime;
+    };
+
+    /** The access a request to one of the memories does */
+    enum Access {
+        LookupTags,
+        ReadData,
+        ReadVictim,
+        WriteCache,
+        ReadFar,
+        WriteFar
+    };
+
+    /** Sender state of the requests to the memories */
+    class AccessState : public Packet::SenderState
+    {
+
+      public:
+
+        AccessState(Transaction* _t, Access _access)
+            : t(_t), access(_access)
+        { }
+
+        Transaction* const t;
+        const Access access;
+
+    };
+
+    /** Address of the line of an address */
+    Addr lineOf(Addr addr) const { return addr & ~Addr(lineSize - 1); }
+
+    /** Set of a line */
+    unsigned setOf(Addr line_addr) const
+    { return (line_addr / lineSize) % numSets; }
+
+    /** Location of the tags of a set, and of the data of a way */
+    Addr tagAddr(unsigned set) const
+    { return cacheRange.start() + set * setBytes; }
+    Addr dataAddr(unsigned set, unsigned way) const
+    { return tagAddr(set) + tagBytes + way * lineSize; }
+
+    /** Find the way holding a line, or return false */
+    bool findLine(Addr line_addr, unsigned& way) const;
+
+    /** Pick the way to replace, preferring an invalid one */
+    unsigned findVictim(unsigned set) const;
+
+    /** Entry of the miss predictor used for a request */
+    unsigned predictorIndex(PacketPtr pkt) const;
+
+    bool recvTimingReq(PacketPtr pkt);
+    Tick recvAtomic(PacketPtr pkt);
+    void recvFunctional(PacketPtr pkt);
+    void recvTimingResp(PacketPtr pkt);
+
+    /** Start the tag lookup of the first request of a set */
+    void startTransaction(Transaction* t);
+
+    /** Act on the tags once they are read */
+    void lookupDone(Transaction* t, PacketPtr pkt);
+
+    /** Issue a request to one of the memories */
+    void sendAccess(Transaction* t, Access access, Addr addr,
+                    unsigned size, const uint8_t* data = nullptr);
+
+    /** Install a missing line once its data and victim are at hand */
+    void tryFill(Transaction* t);
+
+    /** Respond to the request of a transaction */
+    void respond(Transaction* t);
+
+    /** Retire a transaction once it is done and start the next one */
+    void tryRetire(Transaction* t);
+
+    /** Access a line as it is, without allocating */
+    Tick accessUntimed(PacketPtr pkt, bool functional);
+
+    CpuSidePort cpuSidePort;
+    MemSidePort cachePort;
+    MemSidePort farPort;
+
+    const MasterID masterId;
+
+    const AddrRange cacheRange;
+    const unsigned lineSize;
+    const unsigned assoc;
+    const unsigned tagSize;
+    const unsigned tagBytes;
+    const unsigned setBytes;
+    const unsigned numSets;
+    const unsigned maxTransactions;
+    const Tick latency;
+
+    /** Copy of the tags held in the stacked DRAM */
+    std::vector<Line> lines;
+
+    /**
+     * Saturating miss counters, indexed by PC or requestor, and empty
+     * when the predictor is disabled.
+     */
+    std::vector<uint8_t> predictor;
+
+    /** Transactions per set, the first one being in progress */
+    std::unordered_map<unsigned, std::deque<Transaction*>> sets;
+    unsigned numTransactions;
+
+    /** A request was refused and waits for a retry */
+    bool retryReq;
+
+    /** Upstream packets we have accepted without responding */
+    std::unique_ptr<Packet> pendingDelete;
+
+    Stats::Scalar readHits;
+    Stats::Scalar readMisses;
+    Stats::Scalar writeHits;
+    Stats::Scalar writeMisses;
+    Stats::Formula hitRate;
+    Stats::Scalar writeBacks;
+    Stats::Scalar earlyFarReads;
+    Stats::Scalar wastedFarReads;
+    Stats::Scalar lateFarReads;
+    Stats::Scalar totReadLat;
+    Stats::Formula avgReadLat;
+
+};
+
+#endif //__MEM_DRAM_CACHE_HH__
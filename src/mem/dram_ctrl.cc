@@ -46,7 +46,12 @@
 
 #include "mem/dram_ctrl.hh"
 
+#include <algorithm>
+#include <map>
+#include <numeric>
+
 #include "base/bitfield.hh"
+#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/DRAMPower.hh"
@@ -57,13 +62,19 @@
 using namespace std;
 using namespace Data;
 
+// bursts after which the calibration of the statistical model is
+// halved, to follow the phases of the workload
+static const uint64_t statCalibrationWindow = 1 << 16;
+
 DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     AbstractMemory(p),
     port(name() + ".port", *this), isTimingMode(false),
     retryRdReq(false), retryWrReq(false),
     busState(READ),
     busStateNext(READ),
-    nextReqEvent(this), respondEvent(this),
+    nextReqEvent(this), respondEvent(this), statRetryEvent(this),
+    readQueue(p->ranks_per_channel * p->banks_per_rank),
+    writeQueue(p->ranks_per_channel * p->banks_per_rank),
     deviceSize(p->device_size),
     deviceBusWidth(p->device_bus_width), burstLength(p->burst_length),
     deviceRowBufferSize(p->device_rowbuffer_size),
@@ -86,14 +97,38 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     tCCD_L(p->tCCD_L), tRCD(p->tRCD), tCL(p->tCL), tRP(p->tRP), tRAS(p->tRAS),
     tWR(p->tWR), tRTP(p->tRTP), tRFC(p->tRFC), tREFI(p->tREFI), tRRD(p->tRRD),
     tRRD_L(p->tRRD_L), tXAW(p->tXAW), tXP(p->tXP), tXS(p->tXS),
+    tRFCsb(p->tRFCsb), tRFM(p->tRFM),
     activationLimit(p->activation_limit),
     memSchedPolicy(p->mem_sched_policy), addrMapping(p->addr_mapping),
     pageMgmt(p->page_policy),
+    addrMap(p->addr_map_channel, p->addr_map_rank, p->addr_map_bank_group,
+            p->addr_map_bank, p->addr_map_row),
+    refreshMode(p->refresh_mode),
+    refreshSetSize(p->refresh_mode == Enums::same_bank ?
+                   std::max(p->bank_groups_per_rank, 1U) : 1),
+    refreshSets(p->banks_per_rank / refreshSetSize),
+    tREFIsb(p->refresh_mode == Enums::all_bank ? p->tREFI :
+            p->tREFI / refreshSets),
+    rfmThreshold(p->rfm_raaimt),
     maxAccessesPerRow(p->max_accesses_per_row),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
     busBusyUntil(0), prevArrival(0),
-    nextReqTime(0), activeRank(0), timeStampOffset(0)
+    nextReqTime(0), statisticalMode(p->statistical_mode),
+    nextStatisticalMode(p->statistical_mode), calibBursts(0),
+    calibRowHits(0), calibLoadedBursts(0), calibLoadedTicks(0),
+    calibLastBurst(0), statBusBusyUntil(0), activeRank(0), timeStampOffset(0),
+    blacklistThreshold(p->bliss_blacklist_threshold),
+    blacklistClearInterval(p->bliss_clearing_interval),
+    nextBlacklistClear(0), lastRequestor(Request::invldMasterId),
+    requestorStreak(0), markingCap(p->parbs_marking_cap),
+    schedQuantum(p->mem_sched_policy == Enums::atlas ? p->atlas_quantum :
+                 p->tcm_quantum),
+    nextQuantum(0), atlasHistoryWeight(p->atlas_history_weight),
+    starvationThreshold(p->atlas_starvation_threshold),
+    clusterThreshold(p->tcm_cluster_threshold),
+    shuffleInterval(p->tcm_shuffle_interval), nextShuffle(0),
+    latencyClusterSize(0)
 {
     // sanity check the ranks since we rely on bit slicing for the
     // address decoding
@@ -103,6 +138,9 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     fatal_if(!isPowerOf2(burstSize), "DRAM burst size %d is not allowed, "
              "must be a power of two\n", burstSize);
 
+    fatal_if(memSchedPolicy == Enums::parbs && markingCap == 0,
+             "PAR-BS needs a marking cap of at least one burst\n");
+
     for (int i = 0; i < ranksPerChannel; i++) {
         Rank* rank = new Rank(*this, p);
         ranks.push_back(rank);
@@ -159,12 +197,48 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
 
     rowsPerBank = capacity / (rowBufferSize * banksPerRank * ranksPerChannel);
 
+    // the custom address mapping needs one mask per bit of every field
+    if (addrMapping == Enums::Custom) {
+        fatal_if(!isPowerOf2(banksPerRank) || !isPowerOf2(rowsPerBank),
+                 "%s: the custom address mapping needs a power of two "
+                 "banks and rows\n", name());
+        unsigned groups = bankGroupArch ? bankGroupsPerRank : 1;
+        fatal_if(!isPowerOf2(groups), "%s: the custom address mapping "
+                 "needs a power of two bank groups\n", name());
+        fatal_if(!DRAMAddrMap::fits(addrMap.rankMasks, ranksPerChannel),
+                 "%s: %d rank masks given for %d ranks\n", name(),
+                 addrMap.rankMasks.size(), ranksPerChannel);
+        fatal_if(!DRAMAddrMap::fits(addrMap.bankGroupMasks, groups),
+                 "%s: %d bank group masks given for %d bank groups\n",
+                 name(), addrMap.bankGroupMasks.size(), groups);
+        fatal_if(!DRAMAddrMap::fits(addrMap.bankMasks,
+                                    banksPerRank / groups),
+                 "%s: %d bank masks given for %d banks per bank group\n",
+                 name(), addrMap.bankMasks.size(), banksPerRank / groups);
+        fatal_if(!DRAMAddrMap::fits(addrMap.rowMasks, rowsPerBank),
+                 "%s: %d row masks given for %d rows\n", name(),
+                 addrMap.rowMasks.size(), rowsPerBank);
+    }
+
     // some basic sanity checks
     if (tREFI <= tRP || tREFI <= tRFC) {
         fatal("tREFI (%d) must be larger than tRP (%d) and tRFC (%d)\n",
               tREFI, tRP, tRFC);
     }
 
+    // the banks are refreshed one set at a time, so each refresh has to
+    // be done before the next set is due
+    if (refreshMode != Enums::all_bank) {
+        fatal_if(tRFCsb == 0, "%s: same-bank and per-bank refresh need "
+                 "tRFCsb\n", name());
+        fatal_if(tREFIsb <= tRP + tRFCsb, "tREFI (%d) split over %d bank "
+                 "sets must be larger than tRP (%d) and tRFCsb (%d)\n",
+                 tREFI, refreshSets, tRP, tRFCsb);
+    }
+
+    fatal_if(rfmThreshold != 0 && tRFM == 0, "%s: refresh management "
+             "needs tRFM\n", name());
+
     // basic bank group architecture checks ->
     if (bankGroupArch) {
         // must have at least one bank per bank group
@@ -214,7 +288,21 @@ DRAMCtrl::init()
             fatal("%s has %d interleaved address stripes but %d channel(s)\n",
                   name(), range.stripes(), channels);
 
-        if (addrMapping == Enums::RoRaBaChCo) {
+        // the other mappings take the channel out of the address as a
+        // slice of bits
+        fatal_if(!range.intlvMasks().empty() &&
+                 addrMapping != Enums::Custom, "%s: the interleaving masks "
+                 "of %s need the custom address mapping\n", name(),
+                 range.to_string());
+
+        if (addrMapping == Enums::Custom) {
+            // the channel masks are only checked here, so that a
+            // controller used as a single channel ignores them
+            fatal_if(!addrMap.channelMasks.empty() &&
+                     range.intlvMasks() != addrMap.channelMasks,
+                     "%s: the interleaving of %s does not match the "
+                     "channel masks\n", name(), range.to_string());
+        } else if (addrMapping == Enums::RoRaBaChCo) {
             if (rowBufferSize != range.granularity()) {
                 fatal("Channel interleaving of %s doesn't match RoRaBaChCo "
                       "address map\n", name());
@@ -254,7 +342,8 @@ DRAMCtrl::startup()
     // remember the memory system mode of operation
     isTimingMode = system()->isTimingMode();
 
-    if (isTimingMode) {
+    // the statistical mode leaves the ranks alone
+    if (isTimingMode && !statisticalMode) {
         // timestamp offset should be in clock cycles for DRAMPower
         timeStampOffset = divCeil(curTick(), tCK);
 
@@ -398,6 +487,20 @@ DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
 
         // lastly, get the row bits, no need to remove them from addr
         row = addr % rowsPerBank;
+    } else if (addrMapping == Enums::Custom) {
+        // every bit is a hash of the physical address, typically
+        // matching the mapping of a real controller; the column is
+        // whatever is left, and is not needed for the timing
+        rank = addrMap.rank(dramPktAddr);
+        row = addrMap.row(dramPktAddr);
+
+        // the bank group is the low-order part of the bank, see the
+        // bank group assignment in the constructor
+        bank = addrMap.bank(dramPktAddr);
+        if (bankGroupArch) {
+            bank = bank * bankGroupsPerRank +
+                addrMap.bankGroup(dramPktAddr);
+        }
     } else
         panic("Unknown address mapping policy chosen!");
 
@@ -615,6 +718,8 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     }
     prevArrival = curTick();
 
+    if (statisticalMode)
+        return recvTimingReqStatistical(pkt);
 
     // Find out how many dram packets a pkt translates to
     // If the burst size is equal or larger than the pkt size, then a pkt
@@ -752,7 +857,7 @@ DRAMCtrl::processRespondEvent()
 }
 
 bool
-DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
     // This method does the arbitration between requests. The chosen
     // packet is simply moved to the head of the queue. The other
@@ -779,113 +884,414 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
         for (auto i = queue.begin(); i != queue.end() ; ++i) {
             DRAMPacket* dram_pkt = *i;
             if (ranks[dram_pkt->rank]->isAvailable()) {
-                queue.erase(i);
-                queue.push_front(dram_pkt);
+                queue.moveToFront(dram_pkt);
                 found_packet = true;
                 break;
             }
         }
     } else if (memSchedPolicy == Enums::frfcfs) {
         found_packet = reorderQueue(queue, extra_col_delay);
+    } else if (memSchedPolicy == Enums::bliss ||
+               memSchedPolicy == Enums::atlas ||
+               memSchedPolicy == Enums::tcm ||
+               memSchedPolicy == Enums::parbs) {
+        found_packet = chooseNextAppAware(queue);
     } else
         panic("No scheduling policy chosen\n");
     return found_packet;
 }
 
 bool
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::reorderQueue(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
-    // Only determine this if needed
-    uint64_t earliest_banks = 0;
-    bool hidden_bank_prep = false;
+    // Pick, in order of preference, the oldest row hit that can issue
+    // seamlessly, the oldest packet to one of the earliest banks if it
+    // can be opened 'behind the scenes', the oldest row hit that is
+    // prepped but not seamless, and finally the oldest packet to one of
+    // the earliest banks. This is the order a walk of the queue from
+    // its head would give, but only the open row and the oldest packet
+    // of each bank with queued packets are looked at.
+
+    // time we need to issue a column command to be seamless
+    const Tick min_col_at = std::max(busBusyUntil - tCL + extra_col_delay,
+                                     curTick());
 
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
+    DRAMPacket* seamless_pkt = NULL;
+    DRAMPacket* prepped_pkt = NULL;
 
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
+    for (int i = 0; i < ranksPerChannel; i++) {
+        // skip ranks that are not available, e.g. refreshing
+        if (!ranks[i]->isAvailable())
+            continue;
 
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
+        for (int j = 0; j < banksPerRank; j++) {
+            uint16_t bank_id = i * banksPerRank + j;
+            if (!queue.bankEntries(bank_id))
+                continue;
+
+            const Bank& bank = ranks[i]->banks[j];
+            DRAMPacket* dram_pkt = queue.oldestInRow(bank_id, bank.openRow);
+            if (dram_pkt == NULL)
+                continue;
+
+            // no additional rank-to-rank or same bank-group delays, or
+            // we switched read/write and might as well go for the row
+            // hit; FCFS within the hits, giving priority to commands
+            // that can issue seamlessly
+            DRAMPacket*& hit = bank.colAllowedAt <= min_col_at ?
+                seamless_pkt : prepped_pkt;
+            if (hit == NULL || dram_pkt->queueSeq < hit->queueSeq)
+                hit = dram_pkt;
+        }
+    }
+
+    DRAMPacket* selected_pkt = seamless_pkt;
+    if (selected_pkt != NULL) {
+        DPRINTF(DRAM, "Seamless row buffer hit\n");
+    } else {
+        // determine entries with earliest bank delay, minBankPrep will
+        // give priority to packets that can issue seamlessly
+        pair<uint64_t, bool> bankStatus = minBankPrep(queue, min_col_at);
+        uint64_t earliest_banks = bankStatus.first;
+        bool hidden_bank_prep = bankStatus.second;
+
+        // the oldest packet to a closed row of one of those banks;
+        // selecting closed rows enables more open row possibilities in
+        // future selections
+        DRAMPacket* earliest_pkt = NULL;
+        while (earliest_banks) {
+            int bank_id = findLsbSet(earliest_banks);
+            earliest_banks &= earliest_banks - 1;
+
+            const Bank& bank = ranks[bank_id / banksPerRank]->
+                banks[bank_id % banksPerRank];
+            DRAMPacket* dram_pkt = queue.oldestNotInRow(bank_id,
+                                                        bank.openRow);
+            if (dram_pkt != NULL && (earliest_pkt == NULL ||
+                    dram_pkt->queueSeq < earliest_pkt->queueSeq))
+                earliest_pkt = dram_pkt;
+        }
 
-    auto selected_pkt_it = queue.end();
+        // give priority to packets that can issue bank commands 'behind
+        // the scenes', any additional delay if any will be due to
+        // col-to-col command requirements
+        if (earliest_pkt != NULL && (hidden_bank_prep ||
+                                     prepped_pkt == NULL)) {
+            selected_pkt = earliest_pkt;
+        } else if (prepped_pkt != NULL) {
+            DPRINTF(DRAM, "Prepped row buffer hit\n");
+            selected_pkt = prepped_pkt;
+        }
+    }
 
-    // time we need to issue a column command to be seamless
-    const Tick min_col_at = std::max(busBusyUntil - tCL + extra_col_delay,
-                                     curTick());
+    if (selected_pkt != NULL) {
+        queue.moveToFront(selected_pkt);
+        return true;
+    }
+
+    return false;
+}
+
+DRAMCtrl::Requestor&
+DRAMCtrl::requestor(MasterID id)
+{
+    if (id >= requestors.size())
+        requestors.resize(id + 1);
+    return requestors[id];
+}
+
+bool
+DRAMCtrl::chooseNextAppAware(DRAMPacketQueue& queue)
+{
+    // the time-driven part of the policies is brought up to date
+    // lazily, whenever a decision is made
+    if (memSchedPolicy == Enums::bliss && curTick() >= nextBlacklistClear) {
+        for (auto& r : requestors)
+            r.blacklisted = false;
+        nextBlacklistClear = curTick() + blacklistClearInterval;
+    }
+
+    if ((memSchedPolicy == Enums::atlas || memSchedPolicy == Enums::tcm) &&
+        curTick() >= nextQuantum) {
+        endQuantum();
+        nextQuantum = curTick() + schedQuantum;
+    }
+
+    if (memSchedPolicy == Enums::tcm && curTick() >= nextShuffle) {
+        shuffleCluster();
+        nextShuffle = curTick() + shuffleInterval;
+    }
+
+    // PAR-BS forms a new batch once the current one is served
+    if (memSchedPolicy == Enums::parbs &&
+        std::none_of(queue.begin(), queue.end(),
+                     [](const DRAMPacket* p) { return p->marked; })) {
+        formBatch(queue);
+    }
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
+    if (memSchedPolicy == Enums::tcm) {
+        for (auto& r : requestors)
+            r.bankMask = 0;
+    }
+
+    // walk the queue from the oldest packet, so that the oldest packet
+    // wins amongst those with the same priority
+    DRAMPacket* selected_pkt = NULL;
+    uint64_t selected_prio = 0;
+    for (auto dram_pkt : queue) {
+        if (memSchedPolicy == Enums::tcm) {
+            requestor(dram_pkt->masterId).bankMask |=
+                ULL(1) << dram_pkt->bankId;
+        }
 
         // check if rank is available, if not, jump to the next packet
-        if (dram_pkt->rankRef.isAvailable()) {
-            // check if it is a row hit
-            if (bank.openRow == dram_pkt->row) {
-                // no additional rank-to-rank or same bank-group
-                // delays, or we switched read/write and might as well
-                // go for the row hit
-                if (bank.colAllowedAt <= min_col_at) {
-                    // FCFS within the hits, giving priority to
-                    // commands that can issue seamlessly, without
-                    // additional delay, such as same rank accesses
-                    // and/or different bank-group accesses
-                    DPRINTF(DRAM, "Seamless row buffer hit\n");
-                    selected_pkt_it = i;
-                    // no need to look through the remaining queue entries
-                    break;
-                } else if (!found_hidden_bank && !found_prepped_pkt) {
-                    // if we did not find a packet to a closed row that can
-                    // issue the bank commands without incurring delay, and
-                    // did not yet find a packet to a prepped row, remember
-                    // the current one
-                    selected_pkt_it = i;
-                    found_prepped_pkt = true;
-                    DPRINTF(DRAM, "Prepped row buffer hit\n");
-                }
-            } else if (!found_earliest_pkt) {
-                // if we have not initialised the bank status, do it
-                // now, and only once per scheduling decisions
-                if (earliest_banks == 0) {
-                    // determine entries with earliest bank delay
-                    pair<uint64_t, bool> bankStatus =
-                        minBankPrep(queue, min_col_at);
-                    earliest_banks = bankStatus.first;
-                    hidden_bank_prep = bankStatus.second;
-                }
+        if (!dram_pkt->rankRef.isAvailable())
+            continue;
 
-                // bank is amongst first available banks
-                // minBankPrep will give priority to packets that can
-                // issue seamlessly
-                if (bits(earliest_banks, dram_pkt->bankId, dram_pkt->bankId)) {
-                    found_earliest_pkt = true;
-                    found_hidden_bank = hidden_bank_prep;
-
-                    // give priority to packets that can issue
-                    // bank commands 'behind the scenes'
-                    // any additional delay if any will be due to
-                    // col-to-col command requirements
-                    if (hidden_bank_prep || !found_prepped_pkt)
-                        selected_pkt_it = i;
-                }
+        uint64_t prio = schedPriority(dram_pkt);
+        if (selected_pkt == NULL || prio > selected_prio) {
+            selected_pkt = dram_pkt;
+            selected_prio = prio;
+        }
+    }
+
+    // sample the bank-level parallelism of every requestor with queued
+    // packets
+    if (memSchedPolicy == Enums::tcm) {
+        for (auto& r : requestors) {
+            if (r.bankMask) {
+                r.blpSum += popCount(r.bankMask);
+                ++r.blpSamples;
             }
         }
     }
 
-    if (selected_pkt_it != queue.end()) {
-        DRAMPacket* selected_pkt = *selected_pkt_it;
-        queue.erase(selected_pkt_it);
-        queue.push_front(selected_pkt);
-        return true;
+    if (selected_pkt == NULL)
+        return false;
+
+    DPRINTF(DRAM, "Selected requestor %d, priority %#x\n",
+            selected_pkt->masterId, selected_prio);
+    queue.moveToFront(selected_pkt);
+    return true;
+}
+
+uint64_t
+DRAMCtrl::schedPriority(const DRAMPacket* dram_pkt)
+{
+    const Requestor& r = requestor(dram_pkt->masterId);
+    uint64_t row_hit = dram_pkt->bankRef.openRow == dram_pkt->row;
+    // lower ranks are served first
+    unsigned r_rank = memSchedPolicy == Enums::parbs ?
+        r.batchRank[dram_pkt->isRead] : r.rank;
+    uint64_t rank = r_rank < Requestor::unranked ?
+        Requestor::unranked - r_rank : 0;
+
+    switch (memSchedPolicy) {
+      case Enums::bliss:
+        // requestors that are not blacklisted first, then row hits
+        return (uint64_t(!r.blacklisted) << 1) | row_hit;
+      case Enums::atlas: {
+        // packets over the starvation threshold first, then the
+        // requestors with the least attained service, then row hits
+        uint64_t starving =
+            dram_pkt->entryTime + starvationThreshold <= curTick();
+        return (starving << 17) | (rank << 1) | row_hit;
+      }
+      case Enums::tcm:
+        // the latency-sensitive cluster comes first in the ranking
+        return (rank << 1) | row_hit;
+      case Enums::parbs:
+        // the current batch first, then row hits, then the ranking
+        return (uint64_t(dram_pkt->marked) << 17) | (row_hit << 16) | rank;
+      default:
+        panic("Scheduling policy %s is not application-aware\n",
+              Enums::MemSchedStrings[memSchedPolicy]);
     }
+}
 
-    return false;
+void
+DRAMCtrl::schedIssued(const DRAMPacket* dram_pkt, bool row_hit)
+{
+    Requestor& r = requestor(dram_pkt->masterId);
+
+    switch (memSchedPolicy) {
+      case Enums::bliss:
+        // blacklist a requestor once it has been served too many
+        // bursts in a row
+        if (dram_pkt->masterId == lastRequestor) {
+            ++requestorStreak;
+        } else {
+            lastRequestor = dram_pkt->masterId;
+            requestorStreak = 1;
+        }
+        if (requestorStreak >= blacklistThreshold && !r.blacklisted) {
+            DPRINTF(DRAM, "Blacklisting requestor %d\n", lastRequestor);
+            r.blacklisted = true;
+        }
+        break;
+      case Enums::atlas:
+        // approximate the bank time used by the burst
+        r.attainedService += tBURST + (row_hit ? 0 : tRP + tRCD);
+        break;
+      case Enums::tcm:
+        ++r.bursts;
+        if (row_hit)
+            ++r.rowHits;
+        break;
+      default:
+        break;
+    }
+}
+
+void
+DRAMCtrl::formBatch(DRAMPacketQueue& queue)
+{
+    if (queue.empty())
+        return;
+
+    bool is_read = queue.front()->isRead;
+
+    // mark the oldest bursts of every requestor to every bank, up to
+    // the marking cap
+    std::map<std::pair<MasterID, uint16_t>, unsigned> marked;
+    for (auto dram_pkt : queue) {
+        unsigned& n = marked[std::make_pair(dram_pkt->masterId,
+                                            dram_pkt->bankId)];
+        if (n < markingCap) {
+            dram_pkt->marked = true;
+            ++n;
+        }
+    }
+
+    // shortest job first: rank the requestors by the most marked
+    // bursts they have to a single bank, and then by their total
+    // number of marked bursts
+    std::vector<std::pair<unsigned, unsigned>> load(requestors.size());
+    for (const auto& m : marked) {
+        if (m.first.first >= load.size())
+            load.resize(m.first.first + 1);
+        auto& l = load[m.first.first];
+        l.first = std::max(l.first, m.second);
+        l.second += m.second;
+    }
+
+    std::vector<MasterID> order;
+    for (MasterID id = 0; id < load.size(); id++) {
+        if (load[id].second != 0)
+            order.push_back(id);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&load](MasterID a, MasterID b)
+                     { return load[a] < load[b]; });
+
+    for (auto& r : requestors)
+        r.batchRank[is_read] = Requestor::unranked;
+    for (unsigned i = 0; i < order.size(); i++)
+        requestor(order[i]).batchRank[is_read] = i;
+
+    DPRINTF(DRAM, "New PAR-BS batch of %d requestors\n", marked.size());
+}
+
+void
+DRAMCtrl::endQuantum()
+{
+    std::vector<MasterID> order(requestors.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    if (memSchedPolicy == Enums::atlas) {
+        // least attained service first, with the history of the
+        // previous quanta weighted in
+        for (auto& r : requestors) {
+            r.totalAttainedService =
+                atlasHistoryWeight * r.totalAttainedService +
+                (1 - atlasHistoryWeight) * r.attainedService;
+            r.attainedService = 0;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [this](MasterID a, MasterID b)
+                         { return requestors[a].totalAttainedService <
+                                  requestors[b].totalAttainedService; });
+        for (unsigned i = 0; i < order.size(); i++)
+            requestors[order[i]].rank = i;
+        return;
+    }
+
+    assert(memSchedPolicy == Enums::tcm);
+
+    // the least memory-intensive requestors form the latency-sensitive
+    // cluster, as long as they use no more than the cluster threshold of
+    // the bandwidth; the controller does not see instructions, so the
+    // intensity is measured in bursts rather than misses per instruction
+    std::stable_sort(order.begin(), order.end(),
+                     [this](MasterID a, MasterID b)
+                     { return requestors[a].bursts < requestors[b].bursts; });
+
+    uint64_t total_bursts = 0;
+    for (const auto& r : requestors)
+        total_bursts += r.bursts;
+
+    uint64_t cluster_bursts = 0;
+    latencyClusterSize = 0;
+    while (latencyClusterSize < order.size()) {
+        cluster_bursts += requestors[order[latencyClusterSize]].bursts;
+        if (cluster_bursts > clusterThreshold * total_bursts)
+            break;
+        requestors[order[latencyClusterSize]].rank = latencyClusterSize;
+        ++latencyClusterSize;
+    }
+
+    // the bandwidth-sensitive cluster starts out with the nicest
+    // requestors first, i.e. those with a high bank-level parallelism
+    // and a low row-buffer locality, which interfere least with others
+    bandwidthCluster.assign(order.begin() + latencyClusterSize, order.end());
+
+    auto blp = [this](MasterID id) {
+        const Requestor& r = requestors[id];
+        return r.blpSamples ? r.blpSum / r.blpSamples : 0.0;
+    };
+    auto rbl = [this](MasterID id) {
+        const Requestor& r = requestors[id];
+        return r.bursts ? double(r.rowHits) / r.bursts : 0.0;
+    };
+
+    std::vector<MasterID> by_blp(bandwidthCluster);
+    std::stable_sort(by_blp.begin(), by_blp.end(),
+                     [&blp](MasterID a, MasterID b)
+                     { return blp(a) < blp(b); });
+    std::vector<MasterID> by_rbl(bandwidthCluster);
+    std::stable_sort(by_rbl.begin(), by_rbl.end(),
+                     [&rbl](MasterID a, MasterID b)
+                     { return rbl(a) < rbl(b); });
+
+    std::vector<int> niceness(requestors.size(), 0);
+    for (int i = 0; i < by_blp.size(); i++) {
+        niceness[by_blp[i]] += i;
+        niceness[by_rbl[i]] -= i;
+    }
+    std::stable_sort(bandwidthCluster.begin(), bandwidthCluster.end(),
+                     [&niceness](MasterID a, MasterID b)
+                     { return niceness[a] > niceness[b]; });
+    shuffleCluster();
+
+    for (auto& r : requestors) {
+        r.bursts = 0;
+        r.rowHits = 0;
+        r.blpSum = 0;
+        r.blpSamples = 0;
+    }
+}
+
+void
+DRAMCtrl::shuffleCluster()
+{
+    // rotate the bandwidth-sensitive cluster, so that every requestor in
+    // it gets the highest priority in turn
+    if (!bandwidthCluster.empty()) {
+        std::rotate(bandwidthCluster.begin(), bandwidthCluster.begin() + 1,
+                    bandwidthCluster.end());
+    }
+    for (unsigned i = 0; i < bandwidthCluster.size(); i++)
+        requestors[bandwidthCluster[i]].rank = latencyClusterSize + i;
 }
 
 void
@@ -946,6 +1352,10 @@ DRAMCtrl::activateBank(Rank& rank_ref, Bank& bank_ref,
     ++rank_ref.numBanksActive;
     assert(rank_ref.numBanksActive <= banksPerRank);
 
+    // rolling accumulated activates for refresh management
+    if (rfmThreshold != 0)
+        ++bank_ref.raaCount;
+
     DPRINTF(DRAM, "Activate bank %d, rank %d at tick %lld, now got %d active\n",
             bank_ref.bank, rank_ref.rank, act_tick,
             ranks[rank_ref.rank]->numBanksActive);
@@ -1044,6 +1454,19 @@ DRAMCtrl::prechargeBank(Rank& rank_ref, Bank& bank, Tick pre_at, bool trace)
 
     bank.actAllowedAt = std::max(bank.actAllowedAt, pre_done_at);
 
+    // once the bank accumulated enough activates, follow the
+    // precharge by a refresh management command to the bank, which
+    // keeps it from being activated for tRFM
+    if (rfmThreshold != 0 && bank.raaCount >= rfmThreshold) {
+        bank.raaCount -= rfmThreshold;
+        bank.actAllowedAt = std::max(bank.actAllowedAt,
+                                     pre_done_at + tRFM);
+        ++refreshMgmtCmds;
+
+        DPRINTF(DRAM, "Refresh management of bank %d, rank %d at tick "
+                "%lld\n", bank.bank, rank_ref.rank, pre_done_at);
+    }
+
     assert(rank_ref.numBanksActive != 0);
     --rank_ref.numBanksActive;
 
@@ -1197,30 +1620,22 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         // page, but closes it only if there are no row hits in the queue.
         // In this case, only force an auto precharge when there
         // are no same page hits in the queue
-        bool got_more_hits = false;
-        bool got_bank_conflict = false;
 
         // either look at the read queue or write queue
-        const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
+        const DRAMPacketQueue& queue = dram_pkt->isRead ? readQueue :
             writeQueue;
-        auto p = queue.begin();
-        // make sure we are not considering the packet that we are
-        // currently dealing with (which is the head of the queue)
-        ++p;
-
-        // keep on looking until we find a hit or reach the end of the queue
-        // 1) if a hit is found, then both open and close adaptive policies keep
-        // the page open
-        // 2) if no hit is found, got_bank_conflict is set to true if a bank
-        // conflict request is waiting in the queue
-        while (!got_more_hits && p != queue.end()) {
-            bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                (dram_pkt->bank == (*p)->bank);
-            bool same_row = dram_pkt->row == (*p)->row;
-            got_more_hits |= same_rank_bank && same_row;
-            got_bank_conflict |= same_rank_bank && !same_row;
-            ++p;
-        }
+
+        // the packet we are currently dealing with is still at the head
+        // of the queue, and counts as one of the entries of its row
+        // 1) if another hit is queued, then both open and close adaptive
+        // policies keep the page open
+        // 2) if no hit is queued, got_bank_conflict is set to true if a
+        // bank conflict request is waiting in the queue
+        unsigned row_entries = queue.rowEntries(dram_pkt->bankId,
+                                                dram_pkt->row);
+        bool got_more_hits = row_entries > 1;
+        bool got_bank_conflict =
+            queue.bankEntries(dram_pkt->bankId) > row_entries;
 
         // auto pre-charge when either
         // 1) open_adaptive policy, we have not got any more hits, and
@@ -1237,6 +1652,26 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     MemCommand::cmds command = (mem_cmd == "RD") ? MemCommand::RD :
                                                    MemCommand::WR;
 
+    // calibrate the statistical model, the bus ticks of a burst only
+    // being representative when more bursts are waiting for it
+    ++calibBursts;
+    if (row_hit)
+        ++calibRowHits;
+    const DRAMPacketQueue& dir_queue = dram_pkt->isRead ? readQueue :
+        writeQueue;
+    if (dir_queue.size() > 1 && calibLastBurst <= dram_pkt->readyTime) {
+        ++calibLoadedBursts;
+        calibLoadedTicks += dram_pkt->readyTime - calibLastBurst;
+    }
+    calibLastBurst = dram_pkt->readyTime;
+
+    if (calibBursts == statCalibrationWindow) {
+        calibBursts /= 2;
+        calibRowHits /= 2;
+        calibLoadedBursts /= 2;
+        calibLoadedTicks /= 2;
+    }
+
     // Update bus state
     busBusyUntil = dram_pkt->readyTime;
 
@@ -1265,7 +1700,11 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     // we will wake up sooner than we have to.
     nextReqTime = busBusyUntil - (tRP + tRCD + tCL);
 
+    if (memSchedPolicy != Enums::fcfs && memSchedPolicy != Enums::frfcfs)
+        schedIssued(dram_pkt, row_hit);
+
     // Update the stats and schedule the next request
+    bool known_master = dram_pkt->masterId < system()->maxMasters();
     if (dram_pkt->isRead) {
         ++readsThisTime;
         if (row_hit)
@@ -1277,12 +1716,23 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         totMemAccLat += dram_pkt->readyTime - dram_pkt->entryTime;
         totBusLat += tBURST;
         totQLat += cmd_at - dram_pkt->entryTime;
+
+        if (known_master) {
+            perMasterRdBursts[dram_pkt->masterId]++;
+            perMasterRdLat[dram_pkt->masterId] +=
+                dram_pkt->readyTime - dram_pkt->entryTime;
+            perMasterRdSchedLat[dram_pkt->masterId] +=
+                curTick() - dram_pkt->entryTime;
+        }
     } else {
         ++writesThisTime;
         if (row_hit)
             writeRowHits++;
         bytesWritten += burstSize;
         perBankWrBursts[dram_pkt->bankId]++;
+
+        if (known_master)
+            perMasterWrBursts[dram_pkt->masterId]++;
     }
 }
 
@@ -1544,7 +1994,7 @@ DRAMCtrl::processNextReqEvent()
 }
 
 pair<uint64_t, bool>
-DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
+DRAMCtrl::minBankPrep(const DRAMPacketQueue& queue,
                       Tick min_col_at) const
 {
     uint64_t bank_mask = 0;
@@ -1561,14 +2011,6 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     // delay on the data bus
     bool hidden_bank_prep = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->rankRef.isAvailable())
-            got_waiting[p->bankId] = true;
-    }
-
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
     for (int i = 0; i < ranksPerChannel; i++) {
@@ -1576,10 +2018,9 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
             uint16_t bank_id = i * banksPerRank + j;
 
             // if we have waiting requests for the bank, and it is
-            // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
-                // make sure this rank is not currently refreshing.
-                assert(ranks[i]->isAvailable());
+            // amongst the first available, update the mask; skip ranks
+            // that are currently refreshing
+            if (queue.bankEntries(bank_id) && ranks[i]->isAvailable()) {
                 // simplistic approximation of when the bank can issue
                 // an activate, ignoring any rank-to-rank switching
                 // cost in this calculation
@@ -1629,7 +2070,8 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
 DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p)
     : EventManager(&_memory), memory(_memory),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0), nextRefreshSet(0),
+      pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(0),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), numBanksActive(0),
@@ -1776,6 +2218,15 @@ DRAMCtrl::Rank::processWriteDoneEvent()
 void
 DRAMCtrl::Rank::processRefreshEvent()
 {
+    // with same-bank or per-bank refresh an awake rank only refreshes
+    // one set of banks, and a rank in a low-power state falls back to
+    // an all-bank refresh
+    if ((memory.refreshMode != Enums::all_bank) &&
+        (refreshState == REF_IDLE) && !inLowPowerState) {
+        refreshBankSet();
+        return;
+    }
+
     // when first preparing the refresh, remember when it was due
     if ((refreshState == REF_IDLE) || (refreshState == REF_SREF_EXIT)) {
         // remember when the refresh is due
@@ -1895,6 +2346,7 @@ DRAMCtrl::Rank::processRefreshEvent()
 
         for (auto &b : banks) {
             b.actAllowedAt = ref_done_at;
+            b.raaCount -= std::min(b.raaCount, memory.rfmThreshold);
         }
 
         // at the moment this affects all ranks
@@ -1906,8 +2358,10 @@ DRAMCtrl::Rank::processRefreshEvent()
         DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(curTick(), memory.tCK) -
                 memory.timeStampOffset, rank);
 
-        // Update for next refresh
+        // Update for next refresh, which also covers all the bank
+        // sets of a same-bank or per-bank refresh interval
         refreshDueAt += memory.tREFI;
+        nextRefreshSet = 0;
 
         // make sure we did not wait so long that we cannot make up
         // for it
@@ -1973,6 +2427,57 @@ DRAMCtrl::Rank::processRefreshEvent()
     }
 }
 
+void
+DRAMCtrl::Rank::refreshBankSet()
+{
+    refreshDueAt = curTick();
+
+    // the banks of a set are adjacent, see the bank group assignment
+    // in the constructor
+    auto first = banks.begin() + nextRefreshSet * memory.refreshSetSize;
+    auto last = first + memory.refreshSetSize;
+
+    // first close the open banks of the set, respecting any existing
+    // constraints, the rest of the rank is left untouched
+    Tick pre_at = curTick();
+    for (auto b = first; b != last; ++b) {
+        if (b->openRow != Bank::NO_ROW)
+            pre_at = std::max(pre_at, b->preAllowedAt);
+    }
+
+    Tick ref_at = curTick();
+    for (auto b = first; b != last; ++b) {
+        if (b->openRow != Bank::NO_ROW)
+            memory.prechargeBank(*this, *b, pre_at);
+        ref_at = std::max(ref_at, b->actAllowedAt);
+    }
+
+    Tick ref_done_at = ref_at + memory.tRFCsb;
+
+    for (auto b = first; b != last; ++b) {
+        b->actAllowedAt = ref_done_at;
+        b->raaCount -= std::min(b->raaCount, memory.rfmThreshold);
+    }
+
+    // DRAMPower has no notion of a partial refresh, so the energy of
+    // these refreshes is not accounted for
+    ++memory.bankSetRefreshes;
+
+    DPRINTF(DRAM, "Refreshing bank set %d of rank %d from %llu to %llu\n",
+            nextRefreshSet, rank, ref_at, ref_done_at);
+
+    nextRefreshSet = (nextRefreshSet + 1) % memory.refreshSets;
+
+    // the refresh of the next set is due one fraction of tREFI later
+    refreshDueAt += memory.tREFIsb;
+
+    if (refreshDueAt < ref_done_at) {
+        fatal("Refresh was delayed so long we cannot catch up\n");
+    }
+
+    schedule(refreshEvent, refreshDueAt);
+}
+
 void
 DRAMCtrl::Rank::schedulePowerEvent(PowerState pwr_state, Tick tick)
 {
@@ -2405,6 +2910,78 @@ DRAMCtrl::regStats()
         .name(name() + ".perBankWrBursts")
         .desc("Per bank write bursts");
 
+    perMasterRdBursts
+        .init(system()->maxMasters())
+        .name(name() + ".perMasterRdBursts")
+        .desc("Per requestor read bursts serviced by the DRAM")
+        .flags(nozero);
+
+    perMasterWrBursts
+        .init(system()->maxMasters())
+        .name(name() + ".perMasterWrBursts")
+        .desc("Per requestor write bursts")
+        .flags(nozero);
+
+    perMasterRdBW
+        .name(name() + ".perMasterRdBW")
+        .desc("Per requestor DRAM read bandwidth in MiByte/s")
+        .flags(nozero)
+        .precision(2);
+
+    perMasterRdBW = (perMasterRdBursts * burstSize / 1000000) / simSeconds;
+
+    perMasterWrBW
+        .name(name() + ".perMasterWrBW")
+        .desc("Per requestor DRAM write bandwidth in MiByte/s")
+        .flags(nozero)
+        .precision(2);
+
+    perMasterWrBW = (perMasterWrBursts * burstSize / 1000000) / simSeconds;
+
+    perMasterRdLat
+        .init(system()->maxMasters())
+        .name(name() + ".perMasterRdLat")
+        .desc("Per requestor ticks from burst creation until serviced")
+        .flags(nozero);
+
+    perMasterRdSchedLat
+        .init(system()->maxMasters())
+        .name(name() + ".perMasterRdSchedLat")
+        .desc("Per requestor ticks from burst creation until scheduled")
+        .flags(nozero);
+
+    perMasterAvgRdLat
+        .name(name() + ".perMasterAvgRdLat")
+        .desc("Per requestor average read latency per burst")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    perMasterAvgRdLat = perMasterRdLat / perMasterRdBursts;
+
+    // the latency the reads would have seen had they been scheduled on
+    // arrival is taken as the latency without interference
+    perMasterSlowdown
+        .name(name() + ".perMasterSlowdown")
+        .desc("Per requestor read latency relative to the latency once "
+              "scheduled, an estimate of the scheduling slowdown")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    perMasterSlowdown = perMasterRdLat /
+        (perMasterRdLat - perMasterRdSchedLat);
+
+    for (int i = 0; i < system()->maxMasters(); i++) {
+        const std::string master = system()->getMasterName(i);
+        perMasterRdBursts.subname(i, master);
+        perMasterWrBursts.subname(i, master);
+        perMasterRdBW.subname(i, master);
+        perMasterWrBW.subname(i, master);
+        perMasterRdLat.subname(i, master);
+        perMasterRdSchedLat.subname(i, master);
+        perMasterAvgRdLat.subname(i, master);
+        perMasterSlowdown.subname(i, master);
+    }
+
     avgRdQLen
         .name(name() + ".avgRdQLen")
         .desc("Average read queue length when enqueuing")
@@ -2457,6 +3034,22 @@ DRAMCtrl::regStats()
         .name(name() + ".numWrRetry")
         .desc("Number of times write queue was full causing retry");
 
+    bankSetRefreshes
+        .name(name() + ".bankSetRefreshes")
+        .desc("Number of same-bank or per-bank refreshes");
+
+    refreshMgmtCmds
+        .name(name() + ".refreshMgmtCmds")
+        .desc("Number of refresh management commands");
+
+    statReadReqs
+        .name(name() + ".statReadReqs")
+        .desc("Number of read requests served by the statistical model");
+
+    statWriteReqs
+        .name(name() + ".statWriteReqs")
+        .desc("Number of write requests served by the statistical model");
+
     readRowHits
         .name(name() + ".readRowHits")
         .desc("Number of row buffer hits during reads");
@@ -2680,13 +3273,19 @@ DRAMCtrl::allRanksDrained() const
 void
 DRAMCtrl::drainResume()
 {
-    if (!isTimingMode && system()->isTimingMode()) {
-        // if we switched to timing mode, kick things into action,
+    // the ranks are only active in the detailed timing mode
+    bool was_detailed = isTimingMode && !statisticalMode;
+    statisticalMode = nextStatisticalMode;
+    bool detailed = system()->isTimingMode() && !statisticalMode;
+
+    if (!was_detailed && detailed) {
+        // if we switched to detailed timing, kick things into action,
         // and behave as if we restored from a checkpoint
         startup();
-    } else if (isTimingMode && !system()->isTimingMode()) {
-        // if we switch from timing mode, stop the refresh events to
-        // not cause issues with KVM
+    } else if (was_detailed && !detailed) {
+        // if we switch from detailed timing, stop the refresh events
+        // to not cause issues with KVM, and to not spend any time on
+        // them in the statistical mode
         for (auto r : ranks) {
             r->suspend();
         }
@@ -2696,6 +3295,132 @@ DRAMCtrl::drainResume()
     isTimingMode = system()->isTimingMode();
 }
 
+void
+DRAMCtrl::setStatisticalMode(bool statistical)
+{
+    DPRINTF(DRAM, "Switching to the %s mode on the next resume\n",
+            statistical ? "statistical" : "detailed");
+    nextStatisticalMode = statistical;
+}
+
+double
+DRAMCtrl::statRowHitRate() const
+{
+    if (calibBursts != 0)
+        return double(calibRowHits) / calibBursts;
+
+    // without calibration, assume closed rows for the close page
+    // policies and an even split otherwise
+    return (pageMgmt == Enums::close || pageMgmt == Enums::close_adaptive) ?
+        0.0 : 0.5;
+}
+
+Tick
+DRAMCtrl::statBurstTicks() const
+{
+    if (calibLoadedBursts == 0)
+        return tBURST;
+
+    return std::max(tBURST, calibLoadedTicks / calibLoadedBursts);
+}
+
+bool
+DRAMCtrl::recvTimingReqStatistical(PacketPtr pkt)
+{
+    unsigned size = pkt->getSize();
+    unsigned offset = pkt->getAddr() & (burstSize - 1);
+    unsigned int bursts = divCeil(offset + size, burstSize);
+    Tick burst_ticks = statBurstTicks();
+
+    // forget about the reads that have their data
+    while (!statReadsInFlight.empty() &&
+           statReadsInFlight.front() <= curTick()) {
+        statReadsInFlight.pop_front();
+    }
+
+    Tick retry_at = MaxTick;
+
+    if (pkt->isRead()) {
+        // bound the reads in flight by the read queue
+        if (statReadsInFlight.size() >= readBufferSize) {
+            retryRdReq = true;
+            numRdRetry++;
+            retry_at = statReadsInFlight.front();
+        } else {
+            // the row is either open, or has to be activated, after
+            // closing another one unless the page policy closes rows
+            Tick cmd_lat = tCL;
+            if (random_mt.random<double>() >= statRowHitRate()) {
+                cmd_lat += tRCD;
+                if (pageMgmt != Enums::close &&
+                    pageMgmt != Enums::close_adaptive)
+                    cmd_lat += tRP;
+            }
+
+            // the bursts wait for the bus, and take it one after the
+            // other
+            Tick ready = std::max(curTick() + cmd_lat, statBusBusyUntil) +
+                bursts * burst_ticks;
+            statBusBusyUntil = ready;
+            statReadsInFlight.push_back(ready);
+
+            DPRINTF(DRAM, "Statistical read of %lld, ready at %lld\n",
+                    pkt->getAddr(), ready);
+
+            readReqs++;
+            bytesReadSys += size;
+            statReadReqs++;
+
+            accessAndRespond(pkt, ready - curTick() + frontendLatency +
+                             backendLatency);
+            return true;
+        }
+    } else {
+        assert(pkt->isWrite());
+
+        // writes are posted, bound the bus backlog by the write queue
+        Tick max_backlog = writeBufferSize * burst_ticks;
+        if (statBusBusyUntil >= curTick() + max_backlog) {
+            retryWrReq = true;
+            numWrRetry++;
+            retry_at = statBusBusyUntil - max_backlog + 1;
+        } else {
+            statBusBusyUntil = std::max(curTick(), statBusBusyUntil) +
+                bursts * burst_ticks;
+
+            DPRINTF(DRAM, "Statistical write of %lld, bus busy until "
+                    "%lld\n", pkt->getAddr(), statBusBusyUntil);
+
+            writeReqs++;
+            bytesWrittenSys += size;
+            statWriteReqs++;
+
+            accessAndRespond(pkt, frontendLatency);
+            return true;
+        }
+    }
+
+    DPRINTF(DRAM, "Statistical model full, retrying at %lld\n", retry_at);
+
+    if (!statRetryEvent.scheduled()) {
+        schedule(statRetryEvent, retry_at);
+    } else if (retry_at < statRetryEvent.when()) {
+        reschedule(statRetryEvent, retry_at);
+    }
+
+    return false;
+}
+
+void
+DRAMCtrl::processStatRetryEvent()
+{
+    if (retryRdReq || retryWrReq) {
+        retryRdReq = false;
+        retryWrReq = false;
+        port.sendRetryReq();
+    }
+}
+
 DRAMCtrl::MemoryPort::MemoryPort(const std::string& name, DRAMCtrl& _memory)
     : QueuedSlavePort(name, &_memory, queue), queue(_memory, *this),
       memory(_memory)
@@ -2730,6 +3455,15 @@ DRAMCtrl::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+Tick
+DRAMCtrl::MemoryPort::recvAtomicBackdoor(PacketPtr pkt,
+                                         MemBackdoorPtr& backdoor)
+{
+    Tick latency = memory.recvAtomic(pkt);
+    memory.getBackdoor(backdoor);
+    return latency;
+}
+
 bool
 DRAMCtrl::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
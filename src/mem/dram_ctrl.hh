@@ -54,6 +54,7 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <list>
 #include <string>
 #include <unordered_set>
 
@@ -63,6 +64,8 @@
 #include "enums/MemSched.hh"
 #include "enums/PageManage.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/dram_addr_map.hh"
+#include "mem/dram_packet_queue.hh"
 #include "mem/qport.hh"
 #include "params/DRAMCtrl.hh"
 #include "sim/eventq.hh"
@@ -114,6 +117,8 @@ class DRAMCtrl : public AbstractMemory
 
         Tick recvAtomic(PacketPtr pkt);
 
+        Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr& backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         bool recvTimingReq(PacketPtr);
@@ -175,7 +180,8 @@ class DRAMCtrl : public AbstractMemory
      * when can it be activated.
      *
      * The bank also keeps track of how many bytes have been accessed
-     * in the open row since it was opened.
+     * in the open row since it was opened, and of the rolling count
+     * of activates used for refresh management.
      */
     class Bank
     {
@@ -194,11 +200,12 @@ class DRAMCtrl : public AbstractMemory
 
         uint32_t rowAccesses;
         uint32_t bytesAccessed;
+        uint32_t raaCount;
 
         Bank() :
             openRow(NO_ROW), bank(0), bankgr(0),
             colAllowedAt(0), preAllowedAt(0), actAllowedAt(0),
-            rowAccesses(0), bytesAccessed(0)
+            rowAccesses(0), bytesAccessed(0), raaCount(0)
         { }
     };
 
@@ -317,6 +324,18 @@ class DRAMCtrl : public AbstractMemory
          */
         Tick refreshDueAt;
 
+        /**
+         * Set of banks targeted by the next same-bank or per-bank
+         * refresh.
+         */
+        uint32_t nextRefreshSet;
+
+        /**
+         * Refresh the next set of banks while the other banks of the
+         * rank remain available.
+         */
+        void refreshBankSet();
+
         /*
          * Command energies
          */
@@ -633,6 +652,9 @@ class DRAMCtrl : public AbstractMemory
 
         const bool isRead;
 
+        /** Requestor, used by the application-aware schedulers */
+        const MasterID masterId;
+
         /** Will be populated by address decoder */
         const uint8_t rank;
         const uint8_t bank;
@@ -667,17 +689,29 @@ class DRAMCtrl : public AbstractMemory
         Bank& bankRef;
         Rank& rankRef;
 
+        /** Order and position in the read or write queue */
+        int64_t queueSeq;
+        std::list<DRAMPacket*>::iterator queuePos;
+
+        /** Part of the current PAR-BS batch */
+        bool marked;
+
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint32_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref, Rank& rank_ref)
             : entryTime(curTick()), readyTime(curTick()),
-              pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
+              pkt(_pkt), isRead(is_read), masterId(_pkt->req->masterId()),
+              rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-              bankRef(bank_ref), rankRef(rank_ref)
+              bankRef(bank_ref), rankRef(rank_ref), queueSeq(0),
+              marked(false)
         { }
 
     };
 
+    /** The read and write queues, indexed by bank and row */
+    typedef ::DRAMPacketQueue<DRAMPacket> DRAMPacketQueue;
+
     /**
      * Bunch of things requires to setup "events" in gem5
      * When event "respondEvent" occurs for example, the method
@@ -690,6 +724,26 @@ class DRAMCtrl : public AbstractMemory
     void processRespondEvent();
     EventWrapper<DRAMCtrl, &DRAMCtrl::processRespondEvent> respondEvent;
 
+    void processStatRetryEvent();
+    EventWrapper<DRAMCtrl, &DRAMCtrl::processStatRetryEvent> statRetryEvent;
+
+    /**
+     * Serve a timing request with the statistical model, drawing a row
+     * hit or miss and queueing the bursts on the model data bus.
+     *
+     * @param pkt The request
+     * @return false if the model has too many requests in flight
+     */
+    bool recvTimingReqStatistical(PacketPtr pkt);
+
+    /**
+     * Row hit rate and bus ticks per burst of the statistical model,
+     * as calibrated by the detailed mode, or estimated from the
+     * timing parameters before any calibration.
+     */
+    double statRowHitRate() const;
+    Tick statBurstTicks() const;
+
     /**
      * Check if the read queue has room for more entries
      *
@@ -785,7 +839,7 @@ class DRAMCtrl : public AbstractMemory
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay);
 
     /**
      * For FR-FCFS policy reorder the read/write queue depending on row buffer
@@ -796,7 +850,7 @@ class DRAMCtrl : public AbstractMemory
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool reorderQueue(DRAMPacketQueue& queue, Tick extra_col_delay);
 
     /**
      * Find which are the earliest banks ready to issue an activate
@@ -808,9 +862,89 @@ class DRAMCtrl : public AbstractMemory
      * @return One-hot encoded mask of bank indices
      * @return boolean indicating burst can issue seamlessly, with no gaps
      */
-    std::pair<uint64_t, bool> minBankPrep(const std::deque<DRAMPacket*>& queue,
+    std::pair<uint64_t, bool> minBankPrep(const DRAMPacketQueue& queue,
                                           Tick min_col_at) const;
 
+    /**
+     * State kept per requestor (MasterID) by the application-aware
+     * schedulers
+     */
+    struct Requestor
+    {
+        /** Rank of a requestor left out of the ranking, the lowest */
+        static const unsigned unranked = 0xffff;
+
+        Requestor()
+            : blacklisted(false), rank(unranked),
+              batchRank{unranked, unranked}, attainedService(0),
+              totalAttainedService(0), bursts(0), rowHits(0), blpSum(0),
+              blpSamples(0), bankMask(0)
+        { }
+
+        /** BLISS: served too many consecutive bursts */
+        bool blacklisted;
+
+        /**
+         * ATLAS and TCM ranking, lower ranks go first. A requestor first
+         * seen during a quantum goes last until the next ranking.
+         */
+        unsigned rank;
+
+        /**
+         * PAR-BS ranking in the current batch of the write (0) and read
+         * (1) queue, as the two queues form their batches separately
+         */
+        unsigned batchRank[2];
+
+        /** ATLAS: service received this quantum, and its history */
+        double attainedService;
+        double totalAttainedService;
+
+        /** TCM: bursts and row hits this quantum */
+        uint64_t bursts;
+        uint64_t rowHits;
+
+        /** TCM: sampled bank-level parallelism */
+        double blpSum;
+        uint64_t blpSamples;
+        uint64_t bankMask;
+    };
+
+    Requestor& requestor(MasterID id);
+
+    /**
+     * For the application-aware policies (BLISS, ATLAS, TCM and
+     * PAR-BS), pick the packet whose requestor has the highest priority,
+     * and move it to the head of the queue. The policies all fall back
+     * to row hits first and then the oldest packet.
+     *
+     * @param queue Queued requests to consider
+     * @return true if a packet is scheduled to a rank which is available else
+     * false
+     */
+    bool chooseNextAppAware(DRAMPacketQueue& queue);
+
+    /**
+     * Priority of a packet under the application-aware policy in use,
+     * higher values are scheduled first.
+     */
+    uint64_t schedPriority(const DRAMPacket* dram_pkt);
+
+    /** Update the per-requestor state when a burst is issued */
+    void schedIssued(const DRAMPacket* dram_pkt, bool row_hit);
+
+    /**
+     * PAR-BS: mark a new batch and rank the requestors in it, leaving
+     * the others unranked
+     */
+    void formBatch(DRAMPacketQueue& queue);
+
+    /** ATLAS and TCM: rank the requestors at the end of a quantum */
+    void endQuantum();
+
+    /** TCM: reorder the bandwidth-sensitive cluster */
+    void shuffleCluster();
+
     /**
      * Keep track of when row activations happen, in order to enforce
      * the maximum number of activations in the activation window. The
@@ -855,8 +989,8 @@ class DRAMCtrl : public AbstractMemory
     /**
      * The controller's main read and write queues
      */
-    std::deque<DRAMPacket*> readQueue;
-    std::deque<DRAMPacket*> writeQueue;
+    DRAMPacketQueue readQueue;
+    DRAMPacketQueue writeQueue;
 
     /**
      * To avoid iterating over the write queue to check for
@@ -934,6 +1068,8 @@ class DRAMCtrl : public AbstractMemory
     const Tick tXAW;
     const Tick tXP;
     const Tick tXS;
+    const Tick tRFCsb;
+    const Tick tRFM;
     const uint32_t activationLimit;
 
     /**
@@ -944,6 +1080,29 @@ class DRAMCtrl : public AbstractMemory
     Enums::AddrMap addrMapping;
     Enums::PageManage pageMgmt;
 
+    /**
+     * Masks of the physical address bits XORed into every channel,
+     * rank, bank group, bank and row bit with the custom address
+     * mapping
+     */
+    const DRAMAddrMap addrMap;
+
+    /**
+     * Refresh granularity. With same-bank and per-bank refresh the
+     * banks are refreshed a set at a time, every tREFIsb, where a set
+     * is bank i of every bank group or a single bank respectively.
+     */
+    Enums::RefreshMode refreshMode;
+    const uint32_t refreshSetSize;
+    const uint32_t refreshSets;
+    const Tick tREFIsb;
+
+    /**
+     * Activates a bank accumulates before a refresh management
+     * command is due, zero if refresh management is disabled.
+     */
+    const uint32_t rfmThreshold;
+
     /**
      * Max column accesses (read and write) per row, before forefully
      * closing it.
@@ -979,6 +1138,39 @@ class DRAMCtrl : public AbstractMemory
      */
     Tick nextReqTime;
 
+    /**
+     * Serve timing requests with the statistical model rather than
+     * scheduling DRAM commands, and the mode to use on resuming from
+     * the next drain.
+     */
+    bool statisticalMode;
+    bool nextStatisticalMode;
+
+    /**
+     * Calibration of the statistical model on the bursts of the
+     * detailed mode: the row hits, and the bus ticks taken by the
+     * bursts issued with more bursts waiting, which accounts for
+     * bank conflicts, turnarounds and refresh.
+     */
+    uint64_t calibBursts;
+    uint64_t calibRowHits;
+    uint64_t calibLoadedBursts;
+    Tick calibLoadedTicks;
+
+    /**
+     * End of the last burst on the bus, which, unlike busBusyUntil, is
+     * not pushed out by the read-to-write and write-to-read turnaround
+     * ahead of the next burst, so that the calibration includes them.
+     */
+    Tick calibLastBurst;
+
+    /**
+     * Till when the data bus of the statistical model is busy, and
+     * the data ready times of its reads in flight, in order.
+     */
+    Tick statBusBusyUntil;
+    std::deque<Tick> statReadsInFlight;
+
     // All statistics that the model needs to capture
     Stats::Scalar readReqs;
     Stats::Scalar writeReqs;
@@ -994,8 +1186,20 @@ class DRAMCtrl : public AbstractMemory
     Stats::Scalar neitherReadNorWrite;
     Stats::Vector perBankRdBursts;
     Stats::Vector perBankWrBursts;
+    Stats::Vector perMasterRdBursts;
+    Stats::Vector perMasterWrBursts;
+    Stats::Formula perMasterRdBW;
+    Stats::Formula perMasterWrBW;
+    Stats::Vector perMasterRdLat;
+    Stats::Vector perMasterRdSchedLat;
+    Stats::Formula perMasterAvgRdLat;
+    Stats::Formula perMasterSlowdown;
     Stats::Scalar numRdRetry;
     Stats::Scalar numWrRetry;
+    Stats::Scalar bankSetRefreshes;
+    Stats::Scalar refreshMgmtCmds;
+    Stats::Scalar statReadReqs;
+    Stats::Scalar statWriteReqs;
     Stats::Scalar totGap;
     Stats::Vector readPktSize;
     Stats::Vector writePktSize;
@@ -1051,6 +1255,30 @@ class DRAMCtrl : public AbstractMemory
      */
     std::unique_ptr<Packet> pendingDelete;
 
+    /**
+     * Application-aware scheduling, see chooseNextAppAware
+     */
+    std::vector<Requestor> requestors;
+
+    const unsigned blacklistThreshold;
+    const Tick blacklistClearInterval;
+    Tick nextBlacklistClear;
+    MasterID lastRequestor;
+    unsigned requestorStreak;
+
+    const unsigned markingCap;
+
+    const Tick schedQuantum;
+    Tick nextQuantum;
+    const double atlasHistoryWeight;
+    const Tick starvationThreshold;
+
+    const double clusterThreshold;
+    const Tick shuffleInterval;
+    Tick nextShuffle;
+    std::vector<MasterID> bandwidthCluster;
+    unsigned latencyClusterSize;
+
     /**
      * This function increments the energy when called. If stats are
      * dumped periodically, note accumulated energy values will
@@ -1088,6 +1316,14 @@ class DRAMCtrl : public AbstractMemory
     virtual void startup() override;
     virtual void drainResume() override;
 
+    /**
+     * Choose between the detailed and statistical modes, the switch
+     * taking effect when resuming from the next drain.
+     *
+     * @param statistical true to use the statistical model
+     */
+    void setStatisticalMode(bool statistical);
+
     /**
      * Return true once refresh is complete for all ranks and there are no
      * additional commands enqueued.  (only evaluated when draining)
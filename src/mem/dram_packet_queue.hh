@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * DRAMPacketQueue declaration
+ */
+
+#ifndef __MEM_DRAM_PACKET_QUEUE_HH__
+#define __MEM_DRAM_PACKET_QUEUE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A read or write queue of a DRAM controller. The packets are kept in
+ * arrival order, and are also indexed by bank, and by row within each
+ * bank, so that the scheduler can find the queued banks and the row
+ * hits without walking the whole queue.
+ *
+ * The queue behaves as the std::deque it replaces: packets are added
+ * at the back, the scheduler moves the packet it picks to the front,
+ * and packets are only ever taken from the front. A packet moved to
+ * the front is also the oldest of its row and bank from then on.
+ *
+ * The queued type needs the bankId and row of the packet, and a
+ * queueSeq and queuePos that are owned by the queue.
+ */
+template <class Entry>
+class DRAMPacketQueue
+{
+  public:
+    typedef typename std::list<Entry*>::const_iterator const_iterator;
+
+    DRAMPacketQueue(unsigned num_banks)
+        : banks(num_banks), nextSeq(0), frontSeq(0)
+    { }
+
+    size_t size() const { return packets.size(); }
+    bool empty() const { return packets.empty(); }
+    Entry* front() const { return packets.front(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    void
+    push_back(Entry* entry)
+    {
+        entry->queueSeq = nextSeq++;
+        entry->queuePos = packets.insert(packets.end(), entry);
+
+        BankQueue& bank = banks[entry->bankId];
+        bank.rows[entry->row].push_back(entry);
+        ++bank.entries;
+    }
+
+    void
+    pop_front()
+    {
+        Entry* entry = packets.front();
+        packets.pop_front();
+
+        BankQueue& bank = banks[entry->bankId];
+        auto row = bank.rows.find(entry->row);
+        assert(row != bank.rows.end() && row->second.front() == entry);
+        row->second.pop_front();
+        if (row->second.empty())
+            bank.rows.erase(row);
+        --bank.entries;
+    }
+
+    /** Make a queued packet the next one to be issued */
+    void
+    moveToFront(Entry* entry)
+    {
+        packets.splice(packets.begin(), packets, entry->queuePos);
+
+        // the schedulers may pick any packet, not only the oldest of
+        // its row, and the rows are kept in queue order
+        std::deque<Entry*>& row = banks[entry->bankId].rows[entry->row];
+        if (row.front() != entry) {
+            row.erase(std::find(row.begin(), row.end(), entry));
+            row.push_front(entry);
+        }
+        entry->queueSeq = --frontSeq;
+    }
+
+    /** Number of queued packets for a bank, and for a row of it */
+    unsigned bankEntries(uint16_t bank_id) const
+    { return banks[bank_id].entries; }
+
+    unsigned
+    rowEntries(uint16_t bank_id, uint32_t row) const
+    {
+        const BankQueue& bank = banks[bank_id];
+        auto r = bank.rows.find(row);
+        return r == bank.rows.end() ? 0 : r->second.size();
+    }
+
+    /** Oldest queued packet for a row of a bank, or NULL */
+    Entry*
+    oldestInRow(uint16_t bank_id, uint32_t row) const
+    {
+        const BankQueue& bank = banks[bank_id];
+        auto r = bank.rows.find(row);
+        return r == bank.rows.end() ? NULL : r->second.front();
+    }
+
+    /** Oldest queued packet for a bank that misses a row, or NULL */
+    Entry*
+    oldestNotInRow(uint16_t bank_id, uint32_t row) const
+    {
+        Entry* oldest = NULL;
+        for (const auto& r : banks[bank_id].rows) {
+            if (r.first != row && (oldest == NULL ||
+                                   r.second.front()->queueSeq <
+                                   oldest->queueSeq))
+                oldest = r.second.front();
+        }
+        return oldest;
+    }
+
+  private:
+    struct BankQueue
+    {
+        BankQueue() : entries(0) { }
+
+        unsigned entries;
+        std::unordered_map<uint32_t, std::deque<Entry*>> rows;
+    };
+
+    std::list<Entry*> packets;
+    std::vector<BankQueue> banks;
+
+    /**
+     * Queue order of the packets, counting up at the back and down at
+     * the front, so that a lower sequence number is closer to the front
+     */
+    int64_t nextSeq;
+    int64_t frontSeq;
+};
+
+#endif //__MEM_DRAM_PACKET_QUEUE_HH__
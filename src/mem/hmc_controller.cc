@@ -84,6 +84,10 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     const bool expect_response = pkt->needsResponse() &&
         !pkt->cacheResponding();
 
+    // remember where to route the response to
+    if (expect_response)
+        pushRoute(pkt, slave_port_id);
+
     // since it is a normal request, attempt to send the packet
     bool success = masterPorts[master_port_id]->sendTimingReq(pkt);
 
@@ -94,6 +98,10 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         // restore the header delay as it is additive
         pkt->headerDelay = old_header_delay;
 
+        // the request will be presented again
+        if (expect_response)
+            popRoute(pkt);
+
         // occupy until the header is sent
         reqLayers[master_port_id]->failedTiming(src_port,
                                                 clockEdge(Cycles(1)));
@@ -101,12 +109,6 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         return false;
     }
 
-    // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = slave_port_id;
-    }
-
     reqLayers[master_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
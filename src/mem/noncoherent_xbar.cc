@@ -145,6 +145,10 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     const bool expect_response = pkt->needsResponse() &&
         !pkt->cacheResponding();
 
+    // remember where to route the response to
+    if (expect_response)
+        pushRoute(pkt, slave_port_id);
+
     // since it is a normal request, attempt to send the packet
     bool success = masterPorts[master_port_id]->sendTimingReq(pkt);
 
@@ -155,6 +159,10 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         // restore the header delay as it is additive
         pkt->headerDelay = old_header_delay;
 
+        // the request will be presented again
+        if (expect_response)
+            popRoute(pkt);
+
         // occupy until the header is sent
         reqLayers[master_port_id]->failedTiming(src_port,
                                                 clockEdge(Cycles(1)));
@@ -162,12 +170,6 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         return false;
     }
 
-    // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = slave_port_id;
-    }
-
     reqLayers[master_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -185,9 +187,7 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     MasterPort *src_port = masterPorts[master_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID slave_port_id = route_lookup->second;
+    const PortID slave_port_id = getRoute(pkt).port;
     assert(slave_port_id != InvalidPortID);
     assert(slave_port_id < respLayers.size());
 
@@ -216,15 +216,15 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     // determine how long to be crossbar layer is busy
     Tick packetFinishTime = clockEdge(Cycles(1)) + pkt->payloadDelay;
 
+    // the response is routed, so take back the route state
+    popRoute(pkt);
+
     // send the packet through the destination slave port, and pay for
     // any outstanding latency
     Tick latency = pkt->headerDelay;
     pkt->headerDelay = 0;
     slavePorts[slave_port_id]->schedTimingResp(pkt, curTick() + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     respLayers[slave_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -245,7 +245,8 @@ NoncoherentXBar::recvReqRetry(PortID master_port_id)
 }
 
 Tick
-NoncoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
+NoncoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id,
+                            MemBackdoorPtr* backdoor)
 {
     DPRINTF(NoncoherentXBar, "recvAtomic: packet src %s addr 0x%x cmd %s\n",
             slavePorts[slave_port_id]->name(), pkt->getAddr(),
@@ -262,8 +263,12 @@ NoncoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
     pktSize[slave_port_id][master_port_id] += pkt_size;
     transDist[pkt_cmd]++;
 
-    // forward the request to the appropriate destination
-    Tick response_latency = masterPorts[master_port_id]->sendAtomic(pkt);
+    // forward the request to the appropriate destination, along with
+    // any request for a backdoor
+    MasterPort* master_port = masterPorts[master_port_id];
+    Tick response_latency = backdoor ?
+        master_port->sendAtomicBackdoor(pkt, *backdoor) :
+        master_port->sendAtomic(pkt);
 
     // add the response data
     if (pkt->isResponse()) {
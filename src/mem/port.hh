@@ -51,6 +51,7 @@
 #define __MEM_PORT_HH__
 
 #include "base/addr_range.hh"
+#include "mem/backdoor.hh"
 #include "mem/packet.hh"
 
 class MemObject;
@@ -201,6 +202,18 @@ class MasterPort : public BaseMasterPort
      */
     Tick sendAtomic(PacketPtr pkt);
 
+    /**
+     * Send an atomic request packet like sendAtomic, and also ask for
+     * a backdoor to the memory that serves it, to do the following
+     * accesses to that memory without sending any packets.
+     *
+     * @param pkt Packet to send.
+     * @param backdoor Set to a backdoor if one is granted.
+     *
+     * @return Estimated latency of access.
+     */
+    Tick sendAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr& backdoor);
+
     /**
      * Send a functional request packet, where the data is instantly
      * updated everywhere in the memory system, without affecting the
@@ -441,6 +454,15 @@ class SlavePort : public BaseSlavePort
      */
     virtual Tick recvAtomic(PacketPtr pkt) = 0;
 
+    /**
+     * Receive an atomic request packet from the master port, and
+     * grant a backdoor if possible. By default no backdoor is granted.
+     */
+    virtual Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr& backdoor)
+    {
+        return recvAtomic(pkt);
+    }
+
     /**
      * Receive a functional request packet from the master port.
      */
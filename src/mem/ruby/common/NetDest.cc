@@ -30,6 +30,8 @@
 
 #include <algorithm>
 
+std::vector<NodeID> NetDest::s_type_base;
+
 NetDest::NetDest()
 {
   resize();
@@ -38,16 +40,15 @@ NetDest::NetDest()
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    setBit(bitIndex(newElement));
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
+    assert(m_size == netDest.getSize());
     for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
+        m_bits[i] |= netDest.m_bits[i];
     }
 }
 
@@ -57,47 +58,73 @@ NetDest::setNetDest(MachineType machine, const Set& set)
     // assure that there is only one set of destinations for this machine
     assert(MachineType_base_level((MachineType)(machine + 1)) -
            MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    NodeID base = s_type_base[machine];
+    NodeID count = s_type_base[machine + 1] - base;
+    assert(set.nextElement(count) == NUMBER_BITS_PER_SET);
+
+    clearRange(base, base + count);
+    for (NodeID j = set.nextElement(0); j < count;
+         j = set.nextElement(j + 1)) {
+        setBit(base + j);
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    clearBit(bitIndex(oldElement));
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
+    assert(m_size == netDest.getSize());
     for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
+        m_bits[i] &= ~netDest.m_bits[i];
     }
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    std::fill(m_bits.begin(), m_bits.end(), 0);
 }
 
 void
 NetDest::broadcast()
 {
-    for (MachineType machine = MachineType_FIRST;
-         machine < MachineType_NUM; ++machine) {
-        broadcast(machine);
-    }
+    setRange(0, m_size);
 }
 
 void
 NetDest::broadcast(MachineType machineType)
 {
-    for (NodeID i = 0; i < MachineType_base_count(machineType); i++) {
-        MachineID mach = {machineType, i};
-        add(mach);
+    setRange(s_type_base[machineType], s_type_base[machineType + 1]);
+}
+
+void
+NetDest::setRange(NodeID lo, NodeID hi)
+{
+    for (NodeID i = lo; i < hi; i++) {
+        if (i % BITS_PER_WORD == 0 && i + BITS_PER_WORD <= hi) {
+            m_bits[i / BITS_PER_WORD] = ~ULL(0);
+            i += BITS_PER_WORD - 1;
+        } else {
+            setBit(i);
+        }
+    }
+}
+
+void
+NetDest::clearRange(NodeID lo, NodeID hi)
+{
+    for (NodeID i = lo; i < hi; i++) {
+        if (i % BITS_PER_WORD == 0 && i + BITS_PER_WORD <= hi) {
+            m_bits[i / BITS_PER_WORD] = 0;
+            i += BITS_PER_WORD - 1;
+        } else {
+            clearBit(i);
+        }
     }
 }
 
@@ -106,24 +133,48 @@ std::vector<NodeID>
 NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
-    dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
-        }
+    for (NodeID n = nextElement(0); n < m_size; n = nextElement(n + 1)) {
+        dest.push_back(n);
     }
     return dest;
 }
 
+NodeID
+NetDest::nextElement(NodeID node) const
+{
+    if (node >= m_size) {
+        return m_size;
+    }
+    int i = node / BITS_PER_WORD;
+    uint64_t word = m_bits[i] & ~mask(node % BITS_PER_WORD);
+    while (word == 0) {
+        if (++i == m_bits.size()) {
+            return m_size;
+        }
+        word = m_bits[i];
+    }
+    return i * BITS_PER_WORD + findLsbSet(word);
+}
+
+MachineID
+NetDest::nodeToMachineID(NodeID node)
+{
+    assert(node < s_type_base.back());
+    // The first type whose base is beyond node is the one after the type
+    // of node. Types without machines share their base with the next one,
+    // so upper_bound skips them.
+    auto it = std::upper_bound(s_type_base.begin(), s_type_base.end(), node);
+    int type = (it - s_type_base.begin()) - 1;
+    MachineID mach = {(MachineType)type, node - s_type_base[type]};
+    return mach;
+}
+
 int
 NetDest::count() const
 {
     int counter = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
+        counter += popCount(m_bits[i]);
     }
     return counter;
 }
@@ -131,20 +182,16 @@ NetDest::count() const
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return testBit(bitIndex(index));
 }
 
 MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
-        }
+    NodeID n = nextElement(0);
+    if (n < m_size) {
+        return nodeToMachineID(n);
     }
     panic("No smallest element of an empty set.");
 }
@@ -152,12 +199,10 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    NodeID n = nextElement(s_type_base[machine]);
+    if (n < s_type_base[machine + 1]) {
+        MachineID mach = {machine, n - s_type_base[machine]};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -167,35 +212,27 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
-            return false;
-        }
-    }
-    return true;
+    return count() == m_size;
 }
 
 // Returns true iff no bits are set
 bool
 NetDest::isEmpty() const
 {
+    uint64_t r = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
-            return false;
-        }
+        r |= m_bits[i];
     }
-    return true;
+    return r == 0;
 }
 
 // returns the logical OR of "this" set and orNetDest
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
-    NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
-    }
+    assert(m_size == orNetDest.getSize());
+    NetDest result(*this);
+    result.addNetDest(orNetDest);
     return result;
 }
 
@@ -203,10 +240,10 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
-    NetDest result;
+    assert(m_size == andNetDest.getSize());
+    NetDest result(*this);
     for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
+        result.m_bits[i] &= andNetDest.m_bits[i];
     }
     return result;
 }
@@ -215,53 +252,63 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
+    assert(m_size == other_netDest.getSize());
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
+        if (m_bits[i] & other_netDest.m_bits[i]) {
             return true;
         }
     }
     return false;
 }
 
+bool
+NetDest::intersectionIsEmpty(const NetDest& other_netDest) const
+{
+    return !intersectionIsNotEmpty(other_netDest);
+}
+
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
+    assert(m_size == test.getSize());
 
+    uint64_t r = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
-            return false;
-        }
+        r |= test.m_bits[i] & ~m_bits[i];
     }
-    return true;
+    return r == 0;
 }
 
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
+    return testBit(bitIndex(element));
 }
 
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
+    int total = MachineType_base_number(MachineType_NUM);
+    if (s_type_base.size() != MachineType_NUM + 1 ||
+        s_type_base.back() != total) {
+        s_type_base.resize(MachineType_NUM + 1);
+        for (int i = 0; i <= MachineType_NUM; i++) {
+            s_type_base[i] = MachineType_base_number((MachineType)i);
+        }
     }
+
+    m_size = total;
+    m_bits.assign((total + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (int i = 0; i < MachineType_NUM; i++) {
+        for (NodeID j = s_type_base[i]; j < s_type_base[i + 1]; j++) {
+            out << testBit(j) << " ";
         }
         out << " - ";
     }
@@ -271,10 +318,6 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
-    }
-    return true;
+    assert(m_size == n.m_size);
+    return m_bits == n.m_bits;
 }
@@ -29,6 +29,7 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -36,6 +37,13 @@
 #include "mem/ruby/common/MachineID.hh"
 
 // NetDest specifies the network destination of a Message
+//
+// The destinations are kept in one flat bit vector of 64-bit words,
+// indexed by the network node number of a machine, i.e.
+// MachineType_base_number(type) + num. The set operations are thus
+// word-wide loops over a few words independent of the number of machine
+// types, and the members can be visited with nextElement() instead of
+// testing every bit.
 class NetDest
 {
   public:
@@ -81,11 +89,22 @@ class NetDest
     // For Princeton Network
     std::vector<NodeID> getAllDest();
 
+    // Returns the smallest network node number in the set that is not
+    // smaller than node, or getSize() if there is none. The members are
+    // visited in order with:
+    // for (NodeID n = d.nextElement(0); n < d.getSize();
+    //      n = d.nextElement(n + 1))
+    NodeID nextElement(NodeID node) const;
+
+    // Translates a network node number to the machine it belongs to
+    static MachineID nodeToMachineID(NodeID node);
+
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    // Number of network nodes, i.e. destination bits
+    int getSize() const { return m_size; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -93,19 +112,41 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
-    // returns a value >= MachineType_base_level("this machine")
-    // and < MachineType_base_level("next highest machine")
-    int
-    vecIndex(MachineID m) const
+    static const int BITS_PER_WORD = 64;
+
+    // returns the network node number of a machine, which is the index
+    // of its bit in m_bits
+    NodeID
+    bitIndex(MachineID m) const
     {
-        int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
-        return vec_index;
+        NodeID index = s_type_base[m.type] + m.num;
+        assert(m.num < s_type_base[m.type + 1] - s_type_base[m.type]);
+        return index;
     }
 
-    NodeID bitIndex(NodeID index) const { return index; }
+    void setBit(NodeID index)
+    { m_bits[index / BITS_PER_WORD] |= ULL(1) << (index % BITS_PER_WORD); }
+    void clearBit(NodeID index)
+    { m_bits[index / BITS_PER_WORD] &= ~(ULL(1) << (index % BITS_PER_WORD)); }
+    bool
+    testBit(NodeID index) const
+    {
+        return (m_bits[index / BITS_PER_WORD] >>
+                (index % BITS_PER_WORD)) & 1;
+    }
+
+    // Sets or clears the bits [lo, hi)
+    void setRange(NodeID lo, NodeID hi);
+    void clearRange(NodeID lo, NodeID hi);
+
+    // Network node number of the first machine of every type, with the
+    // total number of nodes as the last entry. The machine counts only
+    // change while the controllers are being constructed, and resize()
+    // brings the table up to date.
+    static std::vector<NodeID> s_type_base;
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    int m_size;                   // number of valid bits
+    std::vector<uint64_t> m_bits; // the bits, BITS_PER_WORD per word
 };
 
 inline std::ostream&
@@ -32,48 +32,74 @@
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
-#include <bitset>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 
+#include "base/bitfield.hh"
 #include "base/misc.hh"
+#include "base/types.hh"
+#include "config/number_bits_per_set.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
-// Change for systems with more than 64 controllers of a particular type.
-const int NUMBER_BITS_PER_SET = 64;
+// NUMBER_BITS_PER_SET is a build option (64 by default), to be raised
+// for systems with more than 64 controllers of a particular type.
+const int BITS_PER_SET_WORD = 64;
+const int NUMBER_WORDS_PER_SET = NUMBER_BITS_PER_SET / BITS_PER_SET_WORD;
 
+static_assert(NUMBER_BITS_PER_SET > 0 &&
+              NUMBER_BITS_PER_SET % BITS_PER_SET_WORD == 0,
+              "NUMBER_BITS_PER_SET must be a multiple of 64");
+
+// The bits are kept in a fixed size array of 64-bit words, so that the
+// set operations are short loops of a constant trip count that the
+// compiler unrolls and vectorizes.
 class Set
 {
   private:
     // Number of bits in use in this set.
     int m_nSize;
-    std::bitset<NUMBER_BITS_PER_SET> bits;
+    uint64_t m_words[NUMBER_WORDS_PER_SET];
+
+    static int wordIndex(NodeID index) { return index / BITS_PER_SET_WORD; }
+    static uint64_t
+    bitMask(NodeID index)
+    {
+        return ULL(1) << (index % BITS_PER_SET_WORD);
+    }
 
   public:
-    Set() : m_nSize(0) {}
+    Set() : m_nSize(0) { clear(); }
 
     Set(int size) : m_nSize(size)
     {
         if (size > NUMBER_BITS_PER_SET)
             fatal("Number of bits(%d) < size specified(%d). "
-                  "Increase the number of bits and recompile.\n",
+                  "Increase NUMBER_BITS_PER_SET and recompile.\n",
                   NUMBER_BITS_PER_SET, size);
+        clear();
     }
 
-    Set(const Set& obj) : m_nSize(obj.m_nSize), bits(obj.bits) {}
+    Set(const Set& obj) : m_nSize(obj.m_nSize)
+    {
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            m_words[i] = obj.m_words[i];
+    }
     ~Set() {}
 
     Set& operator=(const Set& obj)
     {
         m_nSize = obj.m_nSize;
-        bits = obj.bits;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            m_words[i] = obj.m_words[i];
         return *this;
     }
 
     void
     add(NodeID index)
     {
-        bits.set(index);
+        assert(index < NUMBER_BITS_PER_SET);
+        m_words[wordIndex(index)] |= bitMask(index);
     }
 
     /*
@@ -84,7 +110,8 @@ class Set
     addSet(const Set& obj)
     {
         assert(m_nSize == obj.m_nSize);
-        bits |= obj.bits;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            m_words[i] |= obj.m_words[i];
     }
 
     /*
@@ -93,7 +120,8 @@ class Set
     void
     remove(NodeID index)
     {
-        bits.reset(index);
+        assert(index < NUMBER_BITS_PER_SET);
+        m_words[wordIndex(index)] &= ~bitMask(index);
     }
 
     /*
@@ -103,26 +131,45 @@ class Set
     removeSet(const Set& obj)
     {
         assert(m_nSize == obj.m_nSize);
-        bits &= (~obj.bits);
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            m_words[i] &= ~obj.m_words[i];
     }
 
-    void clear() { bits.reset(); }
+    void
+    clear()
+    {
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            m_words[i] = 0;
+    }
 
     /*
      * this function sets all bits in the set
      */
     void broadcast()
     {
-        bits.set();
-        for (int j = m_nSize; j < NUMBER_BITS_PER_SET; ++j) {
-            bits.reset(j);
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i) {
+            int lo = i * BITS_PER_SET_WORD;
+            if (m_nSize >= lo + BITS_PER_SET_WORD) {
+                m_words[i] = ~ULL(0);
+            } else if (m_nSize > lo) {
+                m_words[i] = mask(m_nSize - lo);
+            } else {
+                m_words[i] = 0;
+            }
         }
     }
 
     /*
      * This function returns the population count of 1's in the set
      */
-    int count() const { return bits.count(); }
+    int
+    count() const
+    {
+        int cnt = 0;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            cnt += popCount(m_words[i]);
+        return cnt;
+    }
 
     /*
      * This function checks for set equality
@@ -131,7 +178,10 @@ class Set
     isEqual(const Set& obj) const
     {
         assert(m_nSize == obj.m_nSize);
-        return bits == obj.bits;
+        uint64_t diff = 0;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            diff |= m_words[i] ^ obj.m_words[i];
+        return diff == 0;
     }
 
     // return the logical OR of this set and orSet
@@ -140,7 +190,8 @@ class Set
     {
         assert(m_nSize == obj.m_nSize);
         Set r(m_nSize);
-        r.bits = bits | obj.bits;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            r.m_words[i] = m_words[i] | obj.m_words[i];
         return r;
     };
 
@@ -150,7 +201,8 @@ class Set
     {
         assert(m_nSize == obj.m_nSize);
         Set r(m_nSize);
-        r.bits = bits & obj.bits;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            r.m_words[i] = m_words[i] & obj.m_words[i];
         return r;
     }
 
@@ -158,8 +210,10 @@ class Set
     bool
     intersectionIsEmpty(const Set& obj) const
     {
-        std::bitset<NUMBER_BITS_PER_SET> r = bits & obj.bits;
-        return r.none();
+        uint64_t r = 0;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            r |= m_words[i] & obj.m_words[i];
+        return r == 0;
     }
 
     /*
@@ -170,13 +224,20 @@ class Set
     isSuperset(const Set& test) const
     {
         assert(m_nSize == test.m_nSize);
-        std::bitset<NUMBER_BITS_PER_SET> r = bits | test.bits;
-        return (r == bits);
+        uint64_t r = 0;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            r |= test.m_words[i] & ~m_words[i];
+        return r == 0;
     }
 
     bool isSubset(const Set& test) const { return test.isSuperset(*this); }
 
-    bool isElement(NodeID element) const { return bits.test(element); }
+    bool
+    isElement(NodeID element) const
+    {
+        assert(element < NUMBER_BITS_PER_SET);
+        return (m_words[wordIndex(element)] & bitMask(element)) != 0;
+    }
 
     /*
      * this function returns true iff all bits in use are set
@@ -184,22 +245,55 @@ class Set
     bool
     isBroadcast() const
     {
-        return (bits.count() == m_nSize);
+        return (count() == m_nSize);
     }
 
-    bool isEmpty() const { return bits.none(); }
+    bool
+    isEmpty() const
+    {
+        uint64_t r = 0;
+        for (int i = 0; i < NUMBER_WORDS_PER_SET; ++i)
+            r |= m_words[i];
+        return r == 0;
+    }
 
     NodeID smallestElement() const
     {
-        for (int i = 0; i < m_nSize; ++i) {
-            if (bits.test(i)) {
-                return i;
-            }
+        NodeID element = nextElement(0);
+        if (element < m_nSize) {
+            return element;
         }
         panic("No smallest element of an empty set.");
     }
 
-    bool elementAt(int index) const { return bits[index]; }
+    /*
+     * Returns the smallest element that is not smaller than index, or
+     * NUMBER_BITS_PER_SET if there is none. Together with isElement()
+     * this iterates over the members of a set a word at a time:
+     * for (NodeID i = s.nextElement(0); i < s.getSize();
+     *      i = s.nextElement(i + 1))
+     */
+    NodeID
+    nextElement(NodeID index) const
+    {
+        if (index >= NUMBER_BITS_PER_SET) {
+            return NUMBER_BITS_PER_SET;
+        }
+        int i = wordIndex(index);
+        uint64_t word = m_words[i] & ~mask(index % BITS_PER_SET_WORD);
+        while (word == 0) {
+            if (++i == NUMBER_WORDS_PER_SET) {
+                return NUMBER_BITS_PER_SET;
+            }
+            word = m_words[i];
+        }
+        return i * BITS_PER_SET_WORD + findLsbSet(word);
+    }
+
+    bool elementAt(int index) const { return isElement(index); }
+
+    //! Raw access to the bits in use, for NetDest
+    uint64_t getWord(int index) const { return m_words[index]; }
 
     int getSize() const { return m_nSize; }
 
@@ -208,15 +302,19 @@ class Set
     {
         if (size > NUMBER_BITS_PER_SET)
             fatal("Number of bits(%d) < size specified(%d). "
-                  "Increase the number of bits and recompile.\n",
+                  "Increase NUMBER_BITS_PER_SET and recompile.\n",
                   NUMBER_BITS_PER_SET, size);
         m_nSize = size;
-        bits.reset();
+        clear();
     }
 
     void print(std::ostream& out) const
     {
-        out << "[Set (" << m_nSize << "): " << bits << "]";
+        out << "[Set (" << m_nSize << "): ";
+        for (int i = m_nSize - 1; i >= 0; --i) {
+            out << (isElement(i) ? '1' : '0');
+        }
+        out << "]";
     }
 };
 
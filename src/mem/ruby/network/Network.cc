@@ -49,7 +49,8 @@ Network::Network(const Params *p)
     assert(m_virtual_networks != 0);
 
     m_topology_ptr = new Topology(p->routers.size(), p->ext_links,
-                                  p->int_links);
+                                  p->int_links, p->route_algorithm,
+                                  p->route_threads);
 
     // Allocate to and from queues
     // Queues that are getting messages from protocol
@@ -106,6 +107,14 @@ Network::init()
     m_data_msg_size = RubySystem::getBlockSizeBytes() + m_control_msg_size;
 }
 
+void
+Network::initGeneratedParams(SimObjectParams *p,
+                             const std::string &obj_name) const
+{
+    p->name = name() + "." + obj_name;
+    p->eventq_index = params()->eventq_index;
+}
+
 uint32_t
 Network::MessageSizeType_to_int(MessageSizeType size_type)
 {
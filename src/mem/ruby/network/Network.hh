@@ -89,6 +89,14 @@ class Network : public ClockedObject
                                   PortDirection src_outport,
                                   PortDirection dst_inport) = 0;
 
+    // Creates the internal link from router src to router dst of a
+    // topology generated in C++ (see Topology::generateLinks). The
+    // network owns the link.
+    virtual BasicIntLink *makeGeneratedLink(int link_id, SwitchID src,
+                                            SwitchID dst, Cycles latency,
+                                            int weight)
+    { fatal("%s does not support generated topologies\n", name()); }
+
     virtual void collateStats() = 0;
     virtual void print(std::ostream& out) const = 0;
 
@@ -107,6 +115,12 @@ class Network : public ClockedObject
     Network(const Network& obj);
     Network& operator=(const Network& obj);
 
+    // Name an object that the network instantiates itself instead of
+    // receiving it from the Python configuration, and put it on the
+    // event queue of the network
+    void initGeneratedParams(SimObjectParams *p,
+                             const std::string &obj_name) const;
+
     uint32_t m_nodes;
     static uint32_t m_virtual_networks;
     std::vector<std::string> m_vnet_type_names;
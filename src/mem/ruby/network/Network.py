@@ -31,6 +31,18 @@ from m5.params import *
 from ClockedObject import ClockedObject
 from BasicLink import BasicLink
 
+# Algorithm used by Topology to compute the routing tables: an all-pairs
+# shortest path over dense matrices, or one Dijkstra per destination
+# over the sparse link graph, which scales to much larger networks and
+# builds identical tables
+class TopologyRouteAlgorithm(Enum): vals = ['all_pairs', 'per_destination']
+
+# Topologies whose internal links Topology can generate in C++, so that
+# large networks do not need one Python SimObject per link. The routers
+# and the external links are still created by the topology file.
+class TopologyGenerator(Enum): vals = ['none', 'torus3d', 'fat_tree',
+                                      'flattened_butterfly', 'dragonfly']
+
 class RubyNetwork(ClockedObject):
     type = 'RubyNetwork'
     cxx_class = 'Network'
@@ -45,6 +57,21 @@ class RubyNetwork(ClockedObject):
            "the number of virtual networks should be one more than the "
            "highest numbered vnet in use.")
     control_msg_size = Param.Int(8, "")
+    route_algorithm = Param.TopologyRouteAlgorithm('all_pairs',
+        "Algorithm used to compute the routing tables")
+    route_threads = Param.Unsigned(1, "Number of host threads used to "
+        "compute per_destination routes")
+    topology_generator = Param.TopologyGenerator('none',
+        "Generate the internal links in C++ instead of using int_links")
+    generator_dims = VectorParam.Unsigned([], "Shape of the generated "
+        "topology: torus3d [x, y, z], fat_tree [k, n] (k-ary n-tree), "
+        "flattened_butterfly [k0, k1, ...], dragonfly [a, h, g] (routers "
+        "per group, global links per router, groups)")
+    generator_link_latency = Param.Cycles(1, "Latency of the generated links")
+    generator_global_latency = Param.Cycles(1, "Latency of the generated "
+        "dragonfly global links")
+    generator_bandwidth_factor = Param.Int(16, "Bandwidth factor of the "
+        "generated links (see BasicLink), only used by the simple network")
     ruby_system = Param.RubySystem("")
 
     routers = VectorParam.BasicRouter("Network routers")
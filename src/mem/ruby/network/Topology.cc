@@ -28,8 +28,13 @@
 
 #include "mem/ruby/network/Topology.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <queue>
+#include <thread>
 
+#include "base/cprintf.hh"
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/common/NetDest.hh"
@@ -50,8 +55,12 @@ const int INFINITE_LATENCY = 10000; // Yes, this is a big hack
 
 Topology::Topology(uint32_t num_routers,
                    const vector<BasicExtLink *> &ext_links,
-                   const vector<BasicIntLink *> &int_links)
+                   const vector<BasicIntLink *> &int_links,
+                   Enums::TopologyRouteAlgorithm route_algorithm,
+                   unsigned route_threads)
     : m_nodes(ext_links.size()), m_number_of_switches(num_routers),
+      m_route_algorithm(route_algorithm),
+      m_route_threads(max(route_threads, 1U)),
       m_ext_link_vector(ext_links), m_int_link_vector(int_links)
 {
     // Total nodes/controllers in network
@@ -107,6 +116,9 @@ Topology::Topology(uint32_t num_routers,
 void
 Topology::createLinks(Network *net)
 {
+    if (net->params()->topology_generator != Enums::none)
+        generateLinks(net);
+
     // Find maximum switchID
     SwitchID max_switch_id = 0;
     for (LinkMap::const_iterator i = m_link_map.begin();
@@ -116,8 +128,13 @@ Topology::createLinks(Network *net)
         max_switch_id = max(max_switch_id, src_dest.second);
     }
 
-    // Initialize weight, latency, and inter switched vectors
     int num_switches = max_switch_id+1;
+    if (m_route_algorithm == Enums::per_destination) {
+        createLinksPerDestination(net, num_switches);
+        return;
+    }
+
+    // Initialize weight, latency, and inter switched vectors
     Matrix topology_weights(num_switches,
             vector<int>(num_switches, INFINITE_LATENCY));
     Matrix component_latencies(num_switches,
@@ -157,6 +174,101 @@ Topology::createLinks(Network *net)
     }
 }
 
+void
+Topology::createLinksPerDestination(Network *net, int num_switches)
+{
+    // Sparse reverse adjacency: the incoming links of every switch as
+    // (source, weight) pairs
+    vector<vector<pair<int, int>>> in_edges(num_switches);
+    for (LinkMap::const_iterator i = m_link_map.begin();
+         i != m_link_map.end(); ++i) {
+        in_edges[i->first.second].push_back(
+            make_pair(i->first.first, i->second.link->m_weight));
+    }
+
+    // One single-destination shortest path search per node. The
+    // searches are independent, so they are spread over the threads.
+    int max_machines = MachineType_base_number(MachineType_NUM);
+    vector<vector<int>> dist_to(max_machines);
+    auto worker = [&](unsigned tid) {
+        for (int d = tid; d < max_machines; d += m_route_threads) {
+            shortest_paths_to_node(num_switches, d, in_edges, dist_to[d]);
+        }
+    };
+
+    if (m_route_threads == 1) {
+        worker(0);
+    } else {
+        vector<thread> threads;
+        for (unsigned t = 0; t < m_route_threads; t++) {
+            threads.push_back(thread(worker, t));
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+
+    // Hook up the links in the same order as createLinks(), since the
+    // order determines the port numbering of the routers
+    for (LinkMap::const_iterator i = m_link_map.begin();
+         i != m_link_map.end(); ++i) {
+        int src = i->first.first;
+        int next = i->first.second;
+        int weight = i->second.link->m_weight;
+        if (weight <= 0 || weight == INFINITE_LATENCY) {
+            continue;
+        }
+
+        NetDest destination_set;
+        int d = 0;
+        for (int m = 0; m < MachineType_NUM; m++) {
+            for (NodeID n = 0; n < MachineType_base_count((MachineType)m);
+                 n++) {
+                if (weight + dist_to[d][next] == dist_to[d][src]) {
+                    MachineID mach = {(MachineType)m, n};
+                    destination_set.add(mach);
+                }
+                d++;
+            }
+        }
+        makeLink(net, src, next, destination_set);
+    }
+}
+
+void
+Topology::shortest_paths_to_node(int num_switches, NodeID dest,
+    const vector<vector<pair<int, int>>> &in_edges, vector<int> &dist)
+{
+    // Dijkstra over the reversed links from the output port of the node.
+    // See createLinks() for the numbering of the output ports.
+    int final = dest + MachineType_base_number(MachineType_NUM);
+    typedef pair<int, int> DistNode;
+    priority_queue<DistNode, vector<DistNode>, greater<DistNode>> queue;
+
+    dist.assign(num_switches, INFINITE_LATENCY);
+    dist[final] = 0;
+    queue.push(make_pair(0, final));
+
+    while (!queue.empty()) {
+        DistNode top = queue.top();
+        queue.pop();
+        int node = top.second;
+        if (top.first > dist[node]) {
+            continue;
+        }
+
+        for (auto &edge : in_edges[node]) {
+            int new_dist = top.first + edge.second;
+            // Paths at or beyond INFINITE_LATENCY are unreachable for
+            // the all-pairs algorithm as well
+            if (new_dist < dist[edge.first]) {
+                dist[edge.first] = new_dist;
+                queue.push(make_pair(new_dist, edge.first));
+            }
+        }
+    }
+}
+
 void
 Topology::addLink(SwitchID src, SwitchID dest, BasicLink* link,
                   PortDirection src_outport_dirn,
@@ -176,6 +288,173 @@ Topology::addLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_link_map[src_dest_pair] = link_entry;
 }
 
+void
+Topology::generateLinks(Network *net)
+{
+    const RubyNetworkParams *p = net->params();
+    const vector<unsigned> &dims = p->generator_dims;
+    Cycles latency = p->generator_link_latency;
+    int num_routers = m_number_of_switches;
+
+    // Generated link ids follow the ones of the Python links
+    int link_id = 0;
+    for (auto link : m_ext_link_vector)
+        link_id = max(link_id, link->params()->link_id + 1);
+    for (auto link : m_int_link_vector)
+        link_id = max(link_id, link->params()->link_id + 1);
+
+    auto add_link = [&](int src, int dst, Cycles lat, int weight,
+                        const PortDirection &src_outport,
+                        const PortDirection &dst_inport) {
+        BasicIntLink *link = net->makeGeneratedLink(link_id++, src, dst,
+                                                    lat, weight);
+        m_int_link_vector.push_back(link);
+        addLink(src + 2*m_nodes, dst + 2*m_nodes, link, src_outport,
+                dst_inport);
+    };
+
+    auto check_routers = [&](uint64_t expected) {
+        fatal_if(expected != num_routers, "%s: topology %s needs %d "
+                 "routers, the network has %d\n", net->name(),
+                 Enums::TopologyGeneratorStrings[p->topology_generator],
+                 expected, num_routers);
+    };
+
+    switch (p->topology_generator) {
+      case Enums::torus3d: {
+        // Router id = x + X * (y + Y * z). The weight of a link grows
+        // with its dimension, so routes are dimension ordered; the
+        // wraparound cycles are broken by the dateline VC classes of
+        // the network.
+        fatal_if(dims.size() != 3, "torus3d needs generator_dims "
+                 "[x, y, z]\n");
+        check_routers((uint64_t)dims[0] * dims[1] * dims[2]);
+
+        static const char *plus_dirn[] = { "East", "North", "Up" };
+        static const char *minus_dirn[] = { "West", "South", "Down" };
+        int stride = 1;
+        for (int d = 0; d < 3; d++) {
+            int k = dims[d];
+            for (int r = 0; k > 1 && r < num_routers; r++) {
+                int pos = (r / stride) % k;
+                int next = r + ((pos + 1) % k - pos) * stride;
+                add_link(r, next, latency, d + 1, plus_dirn[d],
+                         minus_dirn[d]);
+                // With two routers per ring both neighbours coincide
+                if (k > 2)
+                    add_link(next, r, latency, d + 1, minus_dirn[d],
+                             plus_dirn[d]);
+            }
+            stride *= k;
+        }
+        break;
+      }
+
+      case Enums::fat_tree: {
+        // k-ary n-tree: n levels of k^(n-1) switches, level 0 holds the
+        // leaves. Switch w of level l connects to the switches of level
+        // l+1 whose index differs from w only in base-k digit l. Every
+        // shortest path goes up and then down, which is deadlock free.
+        fatal_if(dims.size() != 2 || dims[0] < 2 || dims[1] < 1,
+                 "fat_tree needs generator_dims [k, n] with k >= 2\n");
+        int k = dims[0];
+        int levels = dims[1];
+        uint64_t per_level = 1;
+        for (int l = 1; l < levels; l++)
+            per_level *= k;
+        check_routers(per_level * levels);
+
+        int digit_weight = 1;
+        for (int l = 0; l + 1 < levels; l++) {
+            for (int w = 0; w < per_level; w++) {
+                int digit = (w / digit_weight) % k;
+                int lower = l * per_level + w;
+                for (int v = 0; v < k; v++) {
+                    int upper = (l + 1) * per_level + w +
+                                (v - digit) * digit_weight;
+                    add_link(lower, upper, latency, 1,
+                             csprintf("Up%d", v), csprintf("Down%d", digit));
+                    add_link(upper, lower, latency, 1,
+                             csprintf("Down%d", digit), csprintf("Up%d", v));
+                }
+            }
+            digit_weight *= k;
+        }
+        break;
+      }
+
+      case Enums::flattened_butterfly: {
+        // Every dimension is fully connected. The weights order the
+        // dimensions, so a route takes at most one hop per dimension.
+        fatal_if(dims.empty(), "flattened_butterfly needs generator_dims "
+                 "[k0, k1, ...]\n");
+        uint64_t routers = 1;
+        for (auto k : dims)
+            routers *= k;
+        check_routers(routers);
+
+        int stride = 1;
+        for (int d = 0; d < dims.size(); d++) {
+            int k = dims[d];
+            for (int r = 0; r < num_routers; r++) {
+                int pos = (r / stride) % k;
+                for (int v = 0; v < k; v++) {
+                    if (v == pos)
+                        continue;
+                    add_link(r, r + (v - pos) * stride, latency, d + 1,
+                             csprintf("D%d_%d", d, v),
+                             csprintf("D%d_%d", d, pos));
+                }
+            }
+            stride *= k;
+        }
+        break;
+      }
+
+      case Enums::dragonfly: {
+        // g groups of a fully connected routers with h global links each;
+        // every pair of groups is joined by one global link. Global
+        // links weigh more than two local hops, so minimal routes use a
+        // single global link and the group VC classes of the network
+        // make them deadlock free.
+        fatal_if(dims.size() != 3 || dims[0] < 1 || dims[1] < 1 ||
+                 dims[2] < 1, "dragonfly needs generator_dims [a, h, g]\n");
+        int a = dims[0];
+        int h = dims[1];
+        int g = dims[2];
+        fatal_if(g > a * h + 1, "dragonfly: %d groups need more than the "
+                 "%d global links per group\n", g, a * h);
+        check_routers((uint64_t)a * g);
+
+        for (int grp = 0; grp < g; grp++) {
+            for (int i = 0; i < a; i++) {
+                for (int j = 0; j < a; j++) {
+                    if (i != j)
+                        add_link(grp * a + i, grp * a + j, latency, 1,
+                                 csprintf("L%d", j), csprintf("L%d", i));
+                }
+            }
+
+            // Global port p of a group leads to the p-th other group
+            for (int other = 0; other < g; other++) {
+                if (other == grp)
+                    continue;
+                int src_port = other < grp ? other : other - 1;
+                int dst_port = grp < other ? grp : grp - 1;
+                add_link(grp * a + src_port / h, other * a + dst_port / h,
+                         p->generator_global_latency, 3,
+                         csprintf("G%d", src_port % h),
+                         csprintf("G%d", dst_port % h));
+            }
+        }
+        break;
+      }
+
+      default:
+        panic("Unknown topology generator %d\n", p->topology_generator);
+    }
+}
+
 void
 Topology::makeLink(Network *net, SwitchID src, SwitchID dest,
                    const NetDest& routing_table_entry)
@@ -42,8 +42,10 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "enums/TopologyRouteAlgorithm.hh"
 #include "mem/protocol/LinkDirection.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/network/BasicLink.hh"
@@ -67,7 +69,10 @@ class Topology
 {
   public:
     Topology(uint32_t num_routers, const std::vector<BasicExtLink *> &ext_links,
-             const std::vector<BasicIntLink *> &int_links);
+             const std::vector<BasicIntLink *> &int_links,
+             Enums::TopologyRouteAlgorithm route_algorithm =
+                 Enums::all_pairs,
+             unsigned route_threads = 1);
 
     uint32_t numSwitches() const { return m_number_of_switches; }
     void createLinks(Network *net);
@@ -80,6 +85,11 @@ class Topology
     void makeLink(Network *net, SwitchID src, SwitchID dest,
                   const NetDest& routing_table_entry);
 
+    // Adds the internal links of the topology selected by the network's
+    // topology_generator parameter. Dimension-ordered routes come from
+    // the link weights, like in the Python mesh topologies.
+    void generateLinks(Network *net);
+
     // Helper functions based on chapter 29 of Cormen et al.
     void extend_shortest_path(Matrix &current_dist, Matrix &latencies,
                               Matrix &inter_switches);
@@ -93,8 +103,19 @@ class Topology
     NetDest shortest_path_to_node(SwitchID src, SwitchID next,
                                   const Matrix &weights, const Matrix &dist);
 
+    // Per-destination route computation. dist_to[d][s] is the distance
+    // from switch s to the output port of node d, capped at
+    // INFINITE_LATENCY like the all-pairs version, so both produce the
+    // same routing tables.
+    void createLinksPerDestination(Network *net, int num_switches);
+    void shortest_paths_to_node(int num_switches, NodeID dest,
+            const std::vector<std::vector<std::pair<int, int>>> &in_edges,
+            std::vector<int> &dist);
+
     const uint32_t m_nodes;
     const uint32_t m_number_of_switches;
+    const Enums::TopologyRouteAlgorithm m_route_algorithm;
+    const unsigned m_route_threads;
 
     std::vector<BasicExtLink*> m_ext_link_vector;
     std::vector<BasicIntLink*> m_int_link_vector;
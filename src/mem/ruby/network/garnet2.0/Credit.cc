@@ -38,6 +38,12 @@
 // and m_is_free_signal (whether VC is free or not)
 
 Credit::Credit(int vc, bool is_free_signal, Cycles curTime)
+{
+    init(vc, is_free_signal, curTime);
+}
+
+void
+Credit::init(int vc, bool is_free_signal, Cycles curTime)
 {
     m_id = 0;
     m_vc = vc;
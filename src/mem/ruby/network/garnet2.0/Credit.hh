@@ -51,6 +51,8 @@ class Credit : public flit
     Credit() {};
     Credit(int vc, bool is_free_signal, Cycles curTime);
 
+    void init(int vc, bool is_free_signal, Cycles curTime);
+
     bool is_free_signal() { return m_is_free_signal; }
 
   private:
@@ -42,6 +42,9 @@ class CreditLink : public NetworkLink
   public:
     typedef CreditLinkParams Params;
     CreditLink(const Params *p) : NetworkLink(p) {}
+
+    const Params *params() const
+    { return dynamic_cast<const Params *>(_params); }
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET_CREDIT_LINK_HH__
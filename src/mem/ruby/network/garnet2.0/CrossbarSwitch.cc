@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/CrossbarSwitch.hh"
 
+#include "base/bitfield.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
@@ -46,6 +47,7 @@ CrossbarSwitch::CrossbarSwitch(Router *router)
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_crossbar_activity = 0;
+    m_occupied_inports = 0;
 }
 
 CrossbarSwitch::~CrossbarSwitch()
@@ -78,7 +80,12 @@ CrossbarSwitch::wakeup()
             "at time: %lld\n",
             m_router->get_id(), m_router->curCycle());
 
-    for (int inport = 0; inport < m_num_inports; inport++) {
+    // Only visit the inports that received a switch grant
+    uint64_t inports = m_occupied_inports;
+    while (inports) {
+        int inport = findLsbSet(inports);
+        inports &= inports - 1;
+
         if (!m_switch_buffer[inport]->isReady(m_router->curCycle()))
             continue;
 
@@ -95,6 +102,9 @@ CrossbarSwitch::wakeup()
             m_output_unit[outport]->insert_flit(t_flit);
             m_switch_buffer[inport]->getTopFlit();
             m_crossbar_activity++;
+
+            if (m_switch_buffer[inport]->isEmpty())
+                m_occupied_inports &= ~(ULL(1) << inport);
         }
     }
 }
@@ -53,8 +53,12 @@ class CrossbarSwitch : public Consumer
     void init();
     void print(std::ostream& out) const {};
 
-    inline void update_sw_winner(int inport, flit *t_flit)
-    { m_switch_buffer[inport]->insert(t_flit); }
+    inline void
+    update_sw_winner(int inport, flit *t_flit)
+    {
+        m_switch_buffer[inport]->insert(t_flit);
+        m_occupied_inports |= ULL(1) << inport;
+    }
 
     inline double get_crossbar_activity() { return m_crossbar_activity; }
 
@@ -66,6 +70,8 @@ class CrossbarSwitch : public Consumer
     double m_crossbar_activity;
     Router *m_router;
     std::vector<flitBuffer *> m_switch_buffer;
+    // Bitmask of the inports whose switch buffer holds a flit
+    uint64_t m_occupied_inports;
     std::vector<OutputUnit *> m_output_unit;
 };
 
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+
+#include "mem/ruby/network/garnet2.0/DSENTPowerModel.hh"
+
+#include <cmath>
+#include <exception>
+#include <fstream>
+
+#include "DSENT.h"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
+#include "sim/clocked_object.hh"
+#include "tech/TechModel.h"
+
+using namespace std;
+
+DSENTPowerModel::DSENTPowerModel(const Params *p)
+    : PowerModelState(p), m_leakage_power(0), m_sample_event(this),
+      m_config(p->config), m_sample_period(p->sample_period),
+      m_nominal_voltage(p->nominal_voltage), m_dynamic(p->dynamic),
+      m_leakage(p->leakage), m_leakage_temp_coeff(p->leakage_temp_coeff),
+      m_reference_temp(0), m_last_sample(0), m_dynamic_power(0)
+{
+    fatal_if(m_sample_period == 0, "%s: sample_period must be positive\n",
+             name());
+    fatal_if(m_nominal_voltage <= 0, "%s: nominal_voltage must be "
+             "positive\n", name());
+    // DSENT reads a missing file as an empty configuration, and then
+    // fails on the first missing key
+    fatal_if((m_dynamic || m_leakage) && !ifstream(m_config),
+             "%s: cannot open the DSENT configuration %s, relative paths "
+             "are taken from the working directory\n", name(), m_config);
+}
+
+void
+DSENTPowerModel::startup()
+{
+    fatal_if(!clocked_object, "%s is not part of the power model of a "
+             "clocked object\n", name());
+
+    // The per-state models of a gated or off state may report nothing
+    if (!m_dynamic && !m_leakage)
+        return;
+
+    buildModel();
+
+    if (m_dynamic) {
+        // Start the first window now, ignoring the activity so far
+        sampleEnergy();
+        m_last_sample = curTick();
+        schedule(m_sample_event, curTick() + m_sample_period);
+    }
+}
+
+void
+DSENTPowerModel::regStats()
+{
+    PowerModelState::regStats();
+
+    m_energy
+        .name(name() + ".dynamic_energy")
+        .desc("Dynamic energy of the sampled activity (Joules)")
+    ;
+}
+
+void
+DSENTPowerModel::sample()
+{
+    const double v = clocked_object->voltage() / m_nominal_voltage;
+    const double energy = sampleEnergy() * v * v;
+    const Tick elapsed = curTick() - m_last_sample;
+
+    m_energy += energy;
+    m_dynamic_power = elapsed ? energy * SimClock::Frequency / elapsed : 0;
+    m_last_sample = curTick();
+
+    schedule(m_sample_event, curTick() + m_sample_period);
+}
+
+double
+DSENTPowerModel::getDynamicPower() const
+{
+    return m_dynamic ? m_dynamic_power : 0;
+}
+
+double
+DSENTPowerModel::getStaticPower() const
+{
+    if (!m_leakage)
+        return 0;
+
+    double power = m_leakage_power * clocked_object->voltage() /
+        m_nominal_voltage;
+    if (m_leakage_temp_coeff != 0)
+        power *= exp(m_leakage_temp_coeff * (_temp - m_reference_temp));
+    return power;
+}
+
+DSENT::Model *
+DSENTPowerModel::getModel(const Overrides &overrides)
+{
+    // Building a model runs the DSENT timing optimization, which is too
+    // slow to repeat for every router of a regular topology
+    static map<string, DSENT::Model *> models;
+
+    string key = m_config;
+    for (const auto &it : overrides)
+        key += ";" + it.first + "=" + it.second;
+
+    DSENT::Model *&model = models[key];
+    if (!model) {
+        map<DSENT::String, DSENT::String> config;
+        map<DSENT::String, DSENT::String> params(overrides.begin(),
+                                                 overrides.end());
+        try {
+            model = DSENT::initialize(m_config.c_str(), config, params);
+        } catch (const exception &e) {
+            fatal("%s: failed to build the DSENT model of %s: %s\n",
+                  name(), m_config, e.what());
+        }
+    }
+
+    // DSENT gives the temperature of the technology in Kelvin
+    m_reference_temp =
+        model->getTechModel()->get("Temperature").toDouble() - 273.15;
+    return model;
+}
+
+double
+DSENTPowerModel::query(DSENT::Model *model, const string &query)
+{
+    try {
+        return DSENT::query(query, model);
+    } catch (const exception &e) {
+        fatal("%s: DSENT query %s failed: %s\n", name(), query, e.what());
+    }
+}
+
+double
+DSENTPowerModel::delta(double current, double &last)
+{
+    // The activity counters restart from zero when the stats are reset
+    const double d = current >= last ? current - last : current;
+    last = current;
+    return d;
+}
+
+DSENTRouterPowerModel::DSENTRouterPowerModel(const Params *p)
+    : DSENTPowerModel(p), m_router(nullptr), m_buf_write_energy(0),
+      m_buf_read_energy(0), m_crossbar_energy(0), m_sw_input_arb_energy(0),
+      m_sw_output_arb_energy(0), m_clock_energy(0), m_last_buf_writes(0),
+      m_last_buf_reads(0), m_last_crossbar(0), m_last_sw_input_arb(0),
+      m_last_sw_output_arb(0), m_last_cycle(0)
+{
+}
+
+void
+DSENTRouterPowerModel::buildModel()
+{
+    m_router = dynamic_cast<Router *>(clocked_object);
+    fatal_if(!m_router, "%s can only model garnet routers\n", name());
+
+    GarnetNetwork *net = m_router->get_net_ptr();
+    const int num_vnets = m_router->get_num_vnets();
+    const int vcs_per_vnet = m_router->get_vc_per_vnet();
+
+    fatal_if(m_router->get_num_inports() == 0 ||
+             m_router->get_num_outports() == 0,
+             "%s: router %d has no ports to model\n", name(),
+             m_router->get_id());
+
+    vector<unsigned int> vcs(num_vnets, vcs_per_vnet);
+    vector<unsigned int> buffers(num_vnets);
+    for (int vnet = 0; vnet < num_vnets; vnet++) {
+        buffers[vnet] = net->get_vnet_type(vnet * vcs_per_vnet) == DATA_VNET_ ?
+            net->getBuffersPerDataVC() : net->getBuffersPerCtrlVC();
+    }
+
+    Overrides overrides;
+    overrides["Frequency"] =
+        DSENT::String((double)m_router->frequency());
+    overrides["NumberInputPorts"] =
+        DSENT::String(m_router->get_num_inports());
+    overrides["NumberOutputPorts"] =
+        DSENT::String(m_router->get_num_outports());
+    overrides["NumberBitsPerFlit"] =
+        DSENT::String(net->getNiFlitSize() * 8);
+    overrides["NumberVirtualNetworks"] = DSENT::String(num_vnets);
+    overrides["NumberVirtualChannelsPerVirtualNetwork"] =
+        LibUtil::vectorToString<unsigned int>(vcs);
+    overrides["NumberBuffersPerVirtualChannel"] =
+        LibUtil::vectorToString<unsigned int>(buffers);
+
+    DSENT::Model *model = getModel(overrides);
+
+    m_buf_write_energy = query(model, "Energy>>Router:WriteBuffer");
+    m_buf_read_energy = query(model, "Energy>>Router:ReadBuffer");
+    m_crossbar_energy =
+        query(model, "Energy>>Router:TraverseCrossbar->Multicast1");
+    m_sw_input_arb_energy =
+        query(model, "Energy>>Router:ArbitrateSwitch->ArbitrateStage1");
+    m_sw_output_arb_energy =
+        query(model, "Energy>>Router:ArbitrateSwitch->ArbitrateStage2");
+    m_clock_energy = query(model, "Energy>>Router:DistributeClock");
+    m_leakage_power = query(model, "NddPower>>Router:Leakage");
+}
+
+double
+DSENTRouterPowerModel::sampleEnergy()
+{
+    const Cycles cycle = m_router->curCycle();
+    const double cycles = cycle - m_last_cycle;
+    m_last_cycle = cycle;
+
+    return
+        delta(m_router->get_buffer_writes(), m_last_buf_writes) *
+            m_buf_write_energy +
+        delta(m_router->get_buffer_reads(), m_last_buf_reads) *
+            m_buf_read_energy +
+        delta(m_router->get_crossbar_activity(), m_last_crossbar) *
+            m_crossbar_energy +
+        delta(m_router->get_sw_input_arbiter_activity(),
+              m_last_sw_input_arb) * m_sw_input_arb_energy +
+        delta(m_router->get_sw_output_arbiter_activity(),
+              m_last_sw_output_arb) * m_sw_output_arb_energy +
+        cycles * m_clock_energy;
+}
+
+DSENTRouterPowerModel *
+DSENTRouterPowerModelParams::create()
+{
+    return new DSENTRouterPowerModel(this);
+}
+
+DSENTLinkPowerModel::DSENTLinkPowerModel(const Params *p)
+    : DSENTPowerModel(p), m_link(nullptr),
+      m_link_width_bits(p->link_width_bits), m_wire_length(p->wire_length),
+      m_send_energy(0), m_last_flits(0)
+{
+}
+
+void
+DSENTLinkPowerModel::buildModel()
+{
+    m_link = dynamic_cast<NetworkLink *>(clocked_object);
+    fatal_if(!m_link, "%s can only model garnet links\n", name());
+
+    // A flit has one cycle to cross the wires
+    const double frequency = m_link->frequency();
+
+    Overrides overrides;
+    overrides["Frequency"] = DSENT::String(frequency);
+    overrides["Delay"] = DSENT::String(1.0 / frequency);
+    overrides["NumberBits"] = DSENT::String(m_link_width_bits);
+    overrides["WireLength"] = DSENT::String(m_wire_length);
+
+    DSENT::Model *model = getModel(overrides);
+
+    m_send_energy = query(model, "Energy>>RepeatedLink:Send");
+    m_leakage_power = query(model, "NddPower>>RepeatedLink:Leakage");
+}
+
+double
+DSENTLinkPowerModel::sampleEnergy()
+{
+    return delta(m_link->getLinkUtilization(), m_last_flits) *
+        m_send_energy;
+}
+
+DSENTLinkPowerModel *
+DSENTLinkPowerModelParams::create()
+{
+    return new DSENTLinkPowerModel(this);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_DSENT_POWER_MODEL_HH__
+#define __MEM_RUBY_NETWORK_GARNET_DSENT_POWER_MODEL_HH__
+
+#include <map>
+#include <string>
+
+#include "base/statistics.hh"
+#include "params/DSENTLinkPowerModel.hh"
+#include "params/DSENTPowerModel.hh"
+#include "params/DSENTRouterPowerModel.hh"
+#include "sim/eventq.hh"
+#include "sim/power/power_model.hh"
+
+namespace DSENT
+{
+    class Model;
+}
+
+class NetworkLink;
+class Router;
+
+/**
+ * A power model state that samples the activity of a garnet component
+ * every sample period and turns it into power with the per-event
+ * energies of a DSENT model. The DSENT model is built once at startup
+ * from the configuration file, with the parameters describing the
+ * component (ports, virtual channels, flit width, frequency) replaced by
+ * the actual ones.
+ */
+class DSENTPowerModel : public PowerModelState
+{
+  public:
+    typedef DSENTPowerModelParams Params;
+    DSENTPowerModel(const Params *p);
+
+    void startup() override;
+    void regStats() override;
+
+    double getDynamicPower() const override;
+    double getStaticPower() const override;
+
+  protected:
+    typedef std::map<std::string, std::string> Overrides;
+
+    /** Build the DSENT model and read the energies out of it */
+    virtual void buildModel() = 0;
+
+    /** Energy (J) of the activity since the previous sample */
+    virtual double sampleEnergy() = 0;
+
+    /**
+     * Get the model of the configuration file with the given overrides.
+     * Components with the same configuration share one model.
+     */
+    DSENT::Model *getModel(const Overrides &overrides);
+
+    /** Evaluate an energy or power query on a model */
+    double query(DSENT::Model *model, const std::string &query);
+
+    /** Increase of a counter since the last sample, and remember it */
+    static double delta(double current, double &last);
+
+    /** Leakage power (W) at the nominal voltage */
+    double m_leakage_power;
+
+  private:
+    void sample();
+
+    EventWrapper<DSENTPowerModel, &DSENTPowerModel::sample> m_sample_event;
+
+    const std::string m_config;
+    const Tick m_sample_period;
+    const double m_nominal_voltage;
+    const bool m_dynamic;
+    const bool m_leakage;
+    const double m_leakage_temp_coeff;
+
+    /** Temperature (Celsius) the leakage of the model is given at */
+    double m_reference_temp;
+
+    Tick m_last_sample;
+    double m_dynamic_power;
+
+    Stats::Scalar m_energy;
+};
+
+class DSENTRouterPowerModel : public DSENTPowerModel
+{
+  public:
+    typedef DSENTRouterPowerModelParams Params;
+    DSENTRouterPowerModel(const Params *p);
+
+  protected:
+    void buildModel() override;
+    double sampleEnergy() override;
+
+  private:
+    Router *m_router;
+
+    // Energy (J) per buffer write/read, crossbar traversal, input and
+    // output arbitration and clock cycle
+    double m_buf_write_energy, m_buf_read_energy;
+    double m_crossbar_energy;
+    double m_sw_input_arb_energy, m_sw_output_arb_energy;
+    double m_clock_energy;
+
+    double m_last_buf_writes, m_last_buf_reads;
+    double m_last_crossbar, m_last_sw_input_arb, m_last_sw_output_arb;
+    Cycles m_last_cycle;
+};
+
+class DSENTLinkPowerModel : public DSENTPowerModel
+{
+  public:
+    typedef DSENTLinkPowerModelParams Params;
+    DSENTLinkPowerModel(const Params *p);
+
+  protected:
+    void buildModel() override;
+    double sampleEnergy() override;
+
+  private:
+    NetworkLink *m_link;
+    const unsigned m_link_width_bits;
+    const double m_wire_length;
+
+    // Energy (J) per flit sent over the link
+    double m_send_energy;
+    double m_last_flits;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET_DSENT_POWER_MODEL_HH__
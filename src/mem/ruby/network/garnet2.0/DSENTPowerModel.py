@@ -0,0 +1,82 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import os
+
+from m5.params import *
+from m5.proxy import *
+from PowerModelState import PowerModelState
+
+# Power models that feed the activity counters of garnet routers and links
+# into a DSENT model built at startup. The dynamic power is the energy of
+# the activity seen during the last sample period; attach them to a
+# PowerModel to have them weighted by the power state of the object.
+def dsentConfig(name):
+    """Path of a configuration file shipped with DSENT. The file is
+    looked up in the source tree this file was built from, so that gem5
+    does not have to run from the top of the tree, and relative to the
+    working directory otherwise."""
+    rel_path = os.path.join('ext', 'dsent', 'configs', name)
+    # this file is src/mem/ruby/network/garnet2.0/DSENTPowerModel.py
+    src_root = os.path.join(
+        os.path.dirname(dsentConfig.__code__.co_filename),
+        os.pardir, os.pardir, os.pardir, os.pardir, os.pardir)
+    path = os.path.normpath(os.path.join(src_root, rel_path))
+    return path if os.path.isfile(path) else rel_path
+
+class DSENTPowerModel(PowerModelState):
+    type = 'DSENTPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/DSENTPowerModel.hh"
+    abstract = True
+
+    config = Param.String("DSENT configuration file")
+    sample_period = Param.Latency('1us', "time between two activity samples")
+    nominal_voltage = Param.Float(1.0, "supply voltage (V) of the DSENT "
+                                  "technology model; energies are scaled "
+                                  "with the square of the actual voltage")
+    dynamic = Param.Bool(True, "report dynamic power (false for the "
+                         "clock gated states)")
+    leakage = Param.Bool(True, "report leakage power (false for the off "
+                         "state)")
+    leakage_temp_coeff = Param.Float(0.0, "exponential temperature "
+                                     "coefficient (1/K) of the leakage "
+                                     "power, 0 disables the scaling")
+
+class DSENTRouterPowerModel(DSENTPowerModel):
+    type = 'DSENTRouterPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/DSENTPowerModel.hh"
+
+    config = dsentConfig('router.cfg')
+
+class DSENTLinkPowerModel(DSENTPowerModel):
+    type = 'DSENTLinkPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/DSENTPowerModel.hh"
+
+    config = dsentConfig('electrical-link.cfg')
+    link_width_bits = Param.Unsigned(128, "width of the link in bits")
+    wire_length = Param.Float(1e-3, "length of the link wires (m)")
@@ -33,10 +33,18 @@
 
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <queue>
 
+#include "base/callback.hh"
 #include "base/cast.hh"
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
+#include "config/have_protobuf.hh"
+#include "debug/Drain.hh"
+#include "debug/RubyNetwork.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -46,6 +54,12 @@
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
+#include "sim/stat_control.hh"
+
+#if HAVE_PROTOBUF
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
+#endif
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -57,7 +71,10 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p), m_parallel_routers(p->parallel_routers),
+      m_router_threads(std::max(p->router_threads, 1U)),
+      m_router_barrier(NULL), m_stop_router_workers(false),
+      m_router_eval_event(this, false, Event::Default_Pri + 1)
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -66,10 +83,51 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
 
+    fatal_if(m_router_threads > 1 && !m_parallel_routers, "%s: "
+             "router_threads > 1 requires parallel_routers\n", name());
+
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
         fault_model = p->fault_model;
 
+    m_analytic_mode = p->analytic_mode;
+    m_analytic_window = std::max(p->analytic_window, 1U);
+    m_packets_in_flight = 0;
+
+    m_trace_recorder = NULL;
+    m_trace_replayer = NULL;
+    if (!p->network_trace_file.empty()) {
+#if HAVE_PROTOBUF
+        m_trace_recorder =
+            new NetworkTraceRecorder(this, p->network_trace_file);
+        // The destructor is not called on exit, so flush the trace from
+        // an exit callback instead
+        registerExitCallback(
+            new MakeCallback<GarnetNetwork,
+                             &GarnetNetwork::closeNetworkTrace>(this));
+#else
+        fatal("%s: network_trace_file requires protobuf support\n",
+              name());
+#endif
+    }
+    if (!p->replay_trace_file.empty()) {
+#if HAVE_PROTOBUF
+        m_trace_replayer = new NetworkTraceReplayer(this,
+            p->replay_trace_file, p->replay_window, p->replay_history);
+#else
+        fatal("%s: replay_trace_file requires protobuf support\n",
+              name());
+#endif
+    }
+
+    m_router_latency = 0;
+    m_int_link_latency = 0;
+    m_ext_link_latency = 0;
+    m_num_int_links = 0;
+    m_num_ext_links = 0;
+    m_link_load = 0;
+    m_service_time = 1;
+
     m_vnet_type.resize(m_virtual_networks);
 
     for (int i = 0 ; i < m_virtual_networks ; i++) {
@@ -110,8 +168,21 @@ GarnetNetwork::init()
     // The topology pointer should have already been initialized in the
     // parent network constructor
     assert(m_topology_ptr != NULL);
+    m_router_links.resize(m_routers.size());
+    m_router_hops.resize(m_routers.size());
     m_topology_ptr->createLinks(this);
 
+    // Average zero-load latency components for the analytic model
+    for (int i = 0; i < m_routers.size(); i++)
+        m_router_latency += m_routers[i]->get_pipe_stages();
+    if (!m_routers.empty())
+        m_router_latency /= m_routers.size();
+    if (m_num_int_links > 0)
+        m_int_link_latency /= m_num_int_links;
+    if (m_num_ext_links > 0)
+        m_ext_link_latency /= m_num_ext_links;
+    resetWindow();
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -125,6 +196,23 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    // The adaptive algorithms route on mesh coordinates
+    if (m_routing_algorithm >= XY_ && m_routing_algorithm != CUSTOM_ &&
+        m_num_rows <= 0) {
+        fatal("Routing algorithm %d requires a mesh topology with "
+              "num_rows > 0\n", m_routing_algorithm);
+    }
+    if (hasEscapeVCs() && m_vcs_per_vnet < 2) {
+        fatal("Adaptive routing with escape VCs requires at least two "
+              "VCs per vnet\n");
+    }
+    fatal_if(getTopologyGenerator() != Enums::none &&
+             m_routing_algorithm != TABLE_, "Generated topologies use the "
+             "weight-based routing table (routing_algorithm 0)\n");
+    fatal_if(hasVCClasses() && m_vcs_per_vnet < 2, "The %s topology "
+             "requires at least two VCs per vnet\n",
+             Enums::TopologyGeneratorStrings[getTopologyGenerator()]);
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (vector<Router*>::const_iterator i= m_routers.begin();
@@ -145,10 +233,201 @@ GarnetNetwork::init()
 
 GarnetNetwork::~GarnetNetwork()
 {
+    if (!m_router_workers.empty()) {
+        m_stop_router_workers = true;
+        m_router_barrier->wait();
+        for (auto &worker : m_router_workers)
+            worker.join();
+    }
+    delete m_router_barrier;
+
     deletePointers(m_routers);
     deletePointers(m_nis);
     deletePointers(m_networklinks);
     deletePointers(m_creditlinks);
+    deletePointers(m_generated_links);
+    deletePointers(m_free_flits);
+    deletePointers(m_free_credits);
+#if HAVE_PROTOBUF
+    delete m_trace_recorder;
+    delete m_trace_replayer;
+#endif
+}
+
+void
+GarnetNetwork::startup()
+{
+    // The workers are started here rather than in the constructor so
+    // that no host thread exists while the configuration may still fork
+    if (m_router_threads > 1 && m_router_workers.empty()) {
+        m_router_barrier = new Barrier(m_router_threads);
+        for (unsigned t = 1; t < m_router_threads; t++) {
+            m_router_workers.emplace_back(&GarnetNetwork::routerWorker,
+                                          this, t);
+        }
+    }
+
+#if HAVE_PROTOBUF
+    if (m_trace_replayer != NULL) {
+        m_trace_replayer->start();
+    }
+#endif
+}
+
+void
+GarnetNetwork::traceInjection(NodeID src, NodeID dest, int vnet,
+                              const MsgPtr &msg_ptr)
+{
+#if HAVE_PROTOBUF
+    if (m_trace_recorder != NULL) {
+        m_trace_recorder->injected(src, dest, vnet, msg_ptr.get());
+    }
+#endif
+}
+
+void
+GarnetNetwork::traceDelivery(NodeID dest, const MsgPtr &msg_ptr)
+{
+#if HAVE_PROTOBUF
+    if (m_trace_recorder != NULL) {
+        m_trace_recorder->delivered(dest, msg_ptr.get());
+    }
+#endif
+}
+
+bool
+GarnetNetwork::isReplayMessage(const MsgPtr &msg_ptr) const
+{
+#if HAVE_PROTOBUF
+    return m_trace_replayer != NULL &&
+        NetworkTraceReplayer::isReplayed(msg_ptr);
+#else
+    return false;
+#endif
+}
+
+bool
+GarnetNetwork::replayDelivery(const MsgPtr &msg_ptr)
+{
+#if HAVE_PROTOBUF
+    return m_trace_replayer != NULL && m_trace_replayer->delivered(msg_ptr);
+#else
+    return false;
+#endif
+}
+
+void
+GarnetNetwork::closeNetworkTrace()
+{
+#if HAVE_PROTOBUF
+    if (m_trace_recorder != NULL) {
+        m_trace_recorder->close();
+    }
+#endif
+}
+
+void
+GarnetNetwork::activateRouter(Router *router)
+{
+    m_active_routers.push_back(router);
+    if (!m_router_eval_event.scheduled())
+        schedule(m_router_eval_event, curTick());
+}
+
+void
+GarnetNetwork::setRouterThreads(unsigned threads)
+{
+    fatal_if(!m_router_workers.empty(), "%s: the router threads can only "
+             "be changed before the simulation starts\n", name());
+    fatal_if(threads > 1 && !m_parallel_routers, "%s: router_threads > 1 "
+             "requires parallel_routers\n", name());
+    m_router_threads = std::max(threads, 1U);
+}
+
+void
+GarnetNetwork::evaluateRouters()
+{
+    // A handful of routers is not worth waking the workers up for. The
+    // debug output of the routers would race on the trace stream, so
+    // they are evaluated here while it is enabled, which gives the same
+    // results.
+    if (m_router_threads == 1 || m_active_routers.size() < m_router_threads ||
+        DTRACE(RubyNetwork)) {
+        for (auto router : m_active_routers)
+            router->evaluate();
+    } else {
+        m_router_barrier->wait();
+        evaluateRouterShare(0);
+        m_router_barrier->wait();
+    }
+
+    for (auto router : m_active_routers)
+        router->commitEvaluation();
+    m_active_routers.clear();
+}
+
+void
+GarnetNetwork::evaluateRouterShare(unsigned tid)
+{
+    for (int i = tid; i < m_active_routers.size(); i += m_router_threads)
+        m_active_routers[i]->evaluate();
+}
+
+void
+GarnetNetwork::routerWorker(unsigned tid)
+{
+    // curTick() and the clocked objects read the current event queue
+    curEventQueue(eventQueue());
+
+    while (true) {
+        m_router_barrier->wait();
+        if (m_stop_router_workers)
+            return;
+        evaluateRouterShare(tid);
+        m_router_barrier->wait();
+    }
+}
+
+flit *
+GarnetNetwork::newFlit(int id, int vc, int vnet, const RouteInfo &route,
+                       int size, const MsgPtr &msg_ptr, Cycles curTime)
+{
+    if (m_free_flits.empty()) {
+        return new flit(id, vc, vnet, route, size, msg_ptr, curTime);
+    }
+
+    // Reinitializing in place also reuses the storage of the NetDest in
+    // the route
+    flit *t_flit = m_free_flits.back();
+    m_free_flits.pop_back();
+    t_flit->init(id, vc, vnet, route, size, msg_ptr, curTime);
+    return t_flit;
+}
+
+Credit *
+GarnetNetwork::newCredit(int vc, bool is_free_signal, Cycles curTime)
+{
+    if (m_free_credits.empty()) {
+        return new Credit(vc, is_free_signal, curTime);
+    }
+
+    Credit *t_credit = m_free_credits.back();
+    m_free_credits.pop_back();
+    t_credit->init(vc, is_free_signal, curTime);
+    return t_credit;
+}
+
+void
+GarnetNetwork::recycleFlit(flit *t_flit)
+{
+    t_flit->release();
+    m_free_flits.push_back(t_flit);
+}
+
+void
+GarnetNetwork::recycleCredit(Credit *t_credit)
+{
+    m_free_credits.push_back(t_credit);
 }
 
 /*
@@ -177,6 +456,9 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
     PortDirection dst_inport_dirn = "Local";
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
     m_nis[src]->addOutPort(net_link, credit_link, dest);
+
+    m_ext_link_latency += link->m_latency;
+    m_num_ext_links++;
 }
 
 /*
@@ -208,6 +490,9 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
                                routing_table_entry,
                                link->m_weight, credit_link);
     m_nis[dest]->addInPort(net_link, credit_link);
+
+    m_ext_link_latency += link->m_latency;
+    m_num_ext_links++;
 }
 
 /*
@@ -235,6 +520,56 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
+
+    m_router_links[src].push_back(dest);
+    m_int_link_latency += link->m_latency;
+    m_num_int_links++;
+}
+
+// Internal link of a generated topology. The flit and credit links
+// are copies of those of the first external link, which Python built,
+// so that they get the same clock domain and power state settings.
+BasicIntLink *
+GarnetNetwork::makeGeneratedLink(int link_id, SwitchID src, SwitchID dst,
+                                 Cycles latency, int weight)
+{
+    string link_name = csprintf("gen_int_links%d", m_generated_links.size());
+
+    fatal_if(params()->ext_links.empty(), "%s: a generated topology needs "
+             "an external link to copy the link parameters from\n", name());
+    GarnetExtLink *ext_link =
+        safe_cast<GarnetExtLink*>(params()->ext_links.front());
+
+    NetworkLinkParams *net_p =
+        new NetworkLinkParams(*ext_link->m_network_links[0]->params());
+    CreditLinkParams *credit_p =
+        new CreditLinkParams(*ext_link->m_credit_links[0]->params());
+    initGeneratedParams(net_p, link_name + ".network_link");
+    initGeneratedParams(credit_p, link_name + ".credit_link");
+    NetworkLinkParams *link_params[] = { net_p, credit_p };
+    for (NetworkLinkParams *p : link_params) {
+        // A power model belongs to a single object
+        p->power_model = nullptr;
+        p->link_id = link_id;
+        p->link_latency = latency;
+        p->vcs_per_vnet = m_vcs_per_vnet;
+        p->virt_nets = m_virtual_networks;
+    }
+
+    GarnetIntLinkParams *link_p = new GarnetIntLinkParams();
+    initGeneratedParams(link_p, link_name);
+    link_p->link_id = link_id;
+    link_p->latency = latency;
+    link_p->bandwidth_factor = params()->generator_bandwidth_factor;
+    link_p->weight = weight;
+    link_p->src_node = m_routers[src];
+    link_p->dst_node = m_routers[dst];
+    link_p->network_link = net_p->create();
+    link_p->credit_link = credit_p->create();
+
+    GarnetIntLink *link = link_p->create();
+    m_generated_links.push_back(link);
+    return link;
 }
 
 // Total routers in the network
@@ -251,11 +586,172 @@ GarnetNetwork::get_router_id(int ni)
     return m_nis[ni]->get_router_id();
 }
 
+// Link load above which the M/D/1 estimate is capped
+static const double ANALYTIC_MAX_LINK_LOAD = 0.95;
+// Link load below which detailed samples do not recalibrate the
+// service time, since zero-load modeling errors would dominate
+static const double ANALYTIC_MIN_CALIBRATION_LOAD = 0.01;
+static const double ANALYTIC_MAX_SERVICE_TIME = 64;
+
+void
+GarnetNetwork::setAnalyticMode(bool analytic)
+{
+    if (analytic == m_analytic_mode)
+        return;
+
+    fatal_if(m_packets_in_flight != 0, "%s: %d packets in flight, drain "
+             "the system before switching the network model\n", name(),
+             m_packets_in_flight);
+
+    // A partial window of detailed samples still calibrates the model
+    if (!m_analytic_mode)
+        calibrate();
+
+    DPRINTF(RubyNetwork, "Switching to the %s network model, link load "
+            "%f, service time %f\n", analytic ? "analytic" : "detailed",
+            m_link_load, m_service_time);
+
+    m_analytic_mode = analytic;
+    resetWindow();
+}
+
+int
+GarnetNetwork::routerHops(int src_router, int dest_router)
+{
+    // Breadth-first search over the router graph, once per source
+    vector<int> &hops = m_router_hops[src_router];
+    if (hops.empty()) {
+        hops.assign(m_routers.size(), -1);
+        std::queue<int> frontier;
+        hops[src_router] = 0;
+        frontier.push(src_router);
+
+        while (!frontier.empty()) {
+            int router = frontier.front();
+            frontier.pop();
+            for (int next : m_router_links[router]) {
+                if (hops[next] < 0) {
+                    hops[next] = hops[router] + 1;
+                    frontier.push(next);
+                }
+            }
+        }
+    }
+
+    panic_if(hops[dest_router] < 0, "No path from router %d to router %d\n",
+             src_router, dest_router);
+    return hops[dest_router];
+}
+
+double
+GarnetNetwork::zeroLoadLatency(int hops, int num_flits)
+{
+    return 2 * m_ext_link_latency + (hops + 1) * m_router_latency +
+        hops * m_int_link_latency + (num_flits - 1);
+}
+
+Cycles
+GarnetNetwork::analyticLatency(int src_router, int dest_router,
+                               int num_flits)
+{
+    int hops = routerHops(src_router, dest_router);
+
+    m_window_packets++;
+    m_window_flit_hops += num_flits * hops;
+    if (m_window_packets >= m_analytic_window) {
+        calibrate();
+        resetWindow();
+    }
+
+    // M/D/1 mean waiting time at each hop
+    double wait = m_link_load * m_service_time / (2 * (1 - m_link_load));
+    double latency = zeroLoadLatency(hops, num_flits) + hops * wait;
+    return Cycles((uint64_t) ceil(latency));
+}
+
+void
+GarnetNetwork::sampleDetailedPacket(Cycles latency, int hops, int num_flits)
+{
+    double wait = double(latency) - zeroLoadLatency(hops, num_flits);
+
+    m_window_packets++;
+    m_window_wait += std::max(wait, 0.0);
+    m_window_hops += hops;
+    m_window_flit_hops += num_flits * hops;
+    if (m_window_packets >= m_analytic_window) {
+        calibrate();
+        resetWindow();
+    }
+}
+
+void
+GarnetNetwork::calibrate()
+{
+    double elapsed = double(curCycle() - m_window_start);
+    if (elapsed <= 0 || m_num_int_links == 0 || m_window_packets == 0)
+        return;
+
+    double load = m_window_flit_hops / (elapsed * m_num_int_links);
+    m_link_load = std::min(load, ANALYTIC_MAX_LINK_LOAD);
+
+    // In detailed mode, invert W = rho * D / (2 * (1 - rho)) with the
+    // observed per-hop queueing delay to obtain the service time D
+    if (!m_analytic_mode && m_window_hops > 0 &&
+        m_link_load > ANALYTIC_MIN_CALIBRATION_LOAD) {
+        double wait = m_window_wait / m_window_hops;
+        m_service_time = 2 * (1 - m_link_load) * wait / m_link_load;
+        m_service_time = std::max(1.0, std::min(m_service_time,
+                                                ANALYTIC_MAX_SERVICE_TIME));
+    }
+}
+
+void
+GarnetNetwork::resetWindow()
+{
+    m_window_packets = 0;
+    m_window_wait = 0;
+    m_window_hops = 0;
+    m_window_flit_hops = 0;
+    m_window_start = curCycle();
+}
+
+void
+GarnetNetwork::packetDelivered()
+{
+    assert(m_packets_in_flight > 0);
+    m_packets_in_flight--;
+
+    if (m_packets_in_flight == 0 && drainState() == DrainState::Draining) {
+        DPRINTF(Drain, "Network done draining, signaling drain done\n");
+        signalDrainDone();
+    }
+}
+
+DrainState
+GarnetNetwork::drain()
+{
+    if (m_packets_in_flight > 0) {
+        DPRINTF(Drain, "Network not drained, %d packets in flight\n",
+                m_packets_in_flight);
+        return DrainState::Draining;
+    }
+
+    return DrainState::Drained;
+}
+
 void
 GarnetNetwork::regStats()
 {
     Network::regStats();
 
+    // The generated links are not known to Python, which registers the
+    // statistics of all the other objects
+    for (auto link : m_generated_links) {
+        link->regStats();
+        link->m_network_link->regStats();
+        link->m_credit_link->regStats();
+    }
+
     // Packets
     m_packets_received
         .init(m_virtual_networks)
@@ -378,6 +874,35 @@ GarnetNetwork::regStats()
     m_avg_hops.name(name() + ".average_hops");
     m_avg_hops = m_total_hops / sum(m_flits_received);
 
+    // Analytic model
+    m_analytic_packets
+        .init(m_virtual_networks)
+        .name(name() + ".analytic_packets")
+        .desc("Packets delivered by the analytic network model")
+        .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_analytic_link_load
+        .scalar(m_link_load)
+        .name(name() + ".analytic_link_load")
+        .desc("Internal link load used by the analytic model")
+        ;
+
+    m_analytic_service_time
+        .scalar(m_service_time)
+        .name(name() + ".analytic_service_time")
+        .desc("Per-hop M/D/1 service time of the analytic model")
+        ;
+
+    // Simulator throughput
+    m_flits_per_host_second
+        .method(this, &GarnetNetwork::hostFlitRate)
+        .name(name() + ".flits_per_host_second")
+        .desc("Flits received per second of host time since the last "
+              "stats reset")
+        .precision(0)
+        ;
+
     // Links
     m_total_ext_in_link_utilization
         .name(name() + ".ext_in_link_utilization");
@@ -395,6 +920,13 @@ GarnetNetwork::regStats()
         ;
 }
 
+double
+GarnetNetwork::hostFlitRate() const
+{
+    double host_seconds = Stats::statElapsedTime();
+    return host_seconds > 0 ? m_flits_received.total() / host_seconds : 0;
+}
+
 void
 GarnetNetwork::collateStats()
 {
@@ -35,11 +35,15 @@
 #define __MEM_RUBY_NETWORK_GARNET_NETWORK_HH__
 
 #include <iostream>
+#include <thread>
 #include <vector>
 
+#include "base/barrier.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/Credit.hh"
+#include "mem/ruby/network/garnet2.0/flit.hh"
 #include "params/GarnetNetwork.hh"
 
 class FaultModel;
@@ -48,6 +52,9 @@ class Router;
 class NetDest;
 class NetworkLink;
 class CreditLink;
+class GarnetIntLink;
+class NetworkTraceRecorder;
+class NetworkTraceReplayer;
 
 class GarnetNetwork : public Network
 {
@@ -57,6 +64,7 @@ class GarnetNetwork : public Network
 
     ~GarnetNetwork();
     void init();
+    void startup() override;
 
     // Configuration (set externally)
 
@@ -70,6 +78,22 @@ class GarnetNetwork : public Network
     uint32_t getBuffersPerDataVC() { return m_buffers_per_data_vc; }
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
+    // The first VC of every vnet is reserved as an XY escape channel
+    bool hasEscapeVCs() const
+    { return m_routing_algorithm == ADAPTIVE_ESCAPE_; }
+
+    // Generated topologies (see Topology::generateLinks). On a torus and
+    // a dragonfly the VCs of every vnet are split into two classes, the
+    // second one used after crossing a dateline or a global link.
+    Enums::TopologyGenerator getTopologyGenerator() const
+    { return params()->topology_generator; }
+    const std::vector<unsigned> &getGeneratorDims() const
+    { return params()->generator_dims; }
+    bool hasVCClasses() const
+    {
+        return getTopologyGenerator() == Enums::torus3d ||
+               getTopologyGenerator() == Enums::dragonfly;
+    }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
@@ -85,7 +109,54 @@ class GarnetNetwork : public Network
     }
     int getNumRouters();
     int get_router_id(int ni);
-
+    NetworkInterface *getNetworkInterface(NodeID ni) { return m_nis[ni]; }
+
+    // Analytic (fast) mode. Messages bypass the routers and are
+    // delivered by the destination NI after
+    //   hops x per-hop latency + serialization + hops x M/D/1 wait,
+    // where the M/D/1 service time is calibrated from the queueing delay
+    // observed in detailed mode, and the link load is tracked from the
+    // injected traffic. The mode may only change while the network is
+    // drained, so no message is in flight in either model.
+    bool isAnalyticMode() const { return m_analytic_mode; }
+    void setAnalyticMode(bool analytic);
+    Cycles analyticLatency(int src_router, int dest_router, int num_flits);
+    int routerHops(int src_router, int dest_router);
+    void sampleDetailedPacket(Cycles latency, int hops, int num_flits);
+
+    // Packets handed to the network and not yet given to the protocol
+    void packetInjected() { m_packets_in_flight++; }
+    void packetDelivered();
+    DrainState drain() override;
+
+    // Network trace capture and replay (see NetworkTrace.hh). The NIs
+    // report every unicast message they inject and deliver; messages
+    // injected by the replayer are consumed by it instead of the protocol.
+    void traceInjection(NodeID src, NodeID dest, int vnet,
+                        const MsgPtr &msg_ptr);
+    void traceDelivery(NodeID dest, const MsgPtr &msg_ptr);
+    bool isReplayMessage(const MsgPtr &msg_ptr) const;
+    bool replayDelivery(const MsgPtr &msg_ptr);
+    void closeNetworkTrace();
+
+    // Parallel router evaluation (parallel_routers). A router woken up
+    // by its event only registers here; every router woken up in a tick
+    // is then evaluated by router_threads host threads once the other
+    // events of the tick have run. Routers only exchange flits and
+    // credits through the time-stamped link buffers, which the serial
+    // link events fill and drain, so they may be evaluated in any order.
+    // The wakeups they schedule are buffered per router and committed in
+    // activation order, and routes are drawn from per-router generators,
+    // so the results are the same for any router_threads, including 1.
+    // Without parallel_routers, every router is evaluated from its own
+    // event, schedules its wakeups directly and draws its routes from
+    // rand(), as garnet always did.
+    bool isParallel() const { return m_parallel_routers; }
+    void activateRouter(Router *router);
+
+    // Number of host threads, which may be changed until startup(),
+    // e.g. to compare the results of a forked simulation
+    void setRouterThreads(unsigned threads);
 
     // Methods used by Topology to setup the network
     void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
@@ -96,6 +167,17 @@ class GarnetNetwork : public Network
                           const NetDest& routing_table_entry,
                           PortDirection src_outport_dirn,
                           PortDirection dest_inport_dirn);
+    BasicIntLink *makeGeneratedLink(int link_id, SwitchID src, SwitchID dst,
+                                    Cycles latency, int weight) override;
+
+    // Flits and credits are recycled through free lists owned by the
+    // network, rather than allocated and deleted for every packet.
+    // A flit or credit must be recycled exactly once, by its sink.
+    flit *newFlit(int id, int vc, int vnet, const RouteInfo &route,
+                  int size, const MsgPtr &msg_ptr, Cycles curTime);
+    Credit *newCredit(int vc, bool is_free_signal, Cycles curTime);
+    void recycleFlit(flit *t_flit);
+    void recycleCredit(Credit *t_credit);
 
     //! Function for performing a functional write. The return value
     //! indicates the number of messages that were written.
@@ -143,6 +225,8 @@ class GarnetNetwork : public Network
         m_total_hops += hops;
     }
 
+    void increment_analytic_packets(int vnet) { m_analytic_packets[vnet]++; }
+
   protected:
     // Configuration
     int m_num_rows;
@@ -153,6 +237,8 @@ class GarnetNetwork : public Network
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
     bool m_enable_fault_model;
+    bool m_analytic_mode;
+    uint32_t m_analytic_window;
 
     // Statistical variables
     Stats::Vector m_packets_received;
@@ -186,6 +272,14 @@ class GarnetNetwork : public Network
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
 
+    Stats::Vector m_analytic_packets;
+    Stats::Value m_analytic_link_load;
+    Stats::Value m_analytic_service_time;
+
+    //! Host throughput, to compare simulator versions at a given load
+    Stats::Value m_flits_per_host_second;
+    double hostFlitRate() const;
+
   private:
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
@@ -195,6 +289,51 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+    std::vector<GarnetIntLink *> m_generated_links; // Built by Topology
+
+    std::vector<flit *> m_free_flits;      // Recycled flits
+    std::vector<Credit *> m_free_credits;  // Recycled credits
+
+    uint64_t m_packets_in_flight;
+
+    NetworkTraceRecorder *m_trace_recorder;
+    NetworkTraceReplayer *m_trace_replayer;
+
+    bool m_parallel_routers;
+    unsigned m_router_threads;
+    std::vector<Router *> m_active_routers;
+    std::vector<std::thread> m_router_workers;
+    Barrier *m_router_barrier;
+    bool m_stop_router_workers;
+    void evaluateRouters();
+    void evaluateRouterShare(unsigned tid);
+    void routerWorker(unsigned tid);
+    EventWrapper<GarnetNetwork, &GarnetNetwork::evaluateRouters>
+        m_router_eval_event;
+
+    // Analytic model: router graph, lazily computed hop counts per
+    // source router, and the zero-load latency components
+    std::vector<std::vector<int>> m_router_links;
+    std::vector<std::vector<int>> m_router_hops;
+    double m_router_latency;
+    double m_int_link_latency;
+    double m_ext_link_latency;
+    int m_num_int_links;
+    int m_num_ext_links;
+    double zeroLoadLatency(int hops, int num_flits);
+
+    // Calibration window, shared by both modes: detailed packets
+    // measure the queueing delay, and both measure the link load
+    uint64_t m_window_packets;
+    double m_window_wait;
+    double m_window_hops;
+    double m_window_flit_hops;
+    Cycles m_window_start;
+    void calibrate();
+    void resetWindow();
+
+    double m_link_load;      // flits per cycle per internal link
+    double m_service_time;   // M/D/1 service time per hop, in cycles
 };
 
 inline std::ostream&
@@ -43,11 +43,41 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        "0: Weight-based Table, 1: XY, 2: Custom, 3: West-first, "
+        "4: Odd-even, 5: Fully adaptive with XY escape VCs");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    analytic_mode = Param.Bool(False, "deliver messages through the "
+        "analytic latency model instead of the detailed routers")
+    analytic_window = Param.UInt32(1000, "packets per calibration window "
+        "of the analytic latency model")
+    network_trace_file = Param.String("", "File to write a binary trace "
+        "of the messages injected by the NIs to; empty disables the trace")
+    replay_trace_file = Param.String("", "Network trace to inject into "
+        "the NIs instead of the protocol traffic; the simulation exits "
+        "once it has been delivered")
+    replay_window = Param.UInt32(4096, "records of the replayed trace "
+        "read ahead of their injection")
+    replay_history = Param.UInt32(65536, "records of the replayed trace "
+        "whose delivery is remembered for the records read later; a record "
+        "depending on an older one is injected at its trace tick")
+    parallel_routers = Param.Bool(False, "evaluate the routers woken up "
+        "in a cycle together, after the other events of the cycle, with "
+        "their random route choices drawn from per-router generators; the "
+        "results are the same for any number of router_threads, but differ "
+        "from those of the default inline evaluation")
+    router_threads = Param.UInt32(1, "host threads evaluating the routers "
+        "woken up in a cycle; above 1 requires parallel_routers")
+
+    @classmethod
+    def export_methods(cls, code):
+        code('''
+      bool isAnalyticMode() const;
+      void setAnalyticMode(bool analytic);
+      void setRouterThreads(unsigned threads);
+''')
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
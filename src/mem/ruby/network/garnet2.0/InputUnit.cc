@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 
+#include "base/bitfield.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
@@ -63,6 +64,9 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
     for (int i=0; i < m_num_vcs; i++) {
         m_vcs[i] = new VirtualChannel(i);
     }
+
+    m_occupied_vcs.resize((m_num_vcs + 63) / 64, 0);
+    m_num_occupied_vcs = 0;
 }
 
 InputUnit::~InputUnit()
@@ -112,6 +116,10 @@ InputUnit::wakeup()
 
 
         // Buffer the flit
+        if (m_vcs[vc]->isEmpty()) {
+            m_occupied_vcs[vc / 64] |= ULL(1) << (vc % 64);
+            m_num_occupied_vcs++;
+        }
         m_vcs[vc]->insertFlit(t_flit);
 
         int vnet = vc/m_vc_per_vnet;
@@ -139,14 +147,32 @@ InputUnit::wakeup()
     }
 }
 
+int
+InputUnit::next_occupied_vc(int vc) const
+{
+    if (vc >= m_num_vcs) {
+        return m_num_vcs;
+    }
+    int i = vc / 64;
+    uint64_t word = m_occupied_vcs[i] & ~mask(vc % 64);
+    while (word == 0) {
+        if (++i == m_occupied_vcs.size()) {
+            return m_num_vcs;
+        }
+        word = m_occupied_vcs[i];
+    }
+    return i * 64 + findLsbSet(word);
+}
+
 // Send a credit back to upstream router for this VC.
 // Called by SwitchAllocator when the flit in this VC wins the Switch.
 void
 InputUnit::increment_credit(int in_vc, bool free_signal, Cycles curTime)
 {
-    Credit *t_credit = new Credit(in_vc, free_signal, curTime);
+    Credit *t_credit = m_router->newCredit(in_vc, free_signal, curTime);
     creditQueue->insert(t_credit);
-    m_credit_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+    m_router->schedule_consumer(m_credit_link,
+                                m_router->clockEdge(Cycles(1)));
 }
 
 
@@ -109,9 +109,22 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return m_vcs[vc]->getTopFlit();
+        flit *t_flit = m_vcs[vc]->getTopFlit();
+        if (m_vcs[vc]->isEmpty()) {
+            m_occupied_vcs[vc / 64] &= ~(ULL(1) << (vc % 64));
+            m_num_occupied_vcs--;
+        }
+        return t_flit;
     }
 
+    // Are there flits buffered in any VC of this port?
+    inline bool has_occupied_vc() const { return m_num_occupied_vcs > 0; }
+
+    // Returns the first VC at or after vc that buffers a flit, or
+    // m_num_vcs if there is none. Used by the switch allocator so that
+    // it only evaluates occupied VCs.
+    int next_occupied_vc(int vc) const;
+
     inline bool
     need_stage(int vc, flit_stage stage, Cycles time)
     {
@@ -162,6 +175,10 @@ class InputUnit : public Consumer
     // Input Virtual channels
     std::vector<VirtualChannel *> m_vcs;
 
+    // Bitmask of the VCs that buffer at least one flit
+    std::vector<uint64_t> m_occupied_vcs;
+    int m_num_occupied_vcs;
+
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
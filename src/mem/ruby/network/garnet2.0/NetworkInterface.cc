@@ -72,6 +72,9 @@ NetworkInterface::NetworkInterface(const Params *p)
     }
 
     m_stall_count.resize(m_virtual_networks);
+    m_analytic_queue.resize(m_virtual_networks);
+    m_analytic_stalled.resize(m_virtual_networks, false);
+    m_replay_queue.resize(m_virtual_networks);
 }
 
 void
@@ -159,6 +162,11 @@ NetworkInterface::incrementStats(flit *t_flit)
         m_net_ptr->increment_received_packets(vnet);
         m_net_ptr->increment_packet_network_latency(network_delay, vnet);
         m_net_ptr->increment_packet_queueing_latency(queueing_delay, vnet);
+
+        // Calibrate the analytic model and account for the delivery
+        m_net_ptr->sampleDetailedPacket(network_delay,
+            t_flit->get_route().hops_traversed, t_flit->get_size());
+        m_net_ptr->packetDelivered();
     }
 
     // Hops
@@ -181,6 +189,11 @@ NetworkInterface::wakeup()
     DPRINTF(RubyNetwork, "Network Interface %d connected to router %d "
             "woke up at time: %lld\n", m_id, m_router_id, curCycle());
 
+    if (m_net_ptr->isAnalyticMode()) {
+        analyticWakeup();
+        return;
+    }
+
     MsgPtr msg_ptr;
     Tick curTime = clockEdge();
 
@@ -200,6 +213,14 @@ NetworkInterface::wakeup()
         }
     }
 
+    // Messages injected by the network trace replayer
+    for (int vnet = 0; vnet < m_replay_queue.size(); ++vnet) {
+        std::deque<MsgPtr> &queue = m_replay_queue[vnet];
+        if (!queue.empty() && flitisizeMessage(queue.front(), vnet)) {
+            queue.pop_front();
+        }
+    }
+
     scheduleOutputLink();
     checkReschedule();
 
@@ -217,10 +238,9 @@ NetworkInterface::wakeup()
         // space is available. Otherwise, exchange non-tail flits for credits.
         if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
             if (!messageEnqueuedThisCycle &&
-                outNode_ptr[vnet]->areNSlotsAvailable(1, curTime)) {
+                canDeliver(t_flit->get_msg_ptr(), vnet, curTime)) {
                 // Space is available. Enqueue to protocol buffer.
-                outNode_ptr[vnet]->enqueue(t_flit->get_msg_ptr(), curTime,
-                                           cyclesToTicks(Cycles(1)));
+                deliver(t_flit->get_msg_ptr(), vnet, curTime);
 
                 // Simply send a credit back since we are not buffering
                 // this flit in the NI
@@ -228,7 +248,7 @@ NetworkInterface::wakeup()
 
                 // Update stats and delete flit pointer
                 incrementStats(t_flit);
-                delete t_flit;
+                m_net_ptr->recycleFlit(t_flit);
             } else {
                 // No space available- Place tail flit in stall queue and set
                 // up a callback for when protocol buffer is dequeued. Stat
@@ -245,35 +265,192 @@ NetworkInterface::wakeup()
 
             // Update stats and delete flit pointer.
             incrementStats(t_flit);
-            delete t_flit;
+            m_net_ptr->recycleFlit(t_flit);
         }
     }
 
     /****************** Check the incoming credit link *******/
 
+    receiveCredit();
+
+
+    // It is possible to enqueue multiple outgoing credit flits if a message
+    // was unstalled in the same cycle as a new message arrives. In this
+    // case, we should schedule another wakeup to ensure the credit is sent
+    // back.
+    if (outCreditQueue->getSize() > 0) {
+        outCreditLink->scheduleEventAbsolute(clockEdge(Cycles(1)));
+    }
+}
+
+void
+NetworkInterface::receiveCredit()
+{
     if (inCreditLink->isReady(curCycle())) {
         Credit *t_credit = (Credit*) inCreditLink->consumeLink();
         m_out_vc_state[t_credit->get_vc()]->increment_credit();
         if (t_credit->is_free_signal()) {
             m_out_vc_state[t_credit->get_vc()]->setState(IDLE_, curCycle());
         }
-        delete t_credit;
+        m_net_ptr->recycleCredit(t_credit);
     }
+}
 
+/*
+ * In the analytic network model, the NI hands each message from the
+ * protocol straight to the destination NI, which delivers it once its
+ * estimated latency has elapsed. Routers and links are not used.
+ * Credits still in flight from the last detailed period are collected.
+ */
 
-    // It is possible to enqueue multiple outgoing credit flits if a message
-    // was unstalled in the same cycle as a new message arrives. In this
-    // case, we should schedule another wakeup to ensure the credit is sent
-    // back.
-    if (outCreditQueue->getSize() > 0) {
-        outCreditLink->scheduleEventAbsolute(clockEdge(Cycles(1)));
+void
+NetworkInterface::analyticWakeup()
+{
+    Tick curTime = clockEdge();
+
+    for (int vnet = 0; vnet < inNode_ptr.size(); ++vnet) {
+        MessageBuffer *b = inNode_ptr[vnet];
+        if (b != nullptr && b->isReady(curTime)) {
+            sendAnalytic(b->peekMsgPtr(), vnet);
+            b->dequeue(curTime);
+        }
+    }
+
+    for (int vnet = 0; vnet < m_replay_queue.size(); ++vnet) {
+        std::deque<MsgPtr> &queue = m_replay_queue[vnet];
+        if (!queue.empty()) {
+            sendAnalytic(queue.front(), vnet);
+            queue.pop_front();
+        }
+    }
+    checkReschedule();
+
+    // Deliver at most one message per vnet and cycle
+    for (int vnet = 0; vnet < m_analytic_queue.size(); ++vnet) {
+        std::deque<AnalyticMessage> &queue = m_analytic_queue[vnet];
+        if (queue.empty() || queue.front().ready > curCycle())
+            continue;
+
+        if (!canDeliver(queue.front().msg_ptr, vnet, curTime)) {
+            if (!m_analytic_stalled[vnet]) {
+                m_analytic_stalled[vnet] = true;
+                auto cb = std::bind(&NetworkInterface::dequeueCallback, this);
+                outNode_ptr[vnet]->registerDequeueCallback(cb);
+            }
+            continue;
+        }
+
+        if (m_analytic_stalled[vnet]) {
+            m_analytic_stalled[vnet] = false;
+            outNode_ptr[vnet]->unregisterDequeueCallback();
+        }
+
+        AnalyticMessage &m = queue.front();
+        deliver(m.msg_ptr, vnet, curTime);
+
+        Cycles queueing_delay = m.src_delay + (curCycle() - m.ready);
+        for (int i = 0; i < m.num_flits; i++) {
+            m_net_ptr->increment_received_flits(vnet);
+            m_net_ptr->increment_flit_network_latency(m.latency, vnet);
+            m_net_ptr->increment_flit_queueing_latency(queueing_delay, vnet);
+            m_net_ptr->increment_total_hops(m.hops);
+        }
+        m_net_ptr->increment_received_packets(vnet);
+        m_net_ptr->increment_packet_network_latency(m.latency, vnet);
+        m_net_ptr->increment_packet_queueing_latency(queueing_delay, vnet);
+        m_net_ptr->increment_analytic_packets(vnet);
+        m_net_ptr->packetDelivered();
+
+        queue.pop_front();
+        if (!queue.empty()) {
+            Cycles next = std::max(queue.front().ready,
+                                   curCycle() + Cycles(1));
+            scheduleEventAbsolute(clockEdge(next - curCycle()));
+        }
+    }
+
+    receiveCredit();
+}
+
+void
+NetworkInterface::sendAnalytic(MsgPtr msg_ptr, int vnet)
+{
+    Message *net_msg_ptr = msg_ptr.get();
+    vector<NodeID> dest_nodes = net_msg_ptr->getDestination().getAllDest();
+    int num_flits = getNumFlits(net_msg_ptr);
+    Cycles src_delay = curCycle() - ticksToCycles(msg_ptr->getTime());
+
+    // Multicast messages are converted into unicast messages
+    for (int ctr = 0; ctr < dest_nodes.size(); ctr++) {
+        MsgPtr new_msg_ptr = msg_ptr->clone();
+        NodeID destID = dest_nodes[ctr];
+
+        if (dest_nodes.size() > 1) {
+            NetDest personal_dest;
+            personal_dest.add(NetDest::nodeToMachineID(destID));
+            new_msg_ptr->getDestination() = personal_dest;
+        }
+
+        m_net_ptr->traceInjection(m_id, destID, vnet, new_msg_ptr);
+
+        int dest_router = m_net_ptr->get_router_id(destID);
+        int hops = m_net_ptr->routerHops(m_router_id, dest_router);
+        Cycles latency =
+            m_net_ptr->analyticLatency(m_router_id, dest_router, num_flits);
+
+        m_net_ptr->increment_injected_packets(vnet);
+        for (int i = 0; i < num_flits; i++)
+            m_net_ptr->increment_injected_flits(vnet);
+        m_net_ptr->packetInjected();
+
+        m_net_ptr->getNetworkInterface(destID)->enqueueAnalytic(new_msg_ptr,
+            vnet, curCycle() + latency, latency, src_delay, num_flits, hops);
+    }
+}
+
+void
+NetworkInterface::enqueueAnalytic(MsgPtr msg_ptr, int vnet, Cycles ready,
+                                  Cycles latency, Cycles src_delay,
+                                  int num_flits, int hops)
+{
+    std::deque<AnalyticMessage> &queue = m_analytic_queue[vnet];
+    if (!queue.empty())
+        ready = std::max(ready, queue.back().ready);
+
+    queue.push_back({msg_ptr, ready, latency, src_delay, num_flits, hops});
+    scheduleEventAbsolute(clockEdge(ready - curCycle()));
+}
+
+void
+NetworkInterface::injectReplay(MsgPtr msg_ptr, int vnet)
+{
+    m_replay_queue[vnet].push_back(msg_ptr);
+    scheduleEvent(Cycles(1));
+}
+
+bool
+NetworkInterface::canDeliver(const MsgPtr &msg_ptr, int vnet, Tick curTime)
+{
+    // Replayed messages never wait for the protocol
+    return m_net_ptr->isReplayMessage(msg_ptr) ||
+        outNode_ptr[vnet]->areNSlotsAvailable(1, curTime);
+}
+
+void
+NetworkInterface::deliver(const MsgPtr &msg_ptr, int vnet, Tick curTime)
+{
+    m_net_ptr->traceDelivery(m_id, msg_ptr);
+    if (!m_net_ptr->replayDelivery(msg_ptr)) {
+        outNode_ptr[vnet]->enqueue(msg_ptr, curTime,
+                                   cyclesToTicks(Cycles(1)));
     }
 }
 
 void
 NetworkInterface::sendCredit(flit *t_flit, bool is_free)
 {
-    Credit *credit_flit = new Credit(t_flit->get_vc(), is_free, curCycle());
+    Credit *credit_flit =
+        m_net_ptr->newCredit(t_flit->get_vc(), is_free, curCycle());
     outCreditQueue->insert(credit_flit);
 }
 
@@ -290,9 +467,8 @@ NetworkInterface::checkStallQueue()
             int vnet = stallFlit->get_vnet();
 
             // If we can now eject to the protocol buffer, send back credits
-            if (outNode_ptr[vnet]->areNSlotsAvailable(1, curTime)) {
-                outNode_ptr[vnet]->enqueue(stallFlit->get_msg_ptr(), curTime,
-                                           cyclesToTicks(Cycles(1)));
+            if (canDeliver(stallFlit->get_msg_ptr(), vnet, curTime)) {
+                deliver(stallFlit->get_msg_ptr(), vnet, curTime);
 
                 // Send back a credit with free signal now that the VC is no
                 // longer stalled.
@@ -302,7 +478,7 @@ NetworkInterface::checkStallQueue()
                 incrementStats(stallFlit);
 
                 // Flit can now safely be deleted and removed from stall queue
-                delete stallFlit;
+                m_net_ptr->recycleFlit(stallFlit);
                 m_stall_queue.erase(stallIter);
                 m_stall_count[vnet]--;
 
@@ -322,6 +498,15 @@ NetworkInterface::checkStallQueue()
     return messageEnqueuedThisCycle;
 }
 
+// Number of flits is dependent on the link bandwidth available.
+// This is expressed in terms of bytes/cycle or the flit size
+int
+NetworkInterface::getNumFlits(Message *net_msg_ptr)
+{
+    return (int) ceil((double) m_net_ptr->MessageSizeType_to_int(
+        net_msg_ptr->getMessageSize())/m_net_ptr->getNiFlitSize());
+}
+
 // Embed the protocol message into flits
 bool
 NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
@@ -332,10 +517,7 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
     // gets all the destinations associated with this message.
     vector<NodeID> dest_nodes = net_msg_dest.getAllDest();
 
-    // Number of flits is dependent on the link bandwidth available.
-    // This is expressed in terms of bytes/cycle or the flit size
-    int num_flits = (int) ceil((double) m_net_ptr->MessageSizeType_to_int(
-        net_msg_ptr->getMessageSize())/m_net_ptr->getNiFlitSize());
+    int num_flits = getNumFlits(net_msg_ptr);
 
     // loop to convert all multicast messages into unicast messages
     for (int ctr = 0; ctr < dest_nodes.size(); ctr++) {
@@ -351,18 +533,10 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
 
         Message *new_net_msg_ptr = new_msg_ptr.get();
         if (dest_nodes.size() > 1) {
+            // calculating the NetDest associated with this destID
             NetDest personal_dest;
-            for (int m = 0; m < (int) MachineType_NUM; m++) {
-                if ((destID >= MachineType_base_number((MachineType) m)) &&
-                    destID < MachineType_base_number((MachineType) (m+1))) {
-                    // calculating the NetDest associated with this destID
-                    personal_dest.clear();
-                    personal_dest.add((MachineID) {(MachineType) m, (destID -
-                        MachineType_base_number((MachineType) m))});
-                    new_net_msg_ptr->getDestination() = personal_dest;
-                    break;
-                }
-            }
+            personal_dest.add(NetDest::nodeToMachineID(destID));
+            new_net_msg_ptr->getDestination() = personal_dest;
             net_msg_dest.removeNetDest(personal_dest);
             // removing the destination from the original message to reflect
             // that a message with this particular destination has been
@@ -381,6 +555,8 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         route.dest_ni = destID;
         route.dest_router = m_net_ptr->get_router_id(destID);
 
+        m_net_ptr->traceInjection(m_id, destID, vnet, new_msg_ptr);
+
         // initialize hops_traversed to -1
         // so that the first router increments it to 0
         route.hops_traversed = -1;
@@ -388,8 +564,8 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         m_net_ptr->increment_injected_packets(vnet);
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
-            flit *fl = new flit(i, vc, vnet, route, num_flits, new_msg_ptr,
-                curCycle());
+            flit *fl = m_net_ptr->newFlit(i, vc, vnet, route, num_flits,
+                                          new_msg_ptr, curCycle());
 
             fl->set_src_delay(curCycle() - ticksToCycles(msg_ptr->getTime()));
             m_ni_out_vcs[vc]->insert(fl);
@@ -397,6 +573,7 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
 
         m_ni_out_vcs_enqueue_time[vc] = curCycle();
         m_out_vc_state[vc]->setState(ACTIVE_, curCycle());
+        m_net_ptr->packetInjected();
     }
     return true ;
 }
@@ -516,6 +693,13 @@ NetworkInterface::checkReschedule()
         }
     }
 
+    for (const auto& queue : m_replay_queue) {
+        if (!queue.empty()) {
+            scheduleEvent(Cycles(1));
+            return;
+        }
+    }
+
     for (int vc = 0; vc < m_num_vcs; vc++) {
         if (m_ni_out_vcs[vc]->isReady(curCycle() + Cycles(1))) {
             scheduleEvent(Cycles(1));
@@ -539,6 +723,13 @@ NetworkInterface::functionalWrite(Packet *pkt)
     }
 
     num_functional_writes += outFlitQueue->functionalWrite(pkt);
+
+    for (auto &queue : m_analytic_queue) {
+        for (auto &m : queue) {
+            if (m.msg_ptr->functionalWrite(pkt))
+                num_functional_writes++;
+        }
+    }
     return num_functional_writes;
 }
 
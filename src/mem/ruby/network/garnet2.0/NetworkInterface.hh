@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_NETWORK_INTERFACE_HH__
 #define __MEM_RUBY_NETWORK_GARNET_NETWORK_INTERFACE_HH__
 
+#include <deque>
 #include <iostream>
 #include <vector>
 
@@ -74,6 +75,16 @@ class NetworkInterface : public ClockedObject, public Consumer
 
     uint32_t functionalWrite(Packet *);
 
+    // Analytic network model: a message scheduled for delivery to the
+    // protocol of this NI at cycle ready
+    void enqueueAnalytic(MsgPtr msg_ptr, int vnet, Cycles ready,
+                         Cycles latency, Cycles src_delay, int num_flits,
+                         int hops);
+
+    // Inject a message of a replayed network trace, as if it came from
+    // the protocol
+    void injectReplay(MsgPtr msg_ptr, int vnet);
+
   private:
     GarnetNetwork *m_net_ptr;
     const NodeID m_id;
@@ -107,8 +118,33 @@ class NetworkInterface : public ClockedObject, public Consumer
     // When a vc stays busy for a long time, it indicates a deadlock
     std::vector<int> vc_busy_counter;
 
+    struct AnalyticMessage
+    {
+        MsgPtr msg_ptr;
+        Cycles ready;
+        Cycles latency;
+        Cycles src_delay;
+        int num_flits;
+        int hops;
+    };
+
+    // Messages of the analytic model awaiting delivery, per vnet.
+    // Delivery times are kept non-decreasing so that ordered vnets stay
+    // ordered.
+    std::vector<std::deque<AnalyticMessage>> m_analytic_queue;
+    std::vector<bool> m_analytic_stalled;
+
+    // Messages of a replayed network trace awaiting injection, per vnet
+    std::vector<std::deque<MsgPtr>> m_replay_queue;
+
     bool checkStallQueue();
+    bool canDeliver(const MsgPtr &msg_ptr, int vnet, Tick curTime);
+    void deliver(const MsgPtr &msg_ptr, int vnet, Tick curTime);
     bool flitisizeMessage(MsgPtr msg_ptr, int vnet);
+    int getNumFlits(Message *net_msg_ptr);
+    void analyticWakeup();
+    void sendAnalytic(MsgPtr msg_ptr, int vnet);
+    void receiveCredit();
     int calculateVC(int vnet);
 
     void scheduleOutputLink();
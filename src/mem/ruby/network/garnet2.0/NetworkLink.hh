@@ -52,6 +52,9 @@ class NetworkLink : public ClockedObject, public Consumer
     NetworkLink(const Params *p);
     ~NetworkLink();
 
+    const Params *params() const
+    { return dynamic_cast<const Params *>(_params); }
+
     void setLinkConsumer(Consumer *consumer);
     void setSourceQueue(flitBuffer *srcQueue);
     void setType(link_type type) { m_type = type; }
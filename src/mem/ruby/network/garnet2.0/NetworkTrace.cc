@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
+#include "proto/network_trace.pb.h"
+#include "proto/protoio.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+NetworkTraceRecorder::NetworkTraceRecorder(GarnetNetwork *net,
+                                           const string &filename)
+    : m_net(net), m_stream(NULL), m_seq_num(0),
+      m_last_delivery(net->getNumNodes()),
+      m_delivered(net->getNumNodes(), false)
+{
+    // If the trace file is not specified as an absolute path, place it
+    // in the current simulation output directory
+    m_stream = new ProtoOutputStream(simout.resolve(filename));
+
+    ProtoMessage::NetworkTraceHeader header_msg;
+    header_msg.set_obj_id(net->name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+    header_msg.set_num_nodes(net->getNumNodes());
+    header_msg.set_num_vnets(net->getNumberOfVirtualNetworks());
+    m_stream->write(header_msg);
+}
+
+NetworkTraceRecorder::~NetworkTraceRecorder()
+{
+    close();
+}
+
+void
+NetworkTraceRecorder::close()
+{
+    delete m_stream;
+    m_stream = NULL;
+}
+
+void
+NetworkTraceRecorder::injected(NodeID src, NodeID dest, int vnet,
+                               const Message *msg)
+{
+    if (m_stream == NULL) {
+        return;
+    }
+
+    const MessageSizeType size = msg->getMessageSize();
+
+    ProtoMessage::NetworkTraceRecord rec_msg;
+    rec_msg.set_seq_num(m_seq_num);
+    rec_msg.set_tick(curTick());
+    rec_msg.set_src(src);
+    rec_msg.set_dest(dest);
+    rec_msg.set_vnet(vnet);
+    rec_msg.set_size_type(size);
+    rec_msg.set_size(Network::MessageSizeType_to_int(size));
+    if (m_delivered[src]) {
+        rec_msg.add_dep(m_last_delivery[src].seq_num);
+        rec_msg.set_delay(curTick() - m_last_delivery[src].tick);
+    }
+    m_stream->write(rec_msg);
+
+    m_in_flight[msg] = m_seq_num++;
+}
+
+void
+NetworkTraceRecorder::delivered(NodeID dest, const Message *msg)
+{
+    auto it = m_in_flight.find(msg);
+    if (it == m_in_flight.end()) {
+        return;
+    }
+
+    m_last_delivery[dest] = { it->second, curTick() };
+    m_delivered[dest] = true;
+    m_in_flight.erase(it);
+}
+
+NetworkTraceMessage::NetworkTraceMessage(Tick curTime, uint64_t seq_num,
+                                         NodeID dest, MessageSizeType size)
+    : Message(curTime), m_seq_num(seq_num), m_size(size)
+{
+    m_dest.add(NetDest::nodeToMachineID(dest));
+}
+
+MsgPtr
+NetworkTraceMessage::clone() const
+{
+    return std::make_shared<NetworkTraceMessage>(*this);
+}
+
+void
+NetworkTraceMessage::print(ostream &out) const
+{
+    out << "[NetworkTraceMessage: seq_num=" << m_seq_num
+        << " dest=" << m_dest << " size=" << m_size << "]";
+}
+
+NetworkTraceReplayer::NetworkTraceReplayer(GarnetNetwork *net,
+                                           const string &filename,
+                                           unsigned window, unsigned history)
+    : m_net(net), m_stream(NULL), m_window(window), m_history(history),
+      m_trace_done(false), m_trace_start(MaxTick), m_replay_start(0),
+      m_next_seq_num(0), m_in_flight(0), m_event(this)
+{
+    fatal_if(m_window == 0, "%s: the replay window must hold at least "
+             "one record\n", net->name());
+
+    m_stream = new ProtoInputStream(filename);
+
+    ProtoMessage::NetworkTraceHeader header_msg;
+    if (!m_stream->read(header_msg)) {
+        fatal("%s: could not read the header of network trace %s\n",
+              net->name(), filename);
+    }
+    fatal_if(header_msg.tick_freq() != SimClock::Frequency,
+             "%s: network trace %s was recorded with a tick frequency of "
+             "%d, the simulation uses %d\n", net->name(), filename,
+             header_msg.tick_freq(), SimClock::Frequency);
+    fatal_if(header_msg.num_nodes() > net->getNumNodes() ||
+             header_msg.num_vnets() > net->getNumberOfVirtualNetworks(),
+             "%s: network trace %s needs %d interfaces and %d vnets, the "
+             "network has %d and %d\n", net->name(), filename,
+             header_msg.num_nodes(), header_msg.num_vnets(),
+             net->getNumNodes(), net->getNumberOfVirtualNetworks());
+}
+
+NetworkTraceReplayer::~NetworkTraceReplayer()
+{
+    if (m_event.scheduled()) {
+        m_net->deschedule(m_event);
+    }
+    delete m_stream;
+}
+
+string
+NetworkTraceReplayer::name() const
+{
+    return m_net->name() + ".replayer";
+}
+
+void
+NetworkTraceReplayer::start()
+{
+    m_replay_start = curTick();
+    wakeup(curTick());
+}
+
+void
+NetworkTraceReplayer::fill()
+{
+    while (!m_trace_done && m_pending.size() < m_window) {
+        ProtoMessage::NetworkTraceRecord rec_msg;
+        if (!m_stream->read(rec_msg)) {
+            m_trace_done = true;
+            break;
+        }
+
+        fatal_if(rec_msg.size_type() >= MessageSizeType_NUM,
+                 "%s: network trace record %d has an unknown size\n",
+                 m_net->name(), rec_msg.seq_num());
+
+        Record rec;
+        rec.seq_num = rec_msg.seq_num();
+        rec.tick = rec_msg.tick();
+        rec.src = rec_msg.src();
+        rec.dest = rec_msg.dest();
+        rec.vnet = rec_msg.vnet();
+        rec.size = MessageSizeType(rec_msg.size_type());
+        rec.deps.assign(rec_msg.dep().begin(), rec_msg.dep().end());
+        rec.delay = rec_msg.delay();
+
+        if (m_trace_start == MaxTick) {
+            m_trace_start = rec.tick;
+        }
+        for (auto dep : rec.deps) {
+            m_dep_refs[dep]++;
+        }
+        m_undelivered.insert(rec.seq_num);
+        m_next_seq_num = std::max(m_next_seq_num, rec.seq_num + 1);
+        m_pending.push_back(rec);
+    }
+}
+
+bool
+NetworkTraceReplayer::readyTime(const Record &rec, Tick &when) const
+{
+    if (rec.deps.empty()) {
+        when = m_replay_start + (rec.tick - m_trace_start);
+        return true;
+    }
+
+    Tick last = 0;
+    bool forgotten = false;
+    for (auto dep : rec.deps) {
+        auto it = m_delivered.find(dep);
+        if (it != m_delivered.end()) {
+            last = std::max(last, it->second);
+        } else if (m_undelivered.count(dep)) {
+            return false;
+        } else {
+            // delivered too long ago to be remembered
+            forgotten = true;
+        }
+    }
+
+    if (forgotten) {
+        when = m_replay_start + (rec.tick - m_trace_start);
+    } else {
+        when = last + rec.delay;
+    }
+    return true;
+}
+
+void
+NetworkTraceReplayer::inject(const Record &rec)
+{
+    MsgPtr msg = std::make_shared<NetworkTraceMessage>(curTick(),
+        rec.seq_num, rec.dest, rec.size);
+    m_net->getNetworkInterface(rec.src)->injectReplay(msg, rec.vnet);
+    m_in_flight++;
+
+    for (auto dep : rec.deps) {
+        auto it = m_dep_refs.find(dep);
+        assert(it != m_dep_refs.end());
+        if (--it->second == 0) {
+            m_dep_refs.erase(it);
+        }
+    }
+}
+
+void
+NetworkTraceReplayer::prune()
+{
+    // the deliveries are ordered by sequence number, so stop at the
+    // first one within the history
+    for (auto it = m_delivered.begin(); it != m_delivered.end() &&
+             it->first + m_history < m_next_seq_num; ) {
+        if (m_dep_refs.count(it->first)) {
+            ++it;
+        } else {
+            it = m_delivered.erase(it);
+        }
+    }
+}
+
+void
+NetworkTraceReplayer::process()
+{
+    Tick next = MaxTick;
+    bool injected;
+
+    // Injecting frees room in the window, so read on until nothing more
+    // can go out this tick
+    do {
+        fill();
+        injected = false;
+        next = MaxTick;
+        for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+            Tick when;
+            if (!readyTime(*it, when)) {
+                ++it;
+            } else if (when <= curTick()) {
+                inject(*it);
+                it = m_pending.erase(it);
+                injected = true;
+            } else {
+                next = std::min(next, when);
+                ++it;
+            }
+        }
+    } while (injected && !m_trace_done);
+
+    if (m_trace_done && m_pending.empty() && m_in_flight == 0) {
+        exitSimLoop("network trace replay complete");
+        return;
+    }
+
+    // Records waiting for a delivery are woken up by delivered()
+    if (next != MaxTick) {
+        wakeup(m_net->clockEdge(m_net->ticksToCycles(next - curTick())));
+    }
+}
+
+void
+NetworkTraceReplayer::wakeup(Tick when)
+{
+    if (!m_event.scheduled()) {
+        m_net->schedule(m_event, when);
+    } else if (when < m_event.when()) {
+        m_net->reschedule(m_event, when);
+    }
+}
+
+bool
+NetworkTraceReplayer::delivered(const MsgPtr &msg)
+{
+    const NetworkTraceMessage *trace_msg =
+        dynamic_cast<const NetworkTraceMessage *>(msg.get());
+    if (trace_msg == NULL) {
+        return false;
+    }
+
+    m_delivered[trace_msg->getSeqNum()] = curTick();
+    m_undelivered.erase(trace_msg->getSeqNum());
+    assert(m_in_flight > 0);
+    m_in_flight--;
+    prune();
+
+    wakeup(m_net->clockEdge(Cycles(1)));
+    return true;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/*
+ * Capture and replay of the messages injected into a garnet network.
+ *
+ * The recorder writes one NetworkTraceRecord (see network_trace.proto)
+ * per unicast message an interface injects. A message depends on the
+ * last message delivered to its source interface before the injection,
+ * which captures the request-response chains of the protocol without
+ * knowing about it.
+ *
+ * The replayer feeds such a trace into a network with the same number of
+ * interfaces, bypassing the protocol controllers. Records without
+ * dependencies keep their time relative to the start of the trace; the
+ * others are injected once their dependencies have been delivered, after
+ * the recorded delay. The simulation exits when the whole trace has been
+ * delivered. The delivery of a message is remembered while records read
+ * ahead depend on it, and for a history of sequence numbers after it;
+ * records depending on a forgotten delivery are injected at their tick.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_NETWORK_TRACE_HH__
+#define __MEM_RUBY_NETWORK_GARNET_NETWORK_TRACE_HH__
+
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/protocol/MessageSizeType.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/common/TypeDefines.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "sim/eventq.hh"
+
+class GarnetNetwork;
+class ProtoInputStream;
+class ProtoOutputStream;
+
+class NetworkTraceRecorder
+{
+  public:
+    NetworkTraceRecorder(GarnetNetwork *net, const std::string &filename);
+    ~NetworkTraceRecorder();
+
+    void injected(NodeID src, NodeID dest, int vnet, const Message *msg);
+    void delivered(NodeID dest, const Message *msg);
+
+    /** Flush and close the output stream. */
+    void close();
+
+  private:
+    struct Delivery
+    {
+        uint64_t seq_num;
+        Tick tick;
+    };
+
+    GarnetNetwork *m_net;
+    ProtoOutputStream *m_stream;
+    uint64_t m_seq_num;
+
+    //! Sequence numbers of the traced messages still in the network
+    std::unordered_map<const Message *, uint64_t> m_in_flight;
+    //! Last message delivered to every interface
+    std::vector<Delivery> m_last_delivery;
+    std::vector<bool> m_delivered;
+};
+
+/** The message injected for a replayed record */
+class NetworkTraceMessage : public Message
+{
+  public:
+    NetworkTraceMessage(Tick curTime, uint64_t seq_num, NodeID dest,
+                        MessageSizeType size);
+
+    MsgPtr clone() const override;
+    void print(std::ostream &out) const override;
+
+    const MessageSizeType &getMessageSize() const override { return m_size; }
+    MessageSizeType &getMessageSize() override { return m_size; }
+    const NetDest &getDestination() const override { return m_dest; }
+    NetDest &getDestination() override { return m_dest; }
+
+    bool functionalRead(Packet *pkt) override { return false; }
+    bool functionalWrite(Packet *pkt) override { return false; }
+
+    uint64_t getSeqNum() const { return m_seq_num; }
+
+  private:
+    uint64_t m_seq_num;
+    MessageSizeType m_size;
+    NetDest m_dest;
+};
+
+class NetworkTraceReplayer
+{
+  public:
+    NetworkTraceReplayer(GarnetNetwork *net, const std::string &filename,
+                         unsigned window, unsigned history);
+    ~NetworkTraceReplayer();
+
+    /** Start injecting at the current tick */
+    void start();
+
+    std::string name() const;
+
+    /**
+     * A message left the network. Returns true if it was injected by the
+     * replayer, which then consumes it.
+     */
+    bool delivered(const MsgPtr &msg);
+
+    /** Was the message injected by the replayer? */
+    static bool
+    isReplayed(const MsgPtr &msg)
+    {
+        return dynamic_cast<const NetworkTraceMessage *>(msg.get()) != NULL;
+    }
+
+  private:
+    struct Record
+    {
+        uint64_t seq_num;
+        Tick tick;
+        NodeID src;
+        NodeID dest;
+        int vnet;
+        MessageSizeType size;
+        std::vector<uint64_t> deps;
+        Tick delay;
+    };
+
+    /** Read records until the window is full or the trace ends */
+    void fill();
+
+    /**
+     * Tick at which a record may be injected. Returns false while one of
+     * its dependencies is still in the network.
+     */
+    bool readyTime(const Record &rec, Tick &when) const;
+
+    void inject(const Record &rec);
+    void process();
+
+    /**
+     * Forget the deliveries no record read ahead depends on, once they
+     * are older than the history.
+     */
+    void prune();
+    void wakeup(Tick when);
+
+    GarnetNetwork *m_net;
+    ProtoInputStream *m_stream;
+    const unsigned m_window;
+    const unsigned m_history;
+    bool m_trace_done;
+
+    //! Tick of the first record, and the tick the replay started at
+    Tick m_trace_start;
+    Tick m_replay_start;
+
+    //! Records read from the trace that are not injected yet
+    std::deque<Record> m_pending;
+    //! Sequence number following the last record read
+    uint64_t m_next_seq_num;
+    //! Records read from the trace that are not delivered yet
+    std::unordered_set<uint64_t> m_undelivered;
+    //! Delivery tick of the replayed messages that are remembered
+    std::map<uint64_t, Tick> m_delivered;
+    //! Records not injected yet depending on each message
+    std::unordered_map<uint64_t, unsigned> m_dep_refs;
+    uint64_t m_in_flight;
+
+    EventWrapper<NetworkTraceReplayer, &NetworkTraceReplayer::process>
+        m_event;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET_NETWORK_TRACE_HH__
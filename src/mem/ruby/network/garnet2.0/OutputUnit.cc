@@ -49,6 +49,7 @@ OutputUnit::OutputUnit(int id, PortDirection direction, Router *router)
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_vc_per_vnet = m_router->get_vc_per_vnet();
+    m_escape_vcs = m_router->get_net_ptr()->hasEscapeVCs();
     m_out_buffer = new flitBuffer();
 
     for (int i = 0; i < m_num_vcs; i++) {
@@ -94,11 +95,16 @@ OutputUnit::has_credit(int out_vc)
 
 
 // Check if the output port (i.e., input port at next router) has free VCs.
+// With escape VCs, the first VC of the vnet may only be used when the
+// packet follows the escape route (escape_allowed).
 bool
-OutputUnit::has_free_vc(int vnet)
+OutputUnit::has_free_vc(int vnet, bool escape_allowed, int vc_class)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+    int vc_first = (m_escape_vcs && !escape_allowed) ? vc_base + 1 : vc_base;
+    int vc_end = vc_base + m_vc_per_vnet;
+    restrict_to_class(vnet, vc_class, vc_first, vc_end);
+    for (int vc = vc_first; vc < vc_end; vc++) {
         if (is_vc_idle(vc, m_router->curCycle()))
             return true;
     }
@@ -107,20 +113,71 @@ OutputUnit::has_free_vc(int vnet)
 }
 
 // Assign a free output VC to the winner of Switch Allocation
+// The escape VC is handed out only when no adaptive VC is free.
 int
-OutputUnit::select_free_vc(int vnet)
+OutputUnit::select_free_vc(int vnet, bool escape_allowed, int vc_class)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+    int vc_first = m_escape_vcs ? vc_base + 1 : vc_base;
+    int vc_end = vc_base + m_vc_per_vnet;
+    restrict_to_class(vnet, vc_class, vc_first, vc_end);
+    for (int vc = vc_first; vc < vc_end; vc++) {
         if (is_vc_idle(vc, m_router->curCycle())) {
             m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
             return vc;
         }
     }
 
+    if (m_escape_vcs && escape_allowed &&
+        is_vc_idle(vc_base, m_router->curCycle())) {
+        m_outvc_state[vc_base]->setState(ACTIVE_, m_router->curCycle());
+        return vc_base;
+    }
+
     return -1;
 }
 
+// Class 0 owns the lower half of the VCs of the vnet, class 1 the rest
+void
+OutputUnit::restrict_to_class(int vnet, int vc_class, int &vc_first,
+                              int &vc_end)
+{
+    if (vc_class < 0)
+        return;
+
+    int vc_split = vnet*m_vc_per_vnet + m_vc_per_vnet/2;
+    if (vc_class == 0)
+        vc_end = vc_split;
+    else
+        vc_first = vc_split;
+}
+
+int
+OutputUnit::get_free_vc_count(int vnet)
+{
+    int vc_base = vnet*m_vc_per_vnet;
+    int vc_first = m_escape_vcs ? vc_base + 1 : vc_base;
+    int count = 0;
+    for (int vc = vc_first; vc < vc_base + m_vc_per_vnet; vc++) {
+        if (is_vc_idle(vc, m_router->curCycle()))
+            count++;
+    }
+
+    return count;
+}
+
+int
+OutputUnit::get_free_credit_count(int vnet)
+{
+    int vc_base = vnet*m_vc_per_vnet;
+    int vc_first = m_escape_vcs ? vc_base + 1 : vc_base;
+    int count = 0;
+    for (int vc = vc_first; vc < vc_base + m_vc_per_vnet; vc++)
+        count += m_outvc_state[vc]->get_credit_count();
+
+    return count;
+}
+
 /*
  * The wakeup function of the OutputUnit reads the credit signal from the
  * downstream router for the output VC (i.e., input VC at downstream router).
@@ -139,7 +196,7 @@ OutputUnit::wakeup()
         if (t_credit->is_free_signal())
             set_vc_state(IDLE_, t_credit->get_vc(), m_router->curCycle());
 
-        delete t_credit;
+        m_router->recycleCredit(t_credit);
     }
 }
 
@@ -58,8 +58,18 @@ class OutputUnit : public Consumer
     void decrement_credit(int out_vc);
     void increment_credit(int out_vc);
     bool has_credit(int out_vc);
-    bool has_free_vc(int vnet);
-    int select_free_vc(int vnet);
+    // vc_class >= 0 restricts the search to one half of the VCs of the
+    // vnet (the VC classes of generated tori and dragonflies)
+    bool has_free_vc(int vnet, bool escape_allowed = true,
+                     int vc_class = -1);
+    int select_free_vc(int vnet, bool escape_allowed = true,
+                       int vc_class = -1);
+
+    // Downstream resources used by adaptive routing to pick the least
+    // congested output port: idle VCs and credits of the vnet
+    // (excluding the escape VC, if any)
+    int get_free_vc_count(int vnet);
+    int get_free_credit_count(int vnet);
 
     inline PortDirection get_direction() { return m_direction; }
 
@@ -91,16 +101,21 @@ class OutputUnit : public Consumer
     insert_flit(flit *t_flit)
     {
         m_out_buffer->insert(t_flit);
-        m_out_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+        m_router->schedule_consumer(m_out_link,
+                                    m_router->clockEdge(Cycles(1)));
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
+    void restrict_to_class(int vnet, int vc_class, int &vc_first,
+                           int &vc_end);
+
     int m_id;
     PortDirection m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
+    bool m_escape_vcs;
     Router *m_router;
     NetworkLink *m_out_link;
     CreditLink *m_credit_link;
@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/Router.hh"
 
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -43,6 +44,7 @@
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
+#include "mem/ruby/system/RubySystem.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -70,6 +72,7 @@ Router::~Router()
     delete m_routing_unit;
     delete m_sw_alloc;
     delete m_switch;
+    deletePointers(m_free_credits);
 }
 
 void
@@ -83,6 +86,16 @@ Router::init()
 
 void
 Router::wakeup()
+{
+    if (m_network_ptr->isParallel()) {
+        m_network_ptr->activateRouter(this);
+    } else {
+        evaluate();
+    }
+}
+
+void
+Router::evaluate()
 {
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
 
@@ -164,6 +177,18 @@ Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+int
+Router::escape_route_compute(RouteInfo route)
+{
+    return m_routing_unit->outportComputeEscape(route);
+}
+
+int
+Router::vc_class_compute(const RouteInfo &route, int outport)
+{
+    return m_routing_unit->vcClass(route, outport);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
@@ -174,7 +199,52 @@ void
 Router::schedule_wakeup(Cycles time)
 {
     // wake up after time cycles
-    scheduleEvent(time);
+    schedule_consumer(this, clockEdge(time));
+}
+
+void
+Router::schedule_consumer(Consumer *consumer, Tick when)
+{
+    if (m_network_ptr->isParallel()) {
+        m_deferred_wakeups.push_back(make_pair(consumer, when));
+    } else {
+        consumer->scheduleEventAbsolute(when);
+    }
+}
+
+// Every router turns as many flits into credits as it forwards, so the
+// per-router free lists stay balanced without going through the network
+Credit *
+Router::newCredit(int vc, bool is_free_signal, Cycles curTime)
+{
+    if (!m_network_ptr->isParallel())
+        return m_network_ptr->newCredit(vc, is_free_signal, curTime);
+
+    if (m_free_credits.empty())
+        return new Credit(vc, is_free_signal, curTime);
+
+    Credit *t_credit = m_free_credits.back();
+    m_free_credits.pop_back();
+    t_credit->init(vc, is_free_signal, curTime);
+    return t_credit;
+}
+
+void
+Router::recycleCredit(Credit *t_credit)
+{
+    if (m_network_ptr->isParallel()) {
+        m_free_credits.push_back(t_credit);
+    } else {
+        m_network_ptr->recycleCredit(t_credit);
+    }
+}
+
+void
+Router::commitEvaluation()
+{
+    for (auto &wakeup : m_deferred_wakeups)
+        wakeup.first->scheduleEventAbsolute(wakeup.second);
+    m_deferred_wakeups.clear();
 }
 
 std::string
@@ -216,6 +286,51 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_outport_flits
+        .init(m_output_unit.size())
+        .name(name() + ".outport_flits")
+        .desc("Flits sent on each output port")
+        .flags(Stats::nozero)
+    ;
+
+    m_link_utilization
+        .init(m_output_unit.size())
+        .name(name() + ".link_utilization")
+        .desc("Flits per cycle sent on each output port")
+        .flags(Stats::nozero)
+    ;
+
+    for (int i = 0; i < m_output_unit.size(); i++) {
+        string dirn = getPortDirectionName(getOutportDirection(i));
+        m_outport_flits.subname(i, csprintf("%d_%s", i, dirn));
+        m_link_utilization.subname(i, csprintf("%d_%s", i, dirn));
+    }
+
+    m_packet_latency
+        .name(name() + ".packet_latency")
+        .desc("Cycles from head flit buffering to switch grant")
+        .flags(Stats::nozero)
+    ;
+
+    m_packets_switched
+        .name(name() + ".packets_switched")
+        .desc("Packets granted the switch")
+        .flags(Stats::nozero)
+    ;
+
+    m_avg_packet_latency
+        .name(name() + ".average_packet_latency")
+        .desc("Average cycles a packet spends in this router")
+        .flags(Stats::nozero)
+    ;
+    m_avg_packet_latency = m_packet_latency / m_packets_switched;
+
+    m_escape_reroutes
+        .name(name() + ".escape_reroutes")
+        .desc("Packets moved to the escape VC of the escape route")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -231,6 +346,61 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+
+    RubySystem *rs = m_network_ptr->params()->ruby_system;
+    double time_delta = double(curCycle() - rs->getStartCycle());
+
+    for (int i = 0; i < m_output_unit.size(); i++) {
+        double flits = m_sw_alloc->get_outport_flits(i);
+        m_outport_flits[i] = flits;
+        m_link_utilization[i] = time_delta > 0 ? flits / time_delta : 0;
+    }
+
+    m_packet_latency = m_sw_alloc->get_packet_latency();
+    m_packets_switched = m_sw_alloc->get_packets_switched();
+    m_escape_reroutes = m_sw_alloc->get_escape_reroutes();
+}
+
+double
+Router::get_buffer_reads()
+{
+    double reads = 0;
+    for (int j = 0; j < m_virtual_networks; j++) {
+        for (int i = 0; i < m_input_unit.size(); i++) {
+            reads += m_input_unit[i]->get_buf_read_activity(j);
+        }
+    }
+    return reads;
+}
+
+double
+Router::get_buffer_writes()
+{
+    double writes = 0;
+    for (int j = 0; j < m_virtual_networks; j++) {
+        for (int i = 0; i < m_input_unit.size(); i++) {
+            writes += m_input_unit[i]->get_buf_write_activity(j);
+        }
+    }
+    return writes;
+}
+
+double
+Router::get_sw_input_arbiter_activity()
+{
+    return m_sw_alloc->get_input_arbiter_activity();
+}
+
+double
+Router::get_sw_output_arbiter_activity()
+{
+    return m_sw_alloc->get_output_arbiter_activity();
+}
+
+double
+Router::get_crossbar_activity()
+{
+    return m_switch->get_crossbar_activity();
 }
 
 void
@@ -241,6 +411,8 @@ Router::resetStats()
             m_input_unit[i]->resetStats();
         }
     }
+
+    m_sw_alloc->resetStats();
 }
 
 void
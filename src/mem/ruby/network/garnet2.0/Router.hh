@@ -35,6 +35,7 @@
 #define __MEM_RUBY_NETWORK_GARNET_ROUTER_HH__
 
 #include <iostream>
+#include <utility>
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
@@ -63,6 +64,7 @@ class Router : public BasicRouter, public Consumer
     ~Router();
 
     void wakeup();
+    void evaluate();
     void print(std::ostream& out) const {};
 
     void init();
@@ -92,9 +94,20 @@ class Router : public BasicRouter, public Consumer
     PortDirection getInportDirection(int inport);
 
     int route_compute(RouteInfo route, int inport, PortDirection direction);
+    int escape_route_compute(RouteInfo route);
+    int vc_class_compute(const RouteInfo &route, int outport);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
+    // Everything the pipeline stages do outside of the router goes
+    // through these. While the routers are evaluated in parallel, the
+    // wakeups are held back until commitEvaluation(), and credits come
+    // from a free list owned by the router rather than by the network.
+    void schedule_consumer(Consumer *consumer, Tick when);
+    Credit *newCredit(int vc, bool is_free_signal, Cycles curTime);
+    void recycleCredit(Credit *t_credit);
+    void commitEvaluation();
+
     std::string getPortDirectionName(PortDirection direction);
     void printFaultVector(std::ostream& out);
     void printAggregateFaultProbability(std::ostream& out);
@@ -103,6 +116,13 @@ class Router : public BasicRouter, public Consumer
     void collateStats();
     void resetStats();
 
+    // Activity since the last stats reset, sampled by the power models
+    double get_buffer_reads();
+    double get_buffer_writes();
+    double get_sw_input_arbiter_activity();
+    double get_sw_output_arbiter_activity();
+    double get_crossbar_activity();
+
     // For Fault Model:
     bool get_fault_vector(int temperature, float fault_vector[]) {
         return m_network_ptr->fault_model->fault_vector(m_id, temperature,
@@ -127,6 +147,9 @@ class Router : public BasicRouter, public Consumer
     SwitchAllocator *m_sw_alloc;
     CrossbarSwitch *m_switch;
 
+    std::vector<std::pair<Consumer *, Tick>> m_deferred_wakeups;
+    std::vector<Credit *> m_free_credits;
+
     // Statistical variables required for power computations
     Stats::Scalar m_buffer_reads;
     Stats::Scalar m_buffer_writes;
@@ -135,6 +158,14 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    // Link utilization of each outport and latency through this router
+    Stats::Vector m_outport_flits;
+    Stats::Vector m_link_utilization;
+    Stats::Scalar m_packet_latency;
+    Stats::Scalar m_packets_switched;
+    Stats::Formula m_avg_packet_latency;
+    Stats::Scalar m_escape_reroutes;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET_ROUTER_HH__
@@ -35,10 +35,12 @@
 
 #include "base/cast.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
 RoutingUnit::RoutingUnit(Router *router)
+    : m_rng(router->get_id())
 {
     m_router = router;
     m_routing_table.clear();
@@ -65,7 +67,7 @@ RoutingUnit::addWeight(int link_weight)
  */
 
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(int vnet, const NetDest &msg_destination)
 {
     // First find all possible output link candidates
     // For ordered vnet, just choose the first
@@ -79,24 +81,21 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     std::vector<int> output_link_candidates;
     int num_candidates = 0;
 
-    // Identify the minimum weight among the candidate output links
+    // Collect all candidate output links with the minimum weight in a
+    // single pass, so each routing table entry is intersected only once
     for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
+        if (!msg_destination.intersectionIsNotEmpty(m_routing_table[link]))
+            continue;
 
-        if (m_weight_table[link] <= min_weight)
+        if (m_weight_table[link] < min_weight) {
             min_weight = m_weight_table[link];
+            output_link_candidates.clear();
+            num_candidates = 0;
         }
-    }
-
-    // Collect all candidate output links with this minimum weight
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
 
-            if (m_weight_table[link] == min_weight) {
-
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
+        if (m_weight_table[link] == min_weight) {
+            num_candidates++;
+            output_link_candidates.push_back(link);
         }
     }
 
@@ -107,8 +106,14 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
 
     // Randomly select any candidate output link
     int candidate = 0;
-    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+    // rand() is shared by all routers, which is not deterministic (nor
+    // safe) when they are evaluated in parallel
+    GarnetNetwork *net = m_router->get_net_ptr();
+    if (!net->isVNetOrdered(vnet)) {
+        candidate = net->isParallel() ?
+            m_rng.random<int>(0, num_candidates - 1) :
+            rand() % num_candidates;
+    }
 
     output_link = output_link_candidates.at(candidate);
     return output_link;
@@ -155,6 +160,13 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
     RoutingAlgorithm routing_algorithm =
         (RoutingAlgorithm) m_router->get_net_ptr()->getRoutingAlgorithm();
 
+    // Adaptive routes may reorder packets between a source and a
+    // destination, so ordered vnets always take the deterministic XY route
+    if (routing_algorithm >= WEST_FIRST_ &&
+        m_router->get_net_ptr()->isVNetOrdered(route.vnet)) {
+        return outportComputeEscape(route);
+    }
+
     switch (routing_algorithm) {
         case TABLE_:  outport =
             lookupRoutingTable(route.vnet, route.net_dest); break;
@@ -163,6 +175,12 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
+        case WEST_FIRST_: outport =
+            outportComputeWestFirst(route, inport, inport_dirn); break;
+        case ODD_EVEN_: outport =
+            outportComputeOddEven(route, inport, inport_dirn); break;
+        case ADAPTIVE_ESCAPE_: outport =
+            outportComputeAdaptive(route, inport, inport_dirn); break;
         default: outport =
             lookupRoutingTable(route.vnet, route.net_dest); break;
     }
@@ -240,3 +258,212 @@ RoutingUnit::outportComputeCustom(RouteInfo route,
     assert(0);
     return -1;
 }
+
+void
+RoutingUnit::meshOffsets(const RouteInfo &route, int &x_hops, int &y_hops)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_cols > 0);
+
+    int my_id = m_router->get_id();
+    int dest_id = route.dest_router;
+
+    x_hops = (dest_id % num_cols) - (my_id % num_cols);
+    y_hops = (dest_id / num_cols) - (my_id / num_cols);
+}
+
+// Among the productive directions allowed by the routing algorithm,
+// pick the one whose downstream router has the most idle VCs in this
+// vnet, breaking ties by the number of free buffers (credits).
+// Remaining ties go to the first candidate, i.e., the X dimension.
+int
+RoutingUnit::selectOutport(const std::vector<PortDirection> &candidates,
+                           int vnet)
+{
+    assert(!candidates.empty());
+
+    std::vector<OutputUnit *> &output_unit = m_router->get_outputUnit_ref();
+    int best_outport = -1;
+    int best_vcs = -1;
+    int best_credits = -1;
+
+    for (auto &dirn : candidates) {
+        auto it = m_outports_dirn2idx.find(dirn);
+        assert(it != m_outports_dirn2idx.end());
+        int outport = it->second;
+
+        int free_vcs = output_unit[outport]->get_free_vc_count(vnet);
+        int free_credits = output_unit[outport]->get_free_credit_count(vnet);
+
+        if (free_vcs > best_vcs ||
+            (free_vcs == best_vcs && free_credits > best_credits)) {
+            best_outport = outport;
+            best_vcs = free_vcs;
+            best_credits = free_credits;
+        }
+    }
+
+    return best_outport;
+}
+
+// West-first turn model: a packet first completes all of its west hops,
+// after which it adaptively routes among east, north and south.
+// The turns into west are prohibited, which breaks all cycles.
+int
+RoutingUnit::outportComputeWestFirst(RouteInfo route,
+                                     int inport,
+                                     PortDirection inport_dirn)
+{
+    int x_hops, y_hops;
+    meshOffsets(route, x_hops, y_hops);
+
+    // already checked that in outportCompute() function
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    if (x_hops < 0)
+        return m_outports_dirn2idx["West"];
+
+    std::vector<PortDirection> candidates;
+    if (x_hops > 0)
+        candidates.push_back("East");
+    if (y_hops > 0)
+        candidates.push_back("North");
+    else if (y_hops < 0)
+        candidates.push_back("South");
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// Odd-even turn model (Chiu, 2000): east-north/east-south turns are not
+// taken in even columns, and north-west/south-west turns are not taken
+// in odd columns. No VCs are needed to avoid deadlock.
+int
+RoutingUnit::outportComputeOddEven(RouteInfo route,
+                                   int inport,
+                                   PortDirection inport_dirn)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    int x_hops, y_hops;
+    meshOffsets(route, x_hops, y_hops);
+
+    // already checked that in outportCompute() function
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    int my_x = m_router->get_id() % num_cols;
+    int src_x = route.src_router % num_cols;
+    int dest_x = route.dest_router % num_cols;
+    PortDirection y_dirn = (y_hops > 0) ? "North" : "South";
+
+    std::vector<PortDirection> candidates;
+    if (x_hops == 0) {
+        candidates.push_back(y_dirn);
+    } else if (x_hops > 0) {
+        // eastbound
+        if (y_hops == 0) {
+            candidates.push_back("East");
+        } else {
+            if (my_x % 2 == 1 || my_x == src_x)
+                candidates.push_back(y_dirn);
+            if (dest_x % 2 == 1 || x_hops != 1)
+                candidates.push_back("East");
+        }
+    } else {
+        // westbound
+        candidates.push_back("West");
+        if (my_x % 2 == 0 && y_hops != 0)
+            candidates.push_back(y_dirn);
+    }
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// Fully adaptive minimal routing: any productive direction may be taken
+// on the adaptive VCs. A packet that cannot get an adaptive VC falls
+// back to the escape VC on the XY route (see SwitchAllocator), which
+// keeps the network deadlock-free (Duato's protocol).
+int
+RoutingUnit::outportComputeAdaptive(RouteInfo route,
+                                    int inport,
+                                    PortDirection inport_dirn)
+{
+    int x_hops, y_hops;
+    meshOffsets(route, x_hops, y_hops);
+
+    // already checked that in outportCompute() function
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    std::vector<PortDirection> candidates;
+    if (x_hops > 0)
+        candidates.push_back("East");
+    else if (x_hops < 0)
+        candidates.push_back("West");
+    if (y_hops > 0)
+        candidates.push_back("North");
+    else if (y_hops < 0)
+        candidates.push_back("South");
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// XY route from this router, without the inport checks of
+// outportComputeXY(), since adaptively routed packets may arrive
+// from any direction.
+int
+RoutingUnit::outportComputeEscape(RouteInfo route)
+{
+    if (route.dest_router == m_router->get_id())
+        return lookupRoutingTable(route.vnet, route.net_dest);
+
+    int x_hops, y_hops;
+    meshOffsets(route, x_hops, y_hops);
+
+    if (x_hops > 0)
+        return m_outports_dirn2idx["East"];
+    if (x_hops < 0)
+        return m_outports_dirn2idx["West"];
+    if (y_hops > 0)
+        return m_outports_dirn2idx["North"];
+    return m_outports_dirn2idx["South"];
+}
+
+// Torus: the VCs of a ring are split at the dateline between its last
+// and first router. A packet uses class 1 in a dimension once its route
+// wraps around (including the wraparound hop itself), which breaks the
+// cyclic dependency of every ring.
+// Dragonfly: class 1 once the packet has left its source group, so the
+// local hops before and after the global link use disjoint VCs.
+int
+RoutingUnit::vcClass(const RouteInfo &route, int outport)
+{
+    GarnetNetwork *net = m_router->get_net_ptr();
+    const std::vector<unsigned> &dims = net->getGeneratorDims();
+    int my_id = m_router->get_id();
+
+    if (net->getTopologyGenerator() == Enums::dragonfly) {
+        int a = dims[0];
+        return (my_id / a != route.src_router / a) ? 1 : 0;
+    }
+
+    assert(net->getTopologyGenerator() == Enums::torus3d);
+    static const PortDirection plus_dirn[] = { "East", "North", "Up" };
+    static const PortDirection minus_dirn[] = { "West", "South", "Down" };
+
+    PortDirection outport_dirn = m_outports_idx2dirn[outport];
+    int stride = 1;
+    for (int d = 0; d < 3; d++) {
+        int k = dims[d];
+        int pos = (my_id / stride) % k;
+        int src_pos = (route.src_router / stride) % k;
+
+        // Dimension-ordered routes leave the src coordinate of a
+        // dimension unchanged until they travel along it
+        if (outport_dirn == plus_dirn[d])
+            return (pos == k - 1 || pos < src_pos) ? 1 : 0;
+        if (outport_dirn == minus_dirn[d])
+            return (pos == 0 || pos > src_pos) ? 1 : 0;
+        stride *= k;
+    }
+
+    panic("Router %d: outport %s is not a torus direction\n", my_id,
+          outport_dirn);
+}
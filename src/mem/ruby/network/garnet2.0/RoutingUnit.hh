@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_ROUTING_UNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET_ROUTING_UNIT_HH__
 
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -56,7 +57,7 @@ class RoutingUnit
     void addWeight(int link_weight);
 
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, const NetDest &net_dest);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
@@ -72,9 +73,41 @@ class RoutingUnit
                              int inport,
                              PortDirection inport_dirn);
 
+    // Minimal adaptive routing for Mesh (turn model based)
+    int outportComputeWestFirst(RouteInfo route,
+                                int inport,
+                                PortDirection inport_dirn);
+    int outportComputeOddEven(RouteInfo route,
+                              int inport,
+                              PortDirection inport_dirn);
+
+    // Fully adaptive minimal routing for Mesh; deadlock freedom comes
+    // from the escape VCs, which follow the XY route
+    int outportComputeAdaptive(RouteInfo route,
+                               int inport,
+                               PortDirection inport_dirn);
+
+    // Outport of the deadlock-free escape route (XY) for this packet
+    int outportComputeEscape(RouteInfo route);
+
+    // VC class of a packet leaving through outport on a generated torus
+    // (dateline) or dragonfly (global link crossed), see GarnetNetwork
+    int vcClass(const RouteInfo &route, int outport);
+
   private:
+    // Offsets to the destination router in a Mesh
+    void meshOffsets(const RouteInfo &route, int &x_hops, int &y_hops);
+
+    // Congestion-aware selection among the candidate output directions,
+    // based on the idle VCs and credits at the downstream routers
+    int selectOutport(const std::vector<PortDirection> &candidates,
+                      int vnet);
+
     Router *m_router;
 
+    // Random route choices while the routers are evaluated in parallel
+    Random m_rng;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
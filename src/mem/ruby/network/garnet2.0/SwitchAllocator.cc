@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
 
+#include "base/bitfield.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
@@ -48,6 +49,12 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_escape_vcs = false;
+    m_vc_classes = false;
+
+    m_packet_latency = 0;
+    m_packets_switched = 0;
+    m_escape_reroutes = 0;
 }
 
 void
@@ -58,25 +65,31 @@ SwitchAllocator::init()
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
+    if (m_num_inports > 64 || m_num_outports > 64) {
+        fatal("Router %d has %d input and %d output ports; the switch "
+              "allocator supports at most 64 of each\n", m_router->get_id(),
+              m_num_inports, m_num_outports);
+    }
+
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
     m_vc_winners.resize(m_num_outports);
+    m_outport_flits.assign(m_num_outports, 0);
+    m_escape_vcs = m_router->get_net_ptr()->hasEscapeVCs();
+    m_vc_classes = m_router->get_net_ptr()->hasVCClasses();
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
     }
 
     for (int i = 0; i < m_num_outports; i++) {
-        m_port_requests[i].resize(m_num_inports);
         m_vc_winners[i].resize(m_num_inports);
 
         m_round_robin_inport[i] = 0;
-
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false; // [outport][inport]
-        }
+        m_port_requests[i] = 0; // bit inport is set for [outport][inport]
     }
+    m_requested_outports = 0;
 }
 
 /*
@@ -113,19 +126,41 @@ SwitchAllocator::arbitrate_inports()
 {
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
+    // Only the VCs that buffer a flit can be in SA, so the arbiter walks
+    // the occupied VCs in round robin order starting at the pointer
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
-
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        InputUnit *input_unit = m_input_unit[inport];
+        if (!input_unit->has_occupied_vc())
+            continue;
+
+        int start = m_round_robin_invc[inport];
+        int invc = input_unit->next_occupied_vc(start);
+        bool wrapped = false;
+
+        while (true) {
+            if (invc >= m_num_vcs) {
+                if (wrapped)
+                    break;
+                // continue with the VCs before the round robin pointer
+                wrapped = true;
+                invc = input_unit->next_occupied_vc(0);
+                continue;
+            }
+            if (wrapped && invc >= start)
+                break;
 
-            if (m_input_unit[inport]->need_stage(invc, SA_,
-                m_router->curCycle())) {
+            if (input_unit->need_stage(invc, SA_, m_router->curCycle())) {
 
                 // This flit is in SA stage
 
                 int  outport = m_input_unit[inport]->get_outport(invc);
                 int  outvc   = m_input_unit[inport]->get_outvc(invc);
 
+                // A head flit that cannot get an adaptive VC falls back
+                // to the escape VC on the escape route
+                if (m_escape_vcs && outvc == -1)
+                    outport = select_escape_outport(inport, invc, outport);
+
                 // check if the flit in this InputVC is allowed to be sent
                 // send_allowed conditions described in that function.
                 bool make_request =
@@ -133,7 +168,8 @@ SwitchAllocator::arbitrate_inports()
 
                 if (make_request) {
                     m_input_arbiter_activity++;
-                    m_port_requests[outport][inport] = true;
+                    m_port_requests[outport] |= ULL(1) << inport;
+                    m_requested_outports |= ULL(1) << outport;
                     m_vc_winners[outport][inport]= invc;
 
                     // Update Round Robin pointer
@@ -145,9 +181,7 @@ SwitchAllocator::arbitrate_inports()
                 }
             }
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+            invc = input_unit->next_occupied_vc(invc + 1);
         }
     }
 }
@@ -172,97 +206,100 @@ SwitchAllocator::arbitrate_outports()
     // Now there are a set of input vc requests for output vcs.
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
-    for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_inport[outport];
-
-        for (int inport_iter = 0; inport_iter < m_num_inports;
-                 inport_iter++) {
-
-            // inport has a request this cycle for outport
-            if (m_port_requests[outport][inport]) {
-
-                // grant this outport to this inport
-                int invc = m_vc_winners[outport][inport];
-
-                int outvc = m_input_unit[inport]->get_outvc(invc);
-                if (outvc == -1) {
-                    // VC Allocation - select any free VC from outport
-                    outvc = vc_allocate(outport, inport, invc);
-                }
+    // Only the output ports that received a request in SA-I are visited
+    uint64_t outports = m_requested_outports;
+    while (outports) {
+        int outport = findLsbSet(outports);
+        outports &= outports - 1;
+
+        // The requesting inports at or after the round robin pointer go
+        // first, then the ones before it
+        uint64_t requests = m_port_requests[outport];
+        uint64_t after = requests & ~mask(m_round_robin_inport[outport]);
+        int inport = findLsbSet(after ? after : requests);
+
+        // grant this outport to this inport
+        int invc = m_vc_winners[outport][inport];
+
+        int outvc = m_input_unit[inport]->get_outvc(invc);
+        if (outvc == -1) {
+            // VC Allocation - select any free VC from outport
+            outvc = vc_allocate(outport, inport, invc);
+        }
 
-                // remove flit from Input VC
-                flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
-
-                DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
-                                     "granted outvc %d at outport %d "
-                                     "to invc %d at inport %d to flit %s at "
-                                     "time: %lld\n",
-                        m_router->get_id(), outvc,
-                        m_router->getPortDirectionName(
-                            m_output_unit[outport]->get_direction()),
-                        invc,
-                        m_router->getPortDirectionName(
-                            m_input_unit[inport]->get_direction()),
-                            *t_flit,
-                        m_router->curCycle());
-
-
-                // Update outport field in the flit since this is
-                // used by CrossbarSwitch code to send it out of
-                // correct outport.
-                // Note: post route compute in InputUnit,
-                // outport is updated in VC, but not in flit
-                t_flit->set_outport(outport);
-
-                // set outvc (i.e., invc for next hop) in flit
-                // (This was updated in VC by vc_allocate, but not in flit)
-                t_flit->set_vc(outvc);
-
-                // decrement credit in outvc
-                m_output_unit[outport]->decrement_credit(outvc);
-
-                // flit ready for Switch Traversal
-                t_flit->advance_stage(ST_, m_router->curCycle());
-                m_router->grant_switch(inport, t_flit);
-                m_output_arbiter_activity++;
-
-                if ((t_flit->get_type() == TAIL_) ||
-                    t_flit->get_type() == HEAD_TAIL_) {
-
-                    // This Input VC should now be empty
-                    assert(!(m_input_unit[inport]->isReady(invc,
-                        m_router->curCycle())));
-
-                    // Free this VC
-                    m_input_unit[inport]->set_vc_idle(invc,
-                        m_router->curCycle());
-
-                    // Send a credit back
-                    // along with the information that this VC is now idle
-                    m_input_unit[inport]->increment_credit(invc, true,
-                        m_router->curCycle());
-                } else {
-                    // Send a credit back
-                    // but do not indicate that the VC is idle
-                    m_input_unit[inport]->increment_credit(invc, false,
-                        m_router->curCycle());
-                }
+        // remove flit from Input VC
+        flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
 
-                // remove this request
-                m_port_requests[outport][inport] = false;
+        m_outport_flits[outport]++;
+        if ((t_flit->get_type() == HEAD_) ||
+            (t_flit->get_type() == HEAD_TAIL_)) {
+            m_packets_switched++;
+            m_packet_latency += m_router->curCycle() -
+                m_input_unit[inport]->get_enqueue_time(invc);
+        }
 
-                // Update Round Robin pointer
-                m_round_robin_inport[outport]++;
-                if (m_round_robin_inport[outport] >= m_num_inports)
-                    m_round_robin_inport[outport] = 0;
+        DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
+                             "granted outvc %d at outport %d "
+                             "to invc %d at inport %d to flit %s at "
+                             "time: %lld\n",
+                m_router->get_id(), outvc,
+                m_router->getPortDirectionName(
+                    m_output_unit[outport]->get_direction()),
+                invc,
+                m_router->getPortDirectionName(
+                    m_input_unit[inport]->get_direction()),
+                    *t_flit,
+                m_router->curCycle());
+
+
+        // Update outport field in the flit since this is
+        // used by CrossbarSwitch code to send it out of
+        // correct outport.
+        // Note: post route compute in InputUnit,
+        // outport is updated in VC, but not in flit
+        t_flit->set_outport(outport);
+
+        // set outvc (i.e., invc for next hop) in flit
+        // (This was updated in VC by vc_allocate, but not in flit)
+        t_flit->set_vc(outvc);
+
+        // decrement credit in outvc
+        m_output_unit[outport]->decrement_credit(outvc);
+
+        // flit ready for Switch Traversal
+        t_flit->advance_stage(ST_, m_router->curCycle());
+        m_router->grant_switch(inport, t_flit);
+        m_output_arbiter_activity++;
+
+        if ((t_flit->get_type() == TAIL_) ||
+            t_flit->get_type() == HEAD_TAIL_) {
+
+            // This Input VC should now be empty
+            assert(!(m_input_unit[inport]->isReady(invc,
+                m_router->curCycle())));
+
+            // Free this VC
+            m_input_unit[inport]->set_vc_idle(invc,
+                m_router->curCycle());
+
+            // Send a credit back
+            // along with the information that this VC is now idle
+            m_input_unit[inport]->increment_credit(invc, true,
+                m_router->curCycle());
+        } else {
+            // Send a credit back
+            // but do not indicate that the VC is idle
+            m_input_unit[inport]->increment_credit(invc, false,
+                m_router->curCycle());
+        }
 
-                break; // got a input winner for this outport
-            }
+        // remove this request
+        m_port_requests[outport] &= ~(ULL(1) << inport);
 
-            inport++;
-            if (inport >= m_num_inports)
-                inport = 0;
-        }
+        // Update Round Robin pointer
+        m_round_robin_inport[outport]++;
+        if (m_round_robin_inport[outport] >= m_num_inports)
+            m_round_robin_inport[outport] = 0;
     }
 }
 
@@ -296,7 +333,9 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
         // needs outvc
         // this is only true for HEAD and HEAD_TAIL flits.
 
-        if (m_output_unit[outport]->has_free_vc(vnet)) {
+        if (m_output_unit[outport]->has_free_vc(vnet,
+                escape_allowed(inport, invc, outport),
+                vc_class(inport, invc, outport))) {
 
             has_outvc = true;
 
@@ -342,7 +381,9 @@ int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 {
     // Select a free VC from the output port
-    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc));
+    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc),
+        escape_allowed(inport, invc, outport),
+        vc_class(inport, invc, outport));
 
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
@@ -350,6 +391,67 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     return outvc;
 }
 
+// With escape VCs, a packet may only take the escape VC of an outport
+// that lies on its escape (XY) route. Ejection ports are always allowed.
+bool
+SwitchAllocator::escape_allowed(int inport, int invc, int outport)
+{
+    if (!m_escape_vcs ||
+        m_output_unit[outport]->get_direction() == "Local")
+        return true;
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    return outport == m_router->escape_route_compute(t_flit->get_route());
+}
+
+int
+SwitchAllocator::vc_class(int inport, int invc, int outport)
+{
+    if (!m_vc_classes ||
+        m_output_unit[outport]->get_direction() == "Local")
+        return -1;
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    return m_router->vc_class_compute(t_flit->get_route(), outport);
+}
+
+// Returns the outport a head flit should request: its adaptive outport
+// while that has a free VC for it, otherwise the escape route if the
+// escape VC there is free. Switching to the escape route updates the
+// outport of the input VC.
+int
+SwitchAllocator::select_escape_outport(int inport, int invc, int outport)
+{
+    int vnet = get_vnet(invc);
+    if (m_output_unit[outport]->has_free_vc(vnet,
+            escape_allowed(inport, invc, outport))) {
+        return outport;
+    }
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    int escape_outport = m_router->escape_route_compute(t_flit->get_route());
+    if (escape_outport != outport &&
+        m_output_unit[escape_outport]->has_free_vc(vnet)) {
+        DPRINTF(RubyNetwork, "SwitchAllocator at Router %d moving invc %d "
+                "at inport %d to the escape route via outport %d\n",
+                m_router->get_id(), invc, inport, escape_outport);
+        m_input_unit[inport]->grant_outport(invc, escape_outport);
+        m_escape_reroutes++;
+        return escape_outport;
+    }
+
+    return outport;
+}
+
+void
+SwitchAllocator::resetStats()
+{
+    m_outport_flits.assign(m_num_outports, 0);
+    m_packet_latency = 0;
+    m_packets_switched = 0;
+    m_escape_reroutes = 0;
+}
+
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
 void
@@ -358,8 +460,13 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
-            if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
+        InputUnit *input_unit = m_input_unit[i];
+        if (!input_unit->has_occupied_vc())
+            continue;
+
+        for (int j = input_unit->next_occupied_vc(0); j < m_num_vcs;
+             j = input_unit->next_occupied_vc(j + 1)) {
+            if (input_unit->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
@@ -381,9 +488,9 @@ SwitchAllocator::get_vnet(int invc)
 void
 SwitchAllocator::clear_request_vector()
 {
-    for (int i = 0; i < m_num_outports; i++) {
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false;
-        }
+    while (m_requested_outports) {
+        int outport = findLsbSet(m_requested_outports);
+        m_requested_outports &= m_requested_outports - 1;
+        m_port_requests[outport] = 0;
     }
 }
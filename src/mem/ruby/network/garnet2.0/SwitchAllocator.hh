@@ -59,6 +59,13 @@ class SwitchAllocator : public Consumer
     bool send_allowed(int inport, int invc, int outport, int outvc);
     int vc_allocate(int outport, int inport, int invc);
 
+    // Escape VC handling for fully adaptive routing
+    bool escape_allowed(int inport, int invc, int outport);
+    int select_escape_outport(int inport, int invc, int outport);
+
+    // VC class of the output VC, or -1 if any VC of the vnet may be used
+    int vc_class(int inport, int invc, int outport);
+
     inline double
     get_input_arbiter_activity()
     {
@@ -70,16 +77,36 @@ class SwitchAllocator : public Consumer
         return m_output_arbiter_activity;
     }
 
+    // Per-router link utilization and latency statistics
+    inline double get_outport_flits(int outport)
+    { return m_outport_flits[outport]; }
+    inline double get_packet_latency() { return m_packet_latency; }
+    inline double get_packets_switched() { return m_packets_switched; }
+    inline double get_escape_reroutes() { return m_escape_reroutes; }
+    void resetStats();
+
   private:
     int m_num_inports, m_num_outports;
     int m_num_vcs, m_vc_per_vnet;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
+    bool m_escape_vcs;
+    bool m_vc_classes;
+
+    // flits sent on each outport, head-flit latency through this router
+    // (buffering to switch grant), and packets moved to the escape VC
+    std::vector<double> m_outport_flits;
+    double m_packet_latency;
+    double m_packets_switched;
+    double m_escape_reroutes;
 
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
-    std::vector<std::vector<bool>> m_port_requests;
+    // Bitmask of the requesting inports for each outport, and of the
+    // outports with at least one request
+    std::vector<uint64_t> m_port_requests;
+    uint64_t m_requested_outports;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
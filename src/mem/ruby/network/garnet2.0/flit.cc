@@ -36,6 +36,13 @@
 // Constructor for the flit
 flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
     MsgPtr msg_ptr, Cycles curTime)
+{
+    init(id, vc, vnet, route, size, msg_ptr, curTime);
+}
+
+void
+flit::init(int id, int vc, int vnet, const RouteInfo &route, int size,
+           const MsgPtr &msg_ptr, Cycles curTime)
 {
     m_size = size;
     m_msg_ptr = msg_ptr;
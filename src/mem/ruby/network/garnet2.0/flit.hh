@@ -48,6 +48,13 @@ class flit
     flit(int id, int vc, int vnet, RouteInfo route, int size,
          MsgPtr msg_ptr, Cycles curTime);
 
+    // (Re)initialize a flit; used by the constructor and by
+    // GarnetNetwork when a recycled flit is handed out again
+    void init(int id, int vc, int vnet, const RouteInfo &route, int size,
+              const MsgPtr &msg_ptr, Cycles curTime);
+    // Drop the reference to the message once the flit is recycled
+    void release() { m_msg_ptr.reset(); }
+
     int get_outport() {return m_outport; }
     int get_size() { return m_size; }
     Cycles get_enqueue_time() { return m_enqueue_time; }
@@ -55,6 +55,7 @@ PerfectSwitch::PerfectSwitch(SwitchID sid, Switch *sw, uint32_t virt_nets)
     m_round_robin_start = 0;
     m_wakeups_wo_switch = 0;
     m_virtual_networks = virt_nets;
+    m_blocked = false;
 }
 
 void
@@ -95,6 +96,7 @@ PerfectSwitch::addOutPort(const vector<MessageBuffer*>& out,
     // Add to routing table
     m_out.push_back(out);
     m_routing_table.push_back(routing_table_entry);
+    m_node_link.clear();
 }
 
 PerfectSwitch::~PerfectSwitch()
@@ -102,7 +104,7 @@ PerfectSwitch::~PerfectSwitch()
 }
 
 void
-PerfectSwitch::operateVnet(int vnet)
+PerfectSwitch::operateVnet(int vnet, Tick current_time)
 {
     // This is for round-robin scheduling
     int incoming = m_round_robin_start;
@@ -130,22 +132,125 @@ PerfectSwitch::operateVnet(int vnet)
                 continue;
             }
 
-            operateMessageBuffer(buffer, incoming, vnet);
+            operateMessageBuffer(buffer, incoming, vnet, current_time);
+
+            // Every pending message of the vnet has been switched
+            if (m_pending_message_count[vnet] == 0)
+                break;
+        }
+    }
+}
+
+void
+PerfectSwitch::buildNodeLinks()
+{
+    int num_nodes = m_routing_table.empty() ? 0 :
+                    m_routing_table[0].getSize();
+    m_node_link.assign(num_nodes, -1);
+
+    // Walk the links backwards, so the lowest numbered link that reaches
+    // a node serves it, like in routeAdaptive() with the initial order
+    for (int link = m_routing_table.size() - 1; link >= 0; link--) {
+        const NetDest &dst = m_routing_table[link];
+        for (NodeID n = dst.nextElement(0); n < dst.getSize();
+             n = dst.nextElement(n + 1)) {
+            m_node_link[n] = link;
         }
     }
 }
 
+void
+PerfectSwitch::routeStatic(const NetDest &msg_dsts)
+{
+    if (m_node_link.empty())
+        buildNodeLinks();
+
+    m_output_links.clear();
+    m_output_link_destinations.clear();
+
+    for (NodeID n = msg_dsts.nextElement(0); n < msg_dsts.getSize();
+         n = msg_dsts.nextElement(n + 1)) {
+        int link = m_node_link[n];
+        assert(link != -1);
+
+        // Keep the output links in increasing order
+        int i = 0;
+        while (i < m_output_links.size() && m_output_links[i] < link)
+            i++;
+        if (i == m_output_links.size() || m_output_links[i] != link) {
+            m_output_links.insert(m_output_links.begin() + i, link);
+            m_output_link_destinations.insert(
+                m_output_link_destinations.begin() + i, NetDest());
+        }
+        m_output_link_destinations[i].add(NetDest::nodeToMachineID(n));
+    }
+}
+
+void
+PerfectSwitch::routeAdaptive(NetDest msg_dsts, Tick current_time)
+{
+    m_output_links.clear();
+    m_output_link_destinations.clear();
+
+    assert(m_link_order.size() == m_routing_table.size());
+    assert(m_link_order.size() == m_out.size());
+
+    // Find how clogged each link is
+    for (int out = 0; out < m_out.size(); out++) {
+        int out_queue_length = 0;
+        for (int v = 0; v < m_virtual_networks; v++) {
+            out_queue_length += m_out[out][v]->getSize(current_time);
+        }
+        int value =
+            (out_queue_length << 8) |
+            random_mt.random(0, 0xff);
+        m_link_order[out].m_link = out;
+        m_link_order[out].m_value = value;
+    }
+
+    // Look at the most empty link first
+    sort(m_link_order.begin(), m_link_order.end());
+
+    for (int i = 0; i < m_routing_table.size(); i++) {
+        // Every destination has been routed to a link already
+        if (msg_dsts.isEmpty())
+            break;
+
+        // pick the next link to look at
+        int link = m_link_order[i].m_link;
+        const NetDest &dst = m_routing_table[link];
+        DPRINTF(RubyNetwork, "dst: %s\n", dst);
+
+        if (!msg_dsts.intersectionIsNotEmpty(dst))
+            continue;
+
+        // Remember what link we're using
+        m_output_links.push_back(link);
+
+        // Need to remember which destinations need this message in
+        // another vector.  This Set is the intersection of the
+        // routing_table entry and the current destination set.  The
+        // intersection must not be empty, since we are inside "if"
+        m_output_link_destinations.push_back(msg_dsts.AND(dst));
+
+        // Next, we update the msg_destination not to include
+        // those nodes that were already handled by this link
+        msg_dsts.removeNetDest(dst);
+    }
+
+    assert(msg_dsts.count() == 0);
+}
+
 void
 PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
-                                    int vnet)
+                                    int vnet, Tick current_time)
 {
     MsgPtr msg_ptr;
     Message *net_msg_ptr = NULL;
 
-    // temporary vectors to store the routing results
-    vector<LinkID> output_links;
-    vector<NetDest> output_link_destinations;
-    Tick current_time = m_switch->clockEdge();
+    // Ordered vnets are never routed adaptively
+    bool static_routes = !m_network_ptr->getAdaptiveRouting() ||
+                         m_network_ptr->isVNetOrdered(vnet);
 
     while (buffer->isReady(current_time)) {
         DPRINTF(RubyNetwork, "incoming: %d\n", incoming);
@@ -155,72 +260,17 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
         net_msg_ptr = msg_ptr.get();
         DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
 
-        output_links.clear();
-        output_link_destinations.clear();
-        NetDest msg_dsts = net_msg_ptr->getDestination();
-
         // Unfortunately, the token-protocol sends some
-        // zero-destination messages, so this assert isn't valid
-        // assert(msg_dsts.count() > 0);
-
-        assert(m_link_order.size() == m_routing_table.size());
-        assert(m_link_order.size() == m_out.size());
-
-        if (m_network_ptr->getAdaptiveRouting()) {
-            if (m_network_ptr->isVNetOrdered(vnet)) {
-                // Don't adaptively route
-                for (int out = 0; out < m_out.size(); out++) {
-                    m_link_order[out].m_link = out;
-                    m_link_order[out].m_value = 0;
-                }
-            } else {
-                // Find how clogged each link is
-                for (int out = 0; out < m_out.size(); out++) {
-                    int out_queue_length = 0;
-                    for (int v = 0; v < m_virtual_networks; v++) {
-                        out_queue_length += m_out[out][v]->getSize(current_time);
-                    }
-                    int value =
-                        (out_queue_length << 8) |
-                        random_mt.random(0, 0xff);
-                    m_link_order[out].m_link = out;
-                    m_link_order[out].m_value = value;
-                }
-
-                // Look at the most empty link first
-                sort(m_link_order.begin(), m_link_order.end());
-            }
-        }
-
-        for (int i = 0; i < m_routing_table.size(); i++) {
-            // pick the next link to look at
-            int link = m_link_order[i].m_link;
-            NetDest dst = m_routing_table[link];
-            DPRINTF(RubyNetwork, "dst: %s\n", dst);
-
-            if (!msg_dsts.intersectionIsNotEmpty(dst))
-                continue;
-
-            // Remember what link we're using
-            output_links.push_back(link);
-
-            // Need to remember which destinations need this message in
-            // another vector.  This Set is the intersection of the
-            // routing_table entry and the current destination set.  The
-            // intersection must not be empty, since we are inside "if"
-            output_link_destinations.push_back(msg_dsts.AND(dst));
-
-            // Next, we update the msg_destination not to include
-            // those nodes that were already handled by this link
-            msg_dsts.removeNetDest(dst);
-        }
-
-        assert(msg_dsts.count() == 0);
+        // zero-destination messages, so there may be no output link
+        if (static_routes)
+            routeStatic(net_msg_ptr->getDestination());
+        else
+            routeAdaptive(net_msg_ptr->getDestination(), current_time);
 
         // Check for resources - for all outgoing queues
         bool enough = true;
-        for (int i = 0; i < output_links.size(); i++) {
-            int outgoing = output_links[i];
+        for (int i = 0; i < m_output_links.size(); i++) {
+            int outgoing = m_output_links[i];
 
             if (!m_out[outgoing][vnet]->areNSlotsAvailable(1, current_time))
                 enough = false;
@@ -232,7 +282,7 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
 
         // There were not enough resources
         if (!enough) {
-            scheduleEvent(Cycles(1));
+            m_blocked = true;
             DPRINTF(RubyNetwork, "Can't deliver message since a node "
                     "is blocked\n");
             DPRINTF(RubyNetwork, "Message: %s\n", (*net_msg_ptr));
@@ -241,7 +291,7 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
 
         MsgPtr unmodified_msg_ptr;
 
-        if (output_links.size() > 1) {
+        if (m_output_links.size() > 1) {
             // If we are sending this message down more than one link
             // (size>1), we need to make a copy of the message so each
             // branch can have a different internal destination we need
@@ -257,8 +307,8 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
         m_pending_message_count[vnet]--;
 
         // Enqueue it - for all outgoing queues
-        for (int i=0; i<output_links.size(); i++) {
-            int outgoing = output_links[i];
+        for (int i=0; i<m_output_links.size(); i++) {
+            int outgoing = m_output_links[i];
 
             if (i > 0) {
                 // create a private copy of the unmodified message
@@ -268,7 +318,7 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
             // Change the internal destination set of the message so it
             // knows which destinations this link is responsible for.
             net_msg_ptr = msg_ptr.get();
-            net_msg_ptr->getDestination() = output_link_destinations[i];
+            net_msg_ptr->getDestination() = m_output_link_destinations[i];
 
             // Enqeue msg
             DPRINTF(RubyNetwork, "Enqueuing net msg from "
@@ -298,12 +348,20 @@ PerfectSwitch::wakeup()
         decrementer = -1;
     }
 
+    // All the ready messages of a vnet are switched in one pass; blocked
+    // messages are retried with a single wakeup in the next cycle
+    Tick current_time = m_switch->clockEdge();
+    m_blocked = false;
+
     // For all components incoming queues
     for (int vnet = highest_prio_vnet;
          (vnet * decrementer) >= (decrementer * lowest_prio_vnet);
          vnet -= decrementer) {
-        operateVnet(vnet);
+        operateVnet(vnet, current_time);
     }
+
+    if (m_blocked)
+        scheduleEvent(Cycles(1));
 }
 
 void
@@ -41,10 +41,10 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
 class MessageBuffer;
-class NetDest;
 class SimpleNetwork;
 class Switch;
 
@@ -85,8 +85,17 @@ class PerfectSwitch : public Consumer
     PerfectSwitch(const PerfectSwitch& obj);
     PerfectSwitch& operator=(const PerfectSwitch& obj);
 
-    void operateVnet(int vnet);
-    void operateMessageBuffer(MessageBuffer *b, int incoming, int vnet);
+    void operateVnet(int vnet, Tick current_time);
+    void operateMessageBuffer(MessageBuffer *b, int incoming, int vnet,
+                              Tick current_time);
+
+    // Split the destinations of a message over the output links, into
+    // m_output_links and m_output_link_destinations. Without adaptive
+    // routing the links are visited in a fixed order, so every node is
+    // served by a precomputed link.
+    void routeStatic(const NetDest &msg_dsts);
+    void routeAdaptive(NetDest msg_dsts, Tick current_time);
+    void buildNodeLinks();
 
     const SwitchID m_switch_id;
     Switch * const m_switch;
@@ -98,6 +107,17 @@ class PerfectSwitch : public Consumer
     std::vector<NetDest> m_routing_table;
     std::vector<LinkOrder> m_link_order;
 
+    // First output link that reaches each node, built on first use
+    std::vector<int> m_node_link;
+
+    // Routing results of the message being switched, kept across
+    // messages to avoid reallocating them
+    std::vector<LinkID> m_output_links;
+    std::vector<NetDest> m_output_link_destinations;
+
+    // Some message could not leave during this wakeup
+    bool m_blocked;
+
     uint32_t m_virtual_networks;
     int m_round_robin_start;
     int m_wakeups_wo_switch;
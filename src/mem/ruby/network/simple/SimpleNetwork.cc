@@ -32,6 +32,7 @@
 #include <numeric>
 
 #include "base/cast.hh"
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
@@ -75,6 +76,7 @@ SimpleNetwork::~SimpleNetwork()
 {
     deletePointers(m_switches);
     deletePointers(m_int_link_buffers);
+    deletePointers(m_generated_links);
 }
 
 // From a switch to an endpoint node
@@ -129,11 +131,74 @@ SimpleNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
                                 simple_link->m_bw_multiplier);
 }
 
+// Internal link of a generated topology, with the buffers Python would
+// have added for it in SimpleNetwork.setup_buffers(): one per vnet for
+// the link itself and one per vnet for the output port of the switch.
+// The buffers are copies of one that Python built for an external link.
+BasicIntLink *
+SimpleNetwork::makeGeneratedLink(int link_id, SwitchID src, SwitchID dst,
+                                 Cycles latency, int weight)
+{
+    string link_name = csprintf("gen_int_links%d", m_generated_links.size());
+
+    const MessageBufferParams *buffer_params = NULL;
+    for (auto router : params()->routers) {
+        const SwitchParams *switch_params =
+            safe_cast<const SwitchParams *>(router->params());
+        if (!switch_params->port_buffers.empty()) {
+            buffer_params = switch_params->port_buffers.front()->params();
+            break;
+        }
+    }
+    fatal_if(buffer_params == NULL, "%s: a generated topology needs an "
+             "external link to copy the buffer parameters from\n", name());
+
+    SimpleIntLinkParams *link_p = new SimpleIntLinkParams();
+    initGeneratedParams(link_p, link_name);
+    link_p->link_id = link_id;
+    link_p->latency = latency;
+    link_p->bandwidth_factor = params()->generator_bandwidth_factor;
+    link_p->weight = weight;
+    link_p->src_node = m_switches[src];
+    link_p->dst_node = m_switches[dst];
+    link_p->src_outport = "";
+    link_p->dst_inport = "";
+
+    SimpleIntLink *link = link_p->create();
+    m_generated_links.push_back(link);
+
+    vector<MessageBuffer*> port_buffers;
+    for (int i = 0; i < m_virtual_networks; i++) {
+        for (int j = 0; j < 2; j++) {
+            MessageBufferParams *p = new MessageBufferParams(*buffer_params);
+            bool link_buffer = (j == 0);
+            initGeneratedParams(p, csprintf("%s.%s%d", link_name,
+                link_buffer ? "buffers" : "port_buffers", i));
+
+            MessageBuffer *buffer = p->create();
+            if (link_buffer)
+                m_int_link_buffers.push_back(buffer);
+            else
+                port_buffers.push_back(buffer);
+            m_generated_buffers.push_back(buffer);
+        }
+    }
+    m_switches[src]->addPortBuffers(port_buffers);
+
+    return link;
+}
+
 void
 SimpleNetwork::regStats()
 {
     Network::regStats();
 
+    // Python registers the statistics of all objects but these
+    for (auto link : m_generated_links)
+        link->regStats();
+    for (auto buffer : m_generated_buffers)
+        buffer->regStats();
+
     for (MessageSizeType type = MessageSizeType_FIRST;
          type < MessageSizeType_NUM; ++type) {
         m_msg_counts[(unsigned int) type]
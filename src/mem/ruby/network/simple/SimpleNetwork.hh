@@ -39,6 +39,7 @@ class NetDest;
 class MessageBuffer;
 class Throttle;
 class Switch;
+class SimpleIntLink;
 
 class SimpleNetwork : public Network
 {
@@ -67,6 +68,8 @@ class SimpleNetwork : public Network
                           const NetDest& routing_table_entry,
                           PortDirection src_outport,
                           PortDirection dst_inport);
+    BasicIntLink *makeGeneratedLink(int link_id, SwitchID src, SwitchID dst,
+                                    Cycles latency, int weight) override;
 
     void print(std::ostream& out) const;
 
@@ -85,6 +88,9 @@ class SimpleNetwork : public Network
 
     std::vector<Switch*> m_switches;
     std::vector<MessageBuffer*> m_int_link_buffers;
+    // Links of a generated topology and the buffers created with them
+    std::vector<SimpleIntLink*> m_generated_links;
+    std::vector<MessageBuffer*> m_generated_buffers;
     int m_num_connected_buffers;
     const int m_buffer_size;
     const int m_endpoint_bandwidth;
@@ -72,6 +72,13 @@ Switch::addInPort(const vector<MessageBuffer*>& in)
     m_perfect_switch->addInPort(in);
 }
 
+void
+Switch::addPortBuffers(const vector<MessageBuffer*>& buffers)
+{
+    m_port_buffers.insert(m_port_buffers.end(), buffers.begin(),
+                          buffers.end());
+}
+
 void
 Switch::addOutPort(const vector<MessageBuffer*>& out,
                    const NetDest& routing_table_entry,
@@ -63,6 +63,8 @@ class Switch : public BasicRouter
     void init();
 
     void addInPort(const std::vector<MessageBuffer*>& in);
+    // Buffers for the output ports of links that are not in int_links
+    void addPortBuffers(const std::vector<MessageBuffer*>& buffers);
     void addOutPort(const std::vector<MessageBuffer*>& out,
                     const NetDest& routing_table_entry,
                     Cycles link_latency, int bw_multiplier);
@@ -99,21 +99,34 @@ Throttle::operateVnet(int vnet, int &bw_remaining, bool &schedule_wakeup,
     assert(m_units_remaining[vnet] >= 0);
     Tick current_time = m_switch->clockEdge();
 
-    while (bw_remaining > 0 && (in->isReady(current_time) ||
-                                m_units_remaining[vnet] > 0) &&
-           out->areNSlotsAvailable(1, current_time)) {
+    // Move messages until the bandwidth of this cycle is spent. Each
+    // buffer is checked once per message.
+    int &units_remaining = m_units_remaining[vnet];
+    while (bw_remaining > 0) {
         // See if we are done transferring the previous message on
-        // this virtual network
-        if (m_units_remaining[vnet] == 0 && in->isReady(current_time)) {
+        // this virtual network, and if there is a next one
+        bool next_msg = (units_remaining == 0);
+        if (next_msg && !in->isReady(current_time))
+            return;
+
+        if (!out->areNSlotsAvailable(1, current_time)) {
+            DPRINTF(RubyNetwork, "vnet: %d", vnet);
+
+            // schedule me to wakeup again because I'm waiting for my
+            // output queue to become available
+            schedule_wakeup = true;
+            return;
+        }
+
+        if (next_msg) {
             // Find the size of the message we are moving
             MsgPtr msg_ptr = in->peekMsgPtr();
             Message *net_msg_ptr = msg_ptr.get();
-            m_units_remaining[vnet] +=
-                network_message_to_size(net_msg_ptr);
+            units_remaining += network_message_to_size(net_msg_ptr);
 
             DPRINTF(RubyNetwork, "throttle: %d my bw %d bw spent "
                     "enqueueing net msg %d time: %lld.\n",
-                    m_node, getLinkBandwidth(), m_units_remaining[vnet],
+                    m_node, getLinkBandwidth(), units_remaining,
                     m_ruby_system->curCycle());
 
             // Move the message
@@ -127,20 +140,10 @@ Throttle::operateVnet(int vnet, int &bw_remaining, bool &schedule_wakeup,
         }
 
         // Calculate the amount of bandwidth we spent on this message
-        int diff = m_units_remaining[vnet] - bw_remaining;
-        m_units_remaining[vnet] = max(0, diff);
+        int diff = units_remaining - bw_remaining;
+        units_remaining = max(0, diff);
         bw_remaining = max(0, -diff);
     }
-
-    if (bw_remaining > 0 && (in->isReady(current_time) ||
-                             m_units_remaining[vnet] > 0) &&
-        !out->areNSlotsAvailable(1, current_time)) {
-        DPRINTF(RubyNetwork, "vnet: %d", vnet);
-
-        // schedule me to wakeup again because I'm waiting for my
-        // output queue to become available
-        schedule_wakeup = true;
-    }
 }
 
 void
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+#include "mem/ruby/profiler/TransitionTracer.hh"
+
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "mem/protocol/TransitionResult.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
+#include "proto/protocol_trace.pb.h"
+#include "proto/protoio.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+TransitionTracer::TransitionTracer(const string &obj_id,
+                                   const string &filename,
+                                   const vector<AddrRange> &addr_ranges,
+                                   const vector<string> &machine_types,
+                                   const vector<AbstractController *> &cntrls)
+    : m_obj_id(obj_id), m_stream(NULL), m_addr_ranges(addr_ranges),
+      m_machine_mask(MachineType_NUM, machine_types.empty()),
+      m_controllers(cntrls), m_header_written(false)
+{
+    for (auto &type_name : machine_types) {
+        m_machine_mask[string_to_MachineType(type_name)] = true;
+    }
+
+    // If the trace file is not specified as an absolute path, place it
+    // in the current simulation output directory
+    m_stream = new ProtoOutputStream(simout.resolve(filename));
+}
+
+TransitionTracer::~TransitionTracer()
+{
+    close();
+}
+
+void
+TransitionTracer::close()
+{
+    if (m_stream != NULL) {
+        if (!m_header_written) {
+            writeHeader();
+        }
+        delete m_stream;
+        m_stream = NULL;
+    }
+}
+
+bool
+TransitionTracer::inRange(Addr addr) const
+{
+    if (m_addr_ranges.empty()) {
+        return true;
+    }
+
+    for (auto &range : m_addr_ranges) {
+        if (range.contains(addr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+TransitionTracer::writeHeader()
+{
+    ProtoMessage::ProtocolTraceHeader header_msg;
+    header_msg.set_obj_id(m_obj_id);
+    header_msg.set_tick_freq(SimClock::Frequency);
+
+    vector<bool> seen(MachineType_NUM, false);
+    for (auto cntrl : m_controllers) {
+        MachineType type = cntrl->getType();
+        if (seen[type]) {
+            continue;
+        }
+        seen[type] = true;
+
+        ProtoMessage::ProtocolMachine *machine = header_msg.add_machines();
+        machine->set_type(type);
+        machine->set_name(MachineType_to_string(type));
+
+        vector<string> states;
+        vector<string> events;
+        cntrl->transitionNames(states, events);
+        for (auto &state : states) {
+            machine->add_states(state);
+        }
+        for (auto &event : events) {
+            machine->add_events(event);
+        }
+    }
+
+    m_stream->write(header_msg);
+    m_header_written = true;
+}
+
+void
+TransitionTracer::record(const MachineID &machine, Addr addr, int state,
+                         int event, int next_state, int result)
+{
+    if (m_stream == NULL || !inRange(addr)) {
+        return;
+    }
+
+    if (!m_header_written) {
+        writeHeader();
+    }
+
+    ProtoMessage::ProtocolTransition trans_msg;
+    trans_msg.set_tick(curTick());
+    trans_msg.set_machine_type(machine.getType());
+    trans_msg.set_version(machine.getNum());
+    trans_msg.set_addr(addr);
+    trans_msg.set_state(state);
+    trans_msg.set_event(event);
+    trans_msg.set_next_state(next_state);
+    if (result != TransitionResult_Valid) {
+        trans_msg.set_result(result);
+    }
+
+    m_stream->write(trans_msg);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/*
+ * Structured binary trace of SLICC transitions. Every transition attempt
+ * of a traced controller is written as a ProtocolTransition message to a
+ * protobuf stream, which util/decode_protocol_trace.py turns back into
+ * text. Unlike the ProtocolTrace debug flag, the trace can be restricted
+ * to address ranges and controller types, and avoids all string
+ * formatting on the simulation path.
+ */
+
+#ifndef __MEM_RUBY_PROFILER_TRANSITIONTRACER_HH__
+#define __MEM_RUBY_PROFILER_TRANSITIONTRACER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+#include "mem/protocol/MachineType.hh"
+#include "mem/ruby/common/MachineID.hh"
+
+class AbstractController;
+class ProtoOutputStream;
+
+class TransitionTracer
+{
+  public:
+    TransitionTracer(const std::string &obj_id, const std::string &filename,
+                     const std::vector<AddrRange> &addr_ranges,
+                     const std::vector<std::string> &machine_types,
+                     const std::vector<AbstractController *> &controllers);
+    ~TransitionTracer();
+
+    /** Is the given controller type selected for tracing? */
+    bool tracesMachine(MachineType type) const
+    { return m_machine_mask[type]; }
+
+    void record(const MachineID &machine, Addr addr, int state, int event,
+                int next_state, int result);
+
+    /** Flush and close the output stream. */
+    void close();
+
+  private:
+    bool inRange(Addr addr) const;
+    void writeHeader();
+
+    const std::string m_obj_id;
+    ProtoOutputStream *m_stream;
+    const std::vector<AddrRange> m_addr_ranges;
+    std::vector<bool> m_machine_mask;
+
+    //! The controllers are registered with RubySystem as they are
+    //! constructed, so the name tables are only gathered once the first
+    //! transition is recorded.
+    const std::vector<AbstractController *> &m_controllers;
+    bool m_header_written;
+};
+
+#endif // __MEM_RUBY_PROFILER_TRANSITIONTRACER_HH__
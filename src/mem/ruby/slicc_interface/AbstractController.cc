@@ -28,6 +28,7 @@
 
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 
+#include "config/have_protobuf.hh"
 #include "debug/RubyQueue.hh"
 #include "mem/protocol/MemoryMsg.hh"
 #include "mem/ruby/network/Network.hh"
@@ -36,6 +37,10 @@
 #include "mem/ruby/system/Sequencer.hh"
 #include "sim/system.hh"
 
+#if HAVE_PROTOBUF
+#include "mem/ruby/profiler/TransitionTracer.hh"
+#endif
+
 AbstractController::AbstractController(const Params *p)
     : MemObject(p), Consumer(this), m_version(p->version),
       m_clusterID(p->cluster_id),
@@ -43,6 +48,7 @@ AbstractController::AbstractController(const Params *p)
       m_number_of_TBEs(p->number_of_TBEs),
       m_transitions_per_cycle(p->transitions_per_cycle),
       m_buffer_size(p->buffer_size), m_recycle_latency(p->recycle_latency),
+      m_transition_tracer(NULL),
       memoryPort(csprintf("%s.memory", name()), this, "")
 {
     if (m_version == 0) {
@@ -56,6 +62,14 @@ void
 AbstractController::init()
 {
     params()->ruby_system->registerAbstractController(this);
+
+#if HAVE_PROTOBUF
+    TransitionTracer *tracer = params()->ruby_system->getTransitionTracer();
+    if (tracer != NULL && tracer->tracesMachine(getType())) {
+        m_transition_tracer = tracer;
+    }
+#endif
+
     m_delayHistogram.init(10);
     uint32_t size = Network::getNumberOfVirtualNetworks();
     for (uint32_t i = 0; i < size; i++) {
@@ -93,6 +107,16 @@ AbstractController::profileMsgDelay(uint32_t virtualNetwork, Cycles delay)
     m_delayVCHistogram[virtualNetwork]->sample(delay);
 }
 
+void
+AbstractController::traceTransition(Addr addr, int state, int event,
+                                    int next_state, int result)
+{
+#if HAVE_PROTOBUF
+    m_transition_tracer->record(m_machineID, addr, state, event, next_state,
+                                result);
+#endif
+}
+
 void
 AbstractController::stallBuffer(MessageBuffer* buf, Addr addr)
 {
@@ -293,6 +317,14 @@ AbstractController::queueMemoryWritePartial(const MachineID &id, Addr addr,
     memoryPort.schedTimingReq(pkt, clockEdge(latency));
 }
 
+void
+AbstractController::functionalWarmupEvict(const Addr &addr)
+{
+    DataBlock empty;
+    params()->ruby_system->functionalWarmup(addr, RubyRequestType_REPLACEMENT,
+                                            m_machineID, empty);
+}
+
 void
 AbstractController::functionalMemoryRead(PacketPtr pkt)
 {
@@ -32,9 +32,11 @@
 #include <exception>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "mem/protocol/AccessPermission.hh"
+#include "mem/protocol/RubyRequestType.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/DataBlock.hh"
@@ -49,6 +51,7 @@
 
 class Network;
 class GPUCoalescer;
+class TransitionTracer;
 
 // used to communicate that an in_port peeked the wrong message type
 class RejectException: public std::exception
@@ -86,6 +89,10 @@ class AbstractController : public MemObject, public Consumer
     virtual void regStats();
 
     virtual void recordCacheTrace(int cntrl, CacheRecorder* tr) = 0;
+    //! Names of the protocol states and events, indexed by their values,
+    //! for decoding transition traces.
+    virtual void transitionNames(std::vector<std::string> &states,
+                                 std::vector<std::string> &events) const = 0;
     virtual Sequencer* getCPUSequencer() const = 0;
     virtual GPUCoalescer* getGPUCoalescer() const = 0;
 
@@ -99,6 +106,18 @@ class AbstractController : public MemObject, public Consumer
     virtual int functionalWrite(const Addr &addr, PacketPtr) = 0;
     int functionalMemoryWrite(PacketPtr);
 
+    //! Functional warmup hook. Updates this controller's stable coherence
+    //! state for the block at addr as if requestor had just completed a
+    //! request of the given type, with no timing and no messages. A
+    //! REPLACEMENT request type means requestor dropped the block.
+    //! Protocols opt in by defining functionalWarmup() in SLICC; the
+    //! default reports that the protocol has no such hook.
+    virtual bool functionalWarmup(const Addr &addr,
+                                  const RubyRequestType &type,
+                                  const MachineID &requestor,
+                                  const DataBlock &data)
+    { return false; }
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
@@ -136,6 +155,15 @@ class AbstractController : public MemObject, public Consumer
     //! Profiles the delay associated with messages.
     void profileMsgDelay(uint32_t virtualNetwork, Cycles delay);
 
+    //! Records a transition attempt in the transition trace. Only call
+    //! this when m_transition_tracer is set.
+    void traceTransition(Addr addr, int state, int event, int next_state,
+                         int result);
+
+    //! Used by functionalWarmup() hooks to report that this controller
+    //! dropped a block to make room for another one.
+    void functionalWarmupEvict(const Addr &addr);
+
     void stallBuffer(MessageBuffer* buf, Addr addr);
     void wakeUpBuffers(Addr addr);
     void wakeUpAllBuffers(Addr addr);
@@ -165,6 +193,9 @@ class AbstractController : public MemObject, public Consumer
     const unsigned int m_buffer_size;
     Cycles m_recycle_latency;
 
+    //! Binary transition trace, NULL unless this controller is traced
+    TransitionTracer *m_transition_tracer;
+
     //! Counter for the number of cycles when the transitions carried out
     //! were equal to the maximum allowed
     Stats::Scalar m_fully_busy_cycles;
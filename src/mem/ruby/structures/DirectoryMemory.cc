@@ -31,6 +31,8 @@
 
 #include "mem/ruby/structures/DirectoryMemory.hh"
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyStats.hh"
@@ -45,7 +47,11 @@ int DirectoryMemory::m_num_directories_bits = 0;
 int DirectoryMemory::m_numa_high_bit = 0;
 
 DirectoryMemory::DirectoryMemory(const Params *p)
-    : SimObject(p)
+    : SimObject(p), m_page_size_bytes(p->page_size),
+      m_entries_per_page(0), m_entries_per_page_bits(0),
+      m_last_page_num(0), m_last_page(NULL),
+      m_sparse_entries(p->sparse_entries), m_sparse_assoc(p->sparse_assoc),
+      m_sparse_sets(0), m_last_sparse_idx(0), m_last_sparse_tick(MaxTick)
 {
     m_version = p->version;
     // In X86, there is an IO gap in the 3-4GB range.
@@ -65,9 +71,24 @@ void
 DirectoryMemory::init()
 {
     m_num_entries = m_size_bytes / RubySystem::getBlockSizeBytes();
-    m_entries = new AbstractEntry*[m_num_entries];
-    for (int i = 0; i < m_num_entries; i++)
-        m_entries[i] = NULL;
+
+    if (!isPowerOf2(m_page_size_bytes) ||
+        m_page_size_bytes < RubySystem::getBlockSizeBytes()) {
+        fatal("%s: page size %d must be a power of two no smaller than "
+              "the block size\n", name(), m_page_size_bytes);
+    }
+    m_entries_per_page = m_page_size_bytes / RubySystem::getBlockSizeBytes();
+    m_entries_per_page_bits = floorLog2(m_entries_per_page);
+
+    if (m_sparse_entries > 0) {
+        if (m_sparse_assoc == 0 || m_sparse_entries % m_sparse_assoc != 0) {
+            fatal("%s: sparse directory size %d is not a multiple of its "
+                  "associativity %d\n", name(), m_sparse_entries,
+                  m_sparse_assoc);
+        }
+        m_sparse_sets = m_sparse_entries / m_sparse_assoc;
+        m_sparse_tags.resize(m_sparse_sets);
+    }
 
     m_num_directories++;
     m_num_directories_bits = ceilLog2(m_num_directories);
@@ -81,12 +102,46 @@ DirectoryMemory::init()
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    for (uint64_t i = 0; i < m_num_entries; i++) {
-        if (m_entries[i] != NULL) {
-            delete m_entries[i];
+    for (auto &page : m_pages) {
+        for (uint64_t i = 0; i < m_entries_per_page; i++) {
+            delete page.second[i];
         }
+        delete [] page.second;
     }
-    delete [] m_entries;
+}
+
+void
+DirectoryMemory::regStats()
+{
+    SimObject::regStats();
+
+    m_pages_allocated
+        .name(name() + ".pages_allocated")
+        .desc("Number of directory pages allocated")
+        ;
+
+    m_entries_allocated
+        .name(name() + ".entries_allocated")
+        .desc("Number of directory entries allocated")
+        ;
+
+    m_sparse_hits
+        .name(name() + ".sparse_hits")
+        .desc("Number of requests hitting in the sparse directory model")
+        .flags(Stats::nozero)
+        ;
+
+    m_sparse_misses
+        .name(name() + ".sparse_misses")
+        .desc("Number of requests missing in the sparse directory model")
+        .flags(Stats::nozero)
+        ;
+
+    m_sparse_recalls
+        .name(name() + ".sparse_recalls")
+        .desc("Number of entries the sparse directory model had to evict")
+        .flags(Stats::nozero)
+        ;
 }
 
 uint64_t
@@ -122,6 +177,70 @@ DirectoryMemory::mapAddressToLocalIdx(Addr address)
     return ret >> (RubySystem::getBlockSizeBits());
 }
 
+AbstractEntry **
+DirectoryMemory::getPage(uint64_t idx, bool create)
+{
+    uint64_t page_num = idx >> m_entries_per_page_bits;
+    if (m_last_page != NULL && page_num == m_last_page_num) {
+        return m_last_page;
+    }
+
+    auto it = m_pages.find(page_num);
+    if (it == m_pages.end()) {
+        if (!create) {
+            return NULL;
+        }
+
+        DPRINTF(RubyCache, "Allocating directory page %#x\n", page_num);
+        AbstractEntry **page = new AbstractEntry*[m_entries_per_page]();
+        it = m_pages.emplace(page_num, page).first;
+        m_pages_allocated++;
+    }
+
+    m_last_page_num = page_num;
+    m_last_page = it->second;
+    return m_last_page;
+}
+
+void
+DirectoryMemory::sparseAccess(uint64_t idx)
+{
+    std::vector<uint64_t> &set = m_sparse_tags[idx % m_sparse_sets];
+
+    for (auto it = set.begin(); it != set.end(); ++it) {
+        if (*it == idx) {
+            // Move to the MRU position
+            std::rotate(set.begin(), it, it + 1);
+            m_sparse_hits++;
+            return;
+        }
+    }
+
+    m_sparse_misses++;
+    if (set.size() == m_sparse_assoc) {
+        DPRINTF(RubyCache, "Sparse directory recalls entry %#x\n",
+                set.back());
+        set.pop_back();
+        m_sparse_recalls++;
+    }
+    set.insert(set.begin(), idx);
+}
+
+bool
+DirectoryMemory::newSparseRequest(uint64_t idx, const AbstractEntry *entry)
+{
+    // The directory looks a block up many times for every message it
+    // handles, all in the same tick, and the messages that follow a
+    // request, e.g. the memory response, find the block in a transient
+    // state. Only the first lookup of a block in a stable state is a
+    // new request.
+    bool repeat = idx == m_last_sparse_idx && curTick() == m_last_sparse_tick;
+    m_last_sparse_idx = idx;
+    m_last_sparse_tick = curTick();
+
+    return !repeat && entry->getPermission() != AccessPermission_Busy;
+}
+
 AbstractEntry*
 DirectoryMemory::lookup(Addr address)
 {
@@ -130,7 +249,17 @@ DirectoryMemory::lookup(Addr address)
 
     uint64_t idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
-    return m_entries[idx];
+
+    AbstractEntry **page = getPage(idx, false);
+    if (page == NULL) {
+        return NULL;
+    }
+
+    AbstractEntry *entry = page[idx & (m_entries_per_page - 1)];
+    if (entry != NULL && m_sparse_sets > 0 && newSparseRequest(idx, entry)) {
+        sparseAccess(idx);
+    }
+    return entry;
 }
 
 AbstractEntry*
@@ -143,7 +272,20 @@ DirectoryMemory::allocate(Addr address, AbstractEntry *entry)
     idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
     entry->changePermission(AccessPermission_Read_Only);
-    m_entries[idx] = entry;
+
+    AbstractEntry **page = getPage(idx, true);
+    AbstractEntry *&slot = page[idx & (m_entries_per_page - 1)];
+    if (slot == NULL) {
+        m_entries_allocated++;
+    }
+    slot = entry;
+
+    // the lookups that follow the allocation are part of the same request
+    if (m_sparse_sets > 0) {
+        sparseAccess(idx);
+        m_last_sparse_idx = idx;
+        m_last_sparse_tick = curTick();
+    }
 
     return entry;
 }
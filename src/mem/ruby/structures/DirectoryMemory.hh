@@ -31,7 +31,10 @@
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "base/statistics.hh"
 #include "mem/protocol/DirectoryRequestType.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/slicc_interface/AbstractEntry.hh"
@@ -46,6 +49,7 @@ class DirectoryMemory : public SimObject
     ~DirectoryMemory();
 
     void init();
+    void regStats();
 
     uint64_t mapAddressToLocalIdx(Addr address);
     static uint64_t mapAddressToDirectoryVersion(Addr address);
@@ -64,9 +68,38 @@ class DirectoryMemory : public SimObject
     DirectoryMemory(const DirectoryMemory& obj);
     DirectoryMemory& operator=(const DirectoryMemory& obj);
 
+    /**
+     * Return the page of entries holding local index idx, or NULL if that
+     * page has never been touched and create is false.
+     */
+    AbstractEntry **getPage(uint64_t idx, bool create);
+
+    /** Record an access to idx in the sparse directory model. */
+    void sparseAccess(uint64_t idx);
+
+    /**
+     * Is a lookup of entry idx a new request to the directory, rather
+     * than another lookup done for the request in progress?
+     */
+    bool newSparseRequest(uint64_t idx, const AbstractEntry *entry);
+
   private:
     const std::string m_name;
-    AbstractEntry **m_entries;
+
+    /**
+     * Entries are kept in pages of m_entries_per_page blocks that are
+     * only created once a block in them is allocated, so host memory
+     * tracks the footprint of the workload rather than the size of the
+     * simulated memory.
+     */
+    std::unordered_map<uint64_t, AbstractEntry **> m_pages;
+    uint64_t m_page_size_bytes;
+    uint64_t m_entries_per_page;
+    uint64_t m_entries_per_page_bits;
+    //! Most recently used page, to skip the hash lookup on page locality
+    uint64_t m_last_page_num;
+    AbstractEntry **m_last_page;
+
     // int m_size;  // # of memory module blocks this directory is
                     // responsible for
     uint64_t m_size_bytes;
@@ -74,6 +107,27 @@ class DirectoryMemory : public SimObject
     uint64_t m_num_entries;
     int m_version;
 
+    /**
+     * Optional capacity-limited sparse directory model: a set-associative
+     * LRU tag array over the blocks the directory tracks. It only
+     * models capacity and does not evict real entries. A victim picked
+     * from a full set is counted as a recall the protocol would need.
+     */
+    const uint64_t m_sparse_entries;
+    const uint64_t m_sparse_assoc;
+    uint64_t m_sparse_sets;
+    //! Per set, local indices in MRU to LRU order
+    std::vector<std::vector<uint64_t> > m_sparse_tags;
+    //! Last entry looked up, and when
+    uint64_t m_last_sparse_idx;
+    Tick m_last_sparse_tick;
+
+    Stats::Scalar m_pages_allocated;
+    Stats::Scalar m_entries_allocated;
+    Stats::Scalar m_sparse_hits;
+    Stats::Scalar m_sparse_misses;
+    Stats::Scalar m_sparse_recalls;
+
     static int m_num_directories;
     static int m_num_directories_bits;
     static int m_numa_high_bit;
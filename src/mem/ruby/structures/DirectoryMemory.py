@@ -40,4 +40,9 @@ class RubyDirectoryMemory(SimObject):
     # the default value of the numa high bit is specified in the command line
     # option and must be passed into the directory memory sim object
     numa_high_bit = Param.Int("numa high bit")
+    # entries are created lazily, a page at a time, on first allocation
+    page_size = Param.MemorySize("4kB", "granularity of entry allocation")
+    # capacity-limited sparse directory model, disabled when zero
+    sparse_entries = Param.Unsigned(0, "entries in the sparse directory model")
+    sparse_assoc = Param.Unsigned(16, "associativity of the sparse directory")
     system = Param.System(Parent.any, "system object")
@@ -145,6 +145,34 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+uint64_t
+CacheRecorder::functionalWarmup(RubySystem *ruby_system)
+{
+    uint64_t block_size = RubySystem::getBlockSizeBytes();
+
+    while (m_bytes_read < m_uncompressed_trace_size) {
+        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                                                m_bytes_read);
+
+        DPRINTF(RubyCacheTrace, "Installing %s\n", *traceRecord);
+
+        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+                rec_bytes_read += block_size) {
+            DataBlock data;
+            data.setData(traceRecord->m_data + rec_bytes_read, 0, block_size);
+            ruby_system->functionalWarmup(
+                traceRecord->m_data_address + rec_bytes_read,
+                traceRecord->m_type, traceRecord->m_cntrl_id, &data);
+        }
+
+        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
+        m_records_read++;
+    }
+
+    DPRINTF(RubyCacheTrace, "Installed all %d records\n", m_records_read);
+    return m_records_read;
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
@@ -43,6 +43,7 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+class RubySystem;
 class Sequencer;
 
 /*!
@@ -97,6 +98,15 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for warming up the caches functionally. Instead of issuing
+     * fetch requests through the sequencers, it hands every recorded block
+     * to RubySystem::functionalWarmup(), which installs it in a stable
+     * state through the protocol's hooks. Returns the number of records
+     * consumed.
+     */
+    uint64_t functionalWarmup(RubySystem *ruby_system);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
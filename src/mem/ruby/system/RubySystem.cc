@@ -36,14 +36,20 @@
 
 #include "base/intmath.hh"
 #include "base/statistics.hh"
+#include "config/have_protobuf.hh"
 #include "debug/RubyCacheTrace.hh"
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/simple_mem.hh"
+#include "sim/core.hh"
 #include "sim/eventq.hh"
 #include "sim/simulate.hh"
 
+#if HAVE_PROTOBUF
+#include "mem/ruby/profiler/TransitionTracer.hh"
+#endif
+
 using namespace std;
 
 bool RubySystem::m_randomization;
@@ -58,6 +64,8 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
+      m_functional_warmup(p->functional_warmup),
+      m_warmup_trace(p->warmup_trace), m_transition_tracer(NULL),
       m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
@@ -75,6 +83,34 @@ RubySystem::RubySystem(const Params *p)
     // Create the profiler
     m_profiler = new Profiler(p, this);
     m_phys_mem = p->phys_mem;
+
+    if (!p->protocol_trace_file.empty()) {
+#if HAVE_PROTOBUF
+        m_transition_tracer =
+            new TransitionTracer(name(), p->protocol_trace_file,
+                                 p->protocol_trace_ranges,
+                                 p->protocol_trace_machines,
+                                 m_abs_cntrl_vec);
+        // The destructor is not called on exit, so flush the trace from
+        // an exit callback instead
+        registerExitCallback(
+            new MakeCallback<RubySystem,
+                             &RubySystem::closeTransitionTrace>(this));
+#else
+        fatal("%s: protocol_trace_file requires protobuf support\n",
+              name());
+#endif
+    }
+}
+
+void
+RubySystem::closeTransitionTrace()
+{
+#if HAVE_PROTOBUF
+    if (m_transition_tracer != NULL) {
+        m_transition_tracer->close();
+    }
+#endif
 }
 
 void
@@ -96,6 +132,9 @@ RubySystem::~RubySystem()
 {
     delete m_network;
     delete m_profiler;
+#if HAVE_PROTOBUF
+    delete m_transition_tracer;
+#endif
 }
 
 void
@@ -348,7 +387,19 @@ RubySystem::startup()
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
 
-    if (m_warmup_enabled) {
+    if (m_warmup_enabled && m_functional_warmup) {
+        DPRINTF(RubyCacheTrace, "Starting functional ruby cache warmup\n");
+        uint64_t M5_VAR_USED records =
+            m_cache_recorder->functionalWarmup(this);
+        DPRINTF(RubyCacheTrace, "Installed %d records\n", records);
+
+        delete m_cache_recorder;
+        m_cache_recorder = NULL;
+        m_systems_to_warmup--;
+        if (m_systems_to_warmup == 0) {
+            m_warmup_enabled = false;
+        }
+    } else if (m_warmup_enabled) {
         DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
         // save the current tick value
         Tick curtick_original = curTick();
@@ -376,9 +427,111 @@ RubySystem::startup()
         resetClock();
     }
 
+    if (!m_warmup_trace.empty()) {
+        functionalWarmupFromTrace(m_warmup_trace);
+    }
+
     resetStats();
 }
 
+void
+RubySystem::functionalWarmup(Addr addr, RubyRequestType type,
+                             const MachineID &requestor,
+                             const DataBlock &data)
+{
+    Addr line_address = makeLineAddress(addr);
+
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (!cntrl->functionalWarmup(line_address, type, requestor, data)) {
+            fatal("%s: protocol does not provide a functionalWarmup hook\n",
+                  cntrl->name());
+        }
+    }
+}
+
+void
+RubySystem::functionalWarmup(Addr addr, RubyRequestType type, int cntrl,
+                             const DataBlock *data)
+{
+    Addr line_address = makeLineAddress(addr);
+    if (cntrl < 0 || cntrl >= m_abs_cntrl_vec.size()) {
+        fatal("Warmup access to %#x from unknown controller %d\n",
+              line_address, cntrl);
+    }
+
+    DPRINTF(RubyCacheTrace, "Functional warmup %#x type %s from %d\n",
+            line_address, RubyRequestType_to_string(type), cntrl);
+
+    const MachineID &requestor = m_abs_cntrl_vec[cntrl]->getMachineID();
+    if (data != NULL) {
+        functionalWarmup(line_address, type, requestor, *data);
+        return;
+    }
+
+    // Pick up the block's current contents so that the installed copy is
+    // coherent with the rest of the system.
+    DataBlock current;
+    Request req(line_address, getBlockSizeBytes(), 0, Request::funcMasterId);
+    Packet pkt(&req, MemCmd::ReadReq);
+    pkt.dataStatic(current.getDataMod(0));
+
+    if (!functionalRead(&pkt)) {
+        if (m_phys_mem == NULL) {
+            fatal("Unable to read %#x for functional warmup\n",
+                  line_address);
+        }
+        m_phys_mem->functionalAccess(&pkt);
+    }
+
+    functionalWarmup(line_address, type, requestor, current);
+}
+
+void
+RubySystem::functionalWarmupFromTrace(const string &filename)
+{
+    gzFile trace = gzopen(filename.c_str(), "rb");
+    if (trace == NULL) {
+        fatal("Unable to open warmup trace %s\n", filename);
+    }
+
+    const int chunk_records = 4096;
+    vector<WarmupTraceRecord> chunk(chunk_records);
+    const unsigned chunk_bytes = chunk_records * sizeof(WarmupTraceRecord);
+    uint64_t records = 0;
+
+    while (true) {
+        int bytes = gzread(trace, chunk.data(), chunk_bytes);
+        if (bytes < 0) {
+            fatal("Error reading warmup trace %s\n", filename);
+        }
+        if (bytes % sizeof(WarmupTraceRecord) != 0) {
+            fatal("Truncated record in warmup trace %s\n", filename);
+        }
+
+        int n = bytes / sizeof(WarmupTraceRecord);
+        for (int i = 0; i < n; ++i) {
+            if (chunk[i].m_type >= RubyRequestType_NUM) {
+                fatal("Warmup access to %#x of unknown type %d in %s\n",
+                      chunk[i].m_addr, chunk[i].m_type, filename);
+            }
+            functionalWarmup(chunk[i].m_addr,
+                             (RubyRequestType)chunk[i].m_type,
+                             chunk[i].m_cntrl_id);
+        }
+        records += n;
+
+        if (bytes < chunk_bytes) {
+            break;
+        }
+    }
+
+    if (gzclose(trace)) {
+        fatal("Failed to close warmup trace %s\n", filename);
+    }
+
+    inform("Functionally warmed up %d blocks from %s\n", records, filename);
+}
+
 void
 RubySystem::RubyEvent::process()
 {
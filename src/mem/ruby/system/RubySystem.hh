@@ -45,6 +45,7 @@
 #include "sim/clocked_object.hh"
 
 class Network;
+class TransitionTracer;
 class AbstractController;
 
 class RubySystem : public ClockedObject
@@ -94,6 +95,10 @@ class RubySystem : public ClockedObject
         m_profiler->regStats(name());
     }
     void collateStats() { m_profiler->collateStats(); }
+
+    //! The binary SLICC transition trace, or NULL if it is disabled
+    TransitionTracer *getTransitionTracer() { return m_transition_tracer; }
+    void closeTransitionTrace();
     void resetStats() override;
 
     void memWriteback() override;
@@ -105,6 +110,23 @@ class RubySystem : public ClockedObject
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
+    /**
+     * Functional cache warmup. Installs the block at addr in every
+     * controller, in the stable state it would reach once requestor had
+     * completed a request of the given type, without issuing any timing
+     * requests. Relies on the protocol's functionalWarmup() hooks and is
+     * fatal if any controller lacks one.
+     */
+    void functionalWarmup(Addr addr, RubyRequestType type,
+                          const MachineID &requestor, const DataBlock &data);
+
+    /**
+     * As above, for the controller at index cntrl. Without data, the
+     * block's current functional contents are installed.
+     */
+    void functionalWarmup(Addr addr, RubyRequestType type, int cntrl,
+                          const DataBlock *data = NULL);
+
     void registerNetwork(Network*);
     void registerAbstractController(AbstractController*);
 
@@ -130,6 +152,13 @@ class RubySystem : public ClockedObject
     static void writeCompressedTrace(uint8_t *raw_data, std::string file,
                                      uint64_t uncompressed_trace_size);
 
+    /**
+     * Stream a (optionally gzipped) warmup trace of WarmupTraceRecords
+     * and install every block functionally. The trace is read in chunks,
+     * so its size is not bounded by host memory.
+     */
+    void functionalWarmupFromTrace(const std::string &filename);
+
   private:
     // configuration parameters
     static bool m_randomization;
@@ -142,9 +171,12 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_functional_warmup;
+    const std::string m_warmup_trace;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
+    TransitionTracer *m_transition_tracer;
     Cycles m_start_cycle;
 
   public:
@@ -153,6 +185,21 @@ class RubySystem : public ClockedObject
     std::vector<std::map<uint32_t, AbstractController *> > m_abstract_controls;
 };
 
+/**
+ * One entry of a functional warmup trace, as produced by a fast-forwarding
+ * front end, e.g. by util/encode_warmup_trace.py from the packet trace of
+ * a CommMonitor. Records are stored back to back in host byte order.
+ */
+struct WarmupTraceRecord
+{
+    //! Byte address of the access; it is aligned to the block size on use
+    uint64_t m_addr;
+    //! Index of the requesting controller in RubySystem
+    uint32_t m_cntrl_id;
+    //! RubyRequestType of the access, as stored in TraceRecord
+    uint32_t m_type;
+};
+
 class RubyStatsCallback : public Callback
 {
   private:
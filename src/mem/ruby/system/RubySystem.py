@@ -46,6 +46,21 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    functional_warmup = Param.Bool(False, "Restore the cache trace of a \
+        checkpoint by installing blocks directly through the protocol's \
+        functionalWarmup hooks instead of replaying timing requests")
+    warmup_trace = Param.String("", "Trace of WarmupTraceRecords, \
+        optionally gzipped, to functionally warm up the caches with on \
+        startup, e.g. converted from a packet trace by \
+        util/encode_warmup_trace.py")
+
+    protocol_trace_file = Param.String("", "File to write a binary trace \
+        of the SLICC transitions to; empty disables the trace")
+    protocol_trace_ranges = VectorParam.AddrRange([], "Only trace the \
+        transitions of blocks in these ranges; empty traces all blocks")
+    protocol_trace_machines = VectorParam.String([], "Only trace the \
+        transitions of these machine types; empty traces all machines")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
@@ -52,6 +52,9 @@
 
 #include "mem/serial_link.hh"
 
+#include <cmath>
+
+#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/SerialLink.hh"
 #include "params/SerialLink.hh"
@@ -87,9 +90,15 @@ SerialLink::SerialLink(SerialLinkParams *p)
       masterPort(p->name + ".master", *this, slavePort,
                  ticksToCycles(p->delay), p->req_size),
       num_lanes(p->num_lanes),
-      link_speed(p->link_speed)
-
+      link_speed(p->link_speed),
+      flitSize(p->flit_size),
+      flitErrorRate(p->flit_error_rate),
+      retryCycles(ticksToCycles(p->retry_latency))
 {
+    if (flitErrorRate < 0 || flitErrorRate >= 1)
+        fatal("FLIT error rate of %s must be in [0, 1)\n", name());
+    if (flitErrorRate > 0 && flitSize == 0)
+        fatal("%s needs a FLIT size to model CRC errors\n", name());
 }
 
 BaseMasterPort&
@@ -123,6 +132,67 @@ SerialLink::init()
     slavePort.sendRangeChange();
 }
 
+void
+SerialLink::regStats()
+{
+    MemObject::regStats();
+
+    using namespace Stats;
+
+    flits
+        .name(name() + ".flits")
+        .desc("Number of FLITs sent, including the retries");
+
+    crcErrors
+        .name(name() + ".crcErrors")
+        .desc("Number of packets failing the CRC check and sent again");
+}
+
+unsigned
+SerialLink::packetFlits(PacketPtr pkt) const
+{
+    assert(flitSize != 0);
+
+    // one FLIT for the header and tail, and the payload if any
+    return 1 + (pkt->hasData() ? divCeil(pkt->getSize(), flitSize) : 0);
+}
+
+Cycles
+SerialLink::serializationCycles(PacketPtr pkt) const
+{
+    unsigned bytes = flitSize == 0 ? pkt->getSize() :
+        packetFlits(pkt) * flitSize;
+    return Cycles(divCeil(bytes * 8, num_lanes * link_speed));
+}
+
+Cycles
+SerialLink::transmitCycles(PacketPtr pkt)
+{
+    Cycles cycles = serializationCycles(pkt);
+    if (flitSize == 0)
+        return cycles;
+
+    unsigned pkt_flits = packetFlits(pkt);
+    flits += pkt_flits;
+
+    if (flitErrorRate == 0)
+        return cycles;
+
+    // the packet fails its CRC if any of its FLITs is corrupted, and
+    // is then sent again after the retry
+    const double pkt_error_rate = 1 - std::pow(1 - flitErrorRate, pkt_flits);
+    Cycles total = cycles;
+    while (random_mt.random<double>() < pkt_error_rate) {
+        DPRINTF(SerialLink, "CRC error on %s addr 0x%x, retrying\n",
+                pkt->cmdString(), pkt->getAddr());
+        ++crcErrors;
+        flits += pkt_flits;
+        total += retryCycles + cycles;
+    }
+
+    return total;
+}
+
 bool
 SerialLink::SerialLinkSlavePort::respQueueFull() const
 {
@@ -153,17 +223,16 @@ SerialLink::SerialLinkMasterPort::recvTimingResp(PacketPtr pkt)
     // first flit, but the deserializer (at the host side in this case), will
     // have to wait to receive the whole packet. So we only account for the
     // deserialization latency.
-    Cycles cycles = delay;
-    cycles += Cycles(divCeil(pkt->getSize() * 8, serial_link.num_lanes
-                * serial_link.link_speed));
-     Tick t = serial_link.clockEdge(cycles);
+    Cycles link_cycles = serial_link.transmitCycles(pkt);
+    Cycles cycles = delay + link_cycles;
+    Tick t = serial_link.clockEdge(cycles);
 
     //@todo: If the processor sends two uncached requests towards HMC and the
     // second one is smaller than the first one. It may happen that the second
     // one crosses this link faster than the first one (because the packet
     // waits in the link based on its size). This can reorder the received
     // response.
-    slavePort.schedTimingResp(pkt, t);
+    slavePort.schedTimingResp(pkt, t, link_cycles);
 
     return true;
 }
@@ -214,9 +283,8 @@ SerialLink::SerialLinkSlavePort::recvTimingReq(PacketPtr pkt)
             // to check its integrity first. So everytime a packet crosses a
             // serial link, we should account for its deserialization latency
             // only.
-            Cycles cycles = delay;
-            cycles += Cycles(divCeil(pkt->getSize() * 8,
-                    serial_link.num_lanes * serial_link.link_speed));
+            Cycles link_cycles = serial_link.transmitCycles(pkt);
+            Cycles cycles = delay + link_cycles;
             Tick t = serial_link.clockEdge(cycles);
 
             //@todo: If the processor sends two uncached requests towards HMC
@@ -224,7 +292,7 @@ SerialLink::SerialLinkSlavePort::recvTimingReq(PacketPtr pkt)
             // that the second one crosses this link faster than the first one
             // (because the packet waits in the link based on its size).
             // This can reorder the received response.
-            masterPort.schedTimingReq(pkt, t);
+            masterPort.schedTimingReq(pkt, t, link_cycles);
         }
     }
 
@@ -246,7 +314,8 @@ SerialLink::SerialLinkSlavePort::retryStalledReq()
 }
 
 void
-SerialLink::SerialLinkMasterPort::schedTimingReq(PacketPtr pkt, Tick when)
+SerialLink::SerialLinkMasterPort::schedTimingReq(PacketPtr pkt, Tick when,
+                                                 Cycles link_cycles)
 {
     // If we're about to put this packet at the head of the queue, we
     // need to schedule an event to do the transmit.  Otherwise there
@@ -258,12 +327,13 @@ SerialLink::SerialLinkMasterPort::schedTimingReq(PacketPtr pkt, Tick when)
 
     assert(transmitList.size() != reqQueueLimit);
 
-    transmitList.emplace_back(DeferredPacket(pkt, when));
+    transmitList.emplace_back(DeferredPacket(pkt, when, link_cycles));
 }
 
 
 void
-SerialLink::SerialLinkSlavePort::schedTimingResp(PacketPtr pkt, Tick when)
+SerialLink::SerialLinkSlavePort::schedTimingResp(PacketPtr pkt, Tick when,
+                                                 Cycles link_cycles)
 {
     // If we're about to put this packet at the head of the queue, we
     // need to schedule an event to do the transmit.  Otherwise there
@@ -273,7 +343,7 @@ SerialLink::SerialLinkSlavePort::schedTimingResp(PacketPtr pkt, Tick when)
         serial_link.schedule(sendEvent, when);
     }
 
-    transmitList.emplace_back(DeferredPacket(pkt, when));
+    transmitList.emplace_back(DeferredPacket(pkt, when, link_cycles));
 }
 
 void
@@ -301,10 +371,9 @@ SerialLink::SerialLinkMasterPort::trySendTiming()
             DeferredPacket next_req = transmitList.front();
             DPRINTF(SerialLink, "Scheduling next send\n");
 
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
+            // Make sure bandwidth limitation is met, a packet that had
+            // to be retried holding the link for longer
+            Tick t = serial_link.clockEdge(req.linkCycles);
             serial_link.schedule(sendEvent, std::max(next_req.tick, t));
         }
 
@@ -346,10 +415,9 @@ SerialLink::SerialLinkSlavePort::trySendTiming()
             DeferredPacket next_resp = transmitList.front();
             DPRINTF(SerialLink, "Scheduling next send\n");
 
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
+            // Make sure bandwidth limitation is met, a packet that had
+            // to be retried holding the link for longer
+            Tick t = serial_link.clockEdge(resp.linkCycles);
             serial_link.schedule(sendEvent, std::max(next_resp.tick, t));
         }
 
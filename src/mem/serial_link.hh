@@ -55,6 +55,7 @@
 
 #include <deque>
 
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "params/SerialLink.hh"
@@ -65,6 +66,9 @@
  * serializer component at the transmitter side does not need to receive the
  * whole packet to start the serialization. But the deserializer waits for the
  * complete packet to check its integrity first.
+ *
+ * The link is optionally packetized in FLITs as in HMC, in which case a
+ * packet failing its CRC check is sent again after a link-level retry.
   */
 class SerialLink : public MemObject
 {
@@ -72,7 +76,8 @@ class SerialLink : public MemObject
 
     /**
      * A deferred packet stores a packet along with its scheduled
-     * transmission time
+     * transmission time, and the cycles it occupies the link for,
+     * including any retries
      */
     class DeferredPacket
     {
@@ -81,8 +86,10 @@ class SerialLink : public MemObject
 
         const Tick tick;
         const PacketPtr pkt;
+        const Cycles linkCycles;
 
-        DeferredPacket(PacketPtr _pkt, Tick _tick) : tick(_tick), pkt(_pkt)
+        DeferredPacket(PacketPtr _pkt, Tick _tick, Cycles _link_cycles)
+            : tick(_tick), pkt(_pkt), linkCycles(_link_cycles)
         { }
     };
 
@@ -173,8 +180,9 @@ class SerialLink : public MemObject
          *
          * @param pkt a response to send out after a delay
          * @param when tick when response packet should be sent
+         * @param link_cycles cycles the response occupies the link for
          */
-        void schedTimingResp(PacketPtr pkt, Tick when);
+        void schedTimingResp(PacketPtr pkt, Tick when, Cycles link_cycles);
 
         /**
          * Retry any stalled request that we have failed to accept at
@@ -279,8 +287,9 @@ class SerialLink : public MemObject
          *
          * @param pkt a request to send out after a delay
          * @param when tick when response packet should be sent
+         * @param link_cycles cycles the request occupies the link for
          */
-        void schedTimingReq(PacketPtr pkt, Tick when);
+        void schedTimingReq(PacketPtr pkt, Tick when, Cycles link_cycles);
 
         /**
          * Check a functional request against the packets in our
@@ -315,6 +324,30 @@ class SerialLink : public MemObject
     /** Speed of each link (Gb/s) in this serial link */
     uint64_t link_speed;
 
+    /** Size of a FLIT in bytes, 0 if the link is not packetized */
+    const unsigned flitSize;
+
+    /** Probability of a FLIT failing the CRC check */
+    const double flitErrorRate;
+
+    /** Latency of a link-level retry */
+    const Cycles retryCycles;
+
+    /** Number of FLITs a packet is sent as */
+    unsigned packetFlits(PacketPtr pkt) const;
+
+    /** Cycles to serialize a packet once */
+    Cycles serializationCycles(PacketPtr pkt) const;
+
+    /**
+     * Cycles to get a packet across the link, including any retries
+     * after failed CRC checks.
+     */
+    Cycles transmitCycles(PacketPtr pkt);
+
+    Stats::Scalar flits;
+    Stats::Scalar crcErrors;
+
   public:
 
     virtual BaseMasterPort& getMasterPort(const std::string& if_name,
@@ -324,6 +357,8 @@ class SerialLink : public MemObject
 
     virtual void init();
 
+    void regStats() override;
+
     typedef SerialLinkParams Params;
 
     SerialLink(SerialLinkParams *p);
@@ -272,6 +272,15 @@ SimpleMemory::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+Tick
+SimpleMemory::MemoryPort::recvAtomicBackdoor(PacketPtr pkt,
+                                             MemBackdoorPtr& backdoor)
+{
+    Tick latency = memory.recvAtomic(pkt);
+    memory.getBackdoor(backdoor);
+    return latency;
+}
+
 void
 SimpleMemory::MemoryPort::recvFunctional(PacketPtr pkt)
 {
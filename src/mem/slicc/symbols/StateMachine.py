@@ -309,6 +309,8 @@ class $c_ident : public AbstractController
     void collateStats();
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
+    void transitionNames(std::vector<std::string> &states,
+                         std::vector<std::string> &events) const;
     Sequencer* getCPUSequencer() const;
     GPUCoalescer* getGPUCoalescer() const;
 
@@ -401,6 +403,18 @@ void unset_tbe(${{self.TBEType.c_ident}}*& m_tbe_ptr);
 
 // Actions
 ''')
+        if self.TBEType != None and self.EntryType != None:
+            code('typedef void (${c_ident}::*ActionFn)('
+                 '${{self.TBEType.c_ident}}*&, '
+                 '${{self.EntryType.c_ident}}*&, Addr);')
+        elif self.TBEType != None:
+            code('typedef void (${c_ident}::*ActionFn)('
+                 '${{self.TBEType.c_ident}}*&, Addr);')
+        elif self.EntryType != None:
+            code('typedef void (${c_ident}::*ActionFn)('
+                 '${{self.EntryType.c_ident}}*&, Addr);')
+        else:
+            code('typedef void (${c_ident}::*ActionFn)(Addr);')
         if self.TBEType != None and self.EntryType != None:
             for action in self.actions.itervalues():
                 code('/** \\brief ${{action.desc}} */')
@@ -934,6 +948,18 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
+void
+$c_ident::transitionNames(std::vector<std::string> &states,
+                          std::vector<std::string> &events) const
+{
+    for (int i = 0; i < ${ident}_State_NUM; i++) {
+        states.push_back(${ident}_State_to_string(${ident}_State(i)));
+    }
+    for (int i = 0; i < ${ident}_Event_NUM; i++) {
+        events.push_back(${ident}_Event_to_string(${ident}_Event(i)));
+    }
+}
+
 // Actions
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1078,6 +1104,24 @@ $c_ident::functionalWriteBuffers(PacketPtr& pkt)
 
         port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
 
+        # Message buffers feeding in_ports get a bit in a per-iteration
+        # ready mask so that ports whose buffer holds no ready message are
+        # skipped without running (and peeking in) the port code at all.
+        # Other in_port sources, e.g. TimerTables, are always evaluated.
+        msg_buffer_params = set(param.ident for param in self.config_parameters
+                                if param.pointer and
+                                str(param.type_ast.type) == "MessageBuffer")
+        ready_bits = orderdict()
+        for port in self.in_ports:
+            buf = port.pairs["buffer_expr"].name
+            if buf in msg_buffer_params and buf not in ready_bits:
+                ready_bits[buf] = len(ready_bits)
+        if len(ready_bits) > 64:
+            ready_bits = orderdict()
+        all_ports_masked = len(ready_bits) > 0 and \
+            all(port.pairs["buffer_expr"].name in ready_bits
+                for port in self.in_ports)
+
         code('''
 
 using namespace std;
@@ -1101,6 +1145,25 @@ ${ident}_Controller::wakeup()
         }
 ''')
 
+        if ready_bits:
+            code('''
+
+        uint64_t in_port_ready = 0;
+''')
+            for buf, bit in ready_bits.iteritems():
+                code('''
+        if (m_${buf}_ptr->isReady(clockEdge()))
+            in_port_ready |= ULL(1) << $bit;
+''')
+            if all_ports_masked:
+                code('''
+
+        // Nothing is ready on any in_port
+        if (in_port_ready == 0)
+            break;
+''')
+            code('')
+
         code.indent()
         code.indent()
 
@@ -1113,6 +1176,10 @@ ${ident}_Controller::wakeup()
                 code('m_cur_in_port = ${{port.pairs["rank"]}};')
             else:
                 code('m_cur_in_port = 0;')
+            buf = port.pairs["buffer_expr"].name
+            if buf in ready_bits:
+                code('if (in_port_ready & (ULL(1) << ${{ready_bits[buf]}})) {')
+                code.indent()
             if port in port_to_buf_map:
                 code('try {')
                 code.indent()
@@ -1125,6 +1192,9 @@ ${ident}_Controller::wakeup()
                 rejected[${{port_to_buf_map[port]}}]++;
             }
 ''')
+            if buf in ready_bits:
+                code.dedent()
+                code('}')
             code.dedent()
             code('')
 
@@ -1231,6 +1301,10 @@ TransitionResult result =
 
         code('''
 
+if (m_transition_tracer != NULL) {
+    traceTransition(addr, state, event, next_state, result);
+}
+
 if (result == TransitionResult_Valid) {
     DPRINTF(RubyGenerated, "next_state: %s\\n",
             ${ident}_State_to_string(next_state));
@@ -1299,16 +1373,17 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         Addr addr)
 {
-    switch(HASH_FUN(state, event)) {
 ''')
 
-        # This map will allow suppress generating duplicate code
+        # Each unique transition body (next state, resource checks,
+        # request types and stalls) becomes one densely numbered case, and
+        # the actions it runs become a contiguous slice of a flat action
+        # list. Transitions that share both body and action list share a
+        # case, which suppresses generating duplicate code.
         cases = orderdict()
+        case_of_trans = {}
 
         for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
             case = self.symtab.codeFormatter()
             # Only set next_state if it changes
             if trans.state != trans.nextState:
@@ -1365,37 +1440,87 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
 
             if stall:
                 case('return TransitionResult_ProtocolStall;')
+                action_idents = ()
             else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
+                action_idents = tuple(a.ident for a in actions)
 
-            case = str(case)
+            key = (str(case), action_idents)
 
             # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
+            if key not in cases:
+                cases[key] = (len(cases), stall)
 
-            cases[case].append(case_string)
+            case_of_trans[(trans.state.ident, trans.event.ident)] = \
+                cases[key][0]
 
-        # Walk through all of the unique code blocks and spit out the
-        # corresponding case statement elements
-        for case,transitions in cases.iteritems():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
-            code('    $case\n')
+        # Dense (state, event) -> case table, laid out in HASH_FUN order.
+        # -1 marks a pair with no transition.
+        code('''
+    static const int16_t transitionCase[${ident}_State_NUM *
+                                        ${ident}_Event_NUM] = {
+''')
+        code.indent()
+        code.indent()
+        for state in self.states.itervalues():
+            row = [ str(case_of_trans.get((state.ident, event.ident), -1))
+                    for event in self.events.itervalues() ]
+            code('// ${{state.ident}}')
+            for i in range(0, len(row), 16):
+                code('${{", ".join(row[i:i + 16])}},')
+        code.dedent()
+        code.dedent()
+        code('''
+    };
+
+''')
+
+        # Flat action list; case N runs actions
+        # [actionBegin[N], actionBegin[N + 1]).
+        action_begin = []
+        action_list = []
+        for (body, action_idents), (idx, stall) in cases.iteritems():
+            action_begin.append(len(action_list))
+            action_list.extend(action_idents)
+        action_begin.append(len(action_list))
+
+        if action_list:
+            code('    static const ActionFn actionList[] = {')
+            for action_ident in action_list:
+                code('        &${ident}_Controller::${action_ident},')
+            code('    };')
+        else:
+            code('    static const ActionFn *actionList = NULL;')
+
+        code('''
+    static const uint16_t actionBegin[${{len(action_begin)}}] = {
+''')
+        for i in range(0, len(action_begin), 16):
+            code('        ${{", ".join(str(a) for a in action_begin[i:i + 16])}},')
+        code('''
+    };
+
+    const int trans_case = transitionCase[HASH_FUN(state, event)];
+    switch (trans_case) {
+''')
+
+        # Cases that differ only in their action lists share a body
+        bodies = orderdict()
+        for (body, action_idents), (idx, stall) in cases.iteritems():
+            if body not in bodies:
+                bodies[body] = ([], stall)
+            bodies[body][0].append(idx)
+
+        for body,(idxs, stall) in bodies.iteritems():
+            for idx in idxs:
+                code('      case $idx:')
+            code.indent()
+            code.indent()
+            code('$body')
+            if not stall:
+                code('break;')
+            code.dedent()
+            code.dedent()
+            code('')
 
         code('''
       default:
@@ -1404,6 +1529,20 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
               name(), curCycle(), addr, event, state);
     }
 
+    for (int i = actionBegin[trans_case]; i < actionBegin[trans_case + 1];
+         ++i) {
+''')
+        if self.TBEType != None and self.EntryType != None:
+            code('        (this->*actionList[i])(m_tbe_ptr, m_cache_entry_ptr, addr);')
+        elif self.TBEType != None:
+            code('        (this->*actionList[i])(m_tbe_ptr, addr);')
+        elif self.EntryType != None:
+            code('        (this->*actionList[i])(m_cache_entry_ptr, addr);')
+        else:
+            code('        (this->*actionList[i])(addr);')
+        code('''
+    }
+
     return TransitionResult_Valid;
 }
 ''')
@@ -0,0 +1,677 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * TieredMemory definitions
+ */
+
+#include "mem/tiered_memory.hh"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "debug/TieredMemory.hh"
+#include "sim/system.hh"
+
+// number of fast frames looked at for a cold victim
+static const unsigned coldFrameProbes = 32;
+
+TieredMemory::TieredMemory(const TieredMemoryParams* p)
+    : AddrMapper(p),
+      system(p->system),
+      masterId(p->system->getMasterId(name())),
+      fastRange(p->fast_range), slowRange(p->slow_range),
+      pageSize(p->page_size), policy(p->policy), epoch(p->epoch),
+      hotThreshold(p->hot_threshold),
+      migrationsPerEpoch(p->migrations_per_epoch),
+      blockSize(p->migration_block),
+      blocksPerPage(p->page_size / p->migration_block),
+      maxCopyReqs(p->migration_reqs),
+      migrationLatency(p->migration_latency),
+      migrationsThisEpoch(0), coldHand(p->fast_range.start()),
+      migration(nullptr), blockedCopy(nullptr), retryPending(false),
+      commitEvent(this), epochEvent(this)
+{
+    fatal_if(!isPowerOf2(pageSize), "%s: page size %d is not a power of "
+             "two\n", name(), pageSize);
+    fatal_if(!isPowerOf2(blockSize) || blockSize > pageSize,
+             "%s: migration block of %d bytes does not divide the %d byte "
+             "pages\n", name(), blockSize, pageSize);
+    fatal_if(maxCopyReqs == 0, "%s: migrations need at least one copy "
+             "request in flight\n", name());
+
+    // pages are swapped frame by frame, so the tiers have to be
+    // contiguous, disjoint and made of whole pages
+    fatal_if(fastRange.interleaved() || slowRange.interleaved(),
+             "%s: the tiers cannot be interleaved\n", name());
+    fatal_if(fastRange.intersects(slowRange), "%s: fast tier %s and slow "
+             "tier %s overlap\n", name(), fastRange.to_string(),
+             slowRange.to_string());
+    fatal_if(fastRange.start() % pageSize || fastRange.size() % pageSize ||
+             slowRange.start() % pageSize || slowRange.size() % pageSize,
+             "%s: the tiers are not made of whole pages\n", name());
+}
+
+TieredMemory::~TieredMemory()
+{
+    delete migration;
+}
+
+void
+TieredMemory::init()
+{
+    AddrMapper::init();
+}
+
+void
+TieredMemory::startup()
+{
+    schedule(epochEvent, curTick() + epoch);
+}
+
+AddrRangeList
+TieredMemory::getAddrRanges() const
+{
+    // the flat address space is the union of the two tiers
+    AddrRangeList ranges;
+    ranges.push_back(fastRange);
+    ranges.push_back(slowRange);
+    return ranges;
+}
+
+Addr
+TieredMemory::remapAddr(Addr addr) const
+{
+    return frameOf(pageOf(addr)) + (addr & (pageSize - 1));
+}
+
+Addr
+TieredMemory::frameOf(Addr page) const
+{
+    auto f = pageToFrame.find(page);
+    return f == pageToFrame.end() ? page : f->second;
+}
+
+Addr
+TieredMemory::pageIn(Addr frame) const
+{
+    auto p = frameToPage.find(frame);
+    return p == frameToPage.end() ? frame : p->second;
+}
+
+void
+TieredMemory::setFrame(Addr page, Addr frame)
+{
+    if (page == frame) {
+        pageToFrame.erase(page);
+        frameToPage.erase(frame);
+    } else {
+        pageToFrame[page] = frame;
+        frameToPage[frame] = page;
+    }
+}
+
+uint32_t
+TieredMemory::accessesTo(Addr page) const
+{
+    auto a = pageAccesses.find(page);
+    return a == pageAccesses.end() ? 0 : a->second;
+}
+
+bool
+TieredMemory::isMigrating(Addr page) const
+{
+    return migration &&
+        (page == migration->hotPage || page == migration->coldPage);
+}
+
+void
+TieredMemory::recvFunctional(PacketPtr pkt)
+{
+    Addr page = pageOf(pkt->getAddr());
+
+    if (pkt->isPrint()) {
+        AddrMapper::recvFunctional(pkt);
+        return;
+    }
+
+    // the held requests are the most recent view of the page
+    auto h = heldReqs.find(page);
+    if (h != heldReqs.end()) {
+        if (pkt->isRead()) {
+            for (auto p = h->second.rbegin(); p != h->second.rend(); ++p) {
+                if (pkt->checkFunctional(*p)) {
+                    pkt->makeResponse();
+                    return;
+                }
+            }
+        } else {
+            for (auto p : h->second)
+                pkt->checkFunctional(p);
+        }
+    }
+
+    if (!isMigrating(page)) {
+        AddrMapper::recvFunctional(pkt);
+        return;
+    }
+
+    // while the pages are read, the old frames are still the ones to
+    // go by, but writes also have to update what was already copied
+    // to the buffer; once the pages are written, the buffer replaces
+    // the old frames, and writes have to reach the new ones
+    bool hot = page == migration->hotPage;
+    uint8_t* buf = &migration->data[hot ? 0 : pageSize];
+
+    if (pkt->isRead()) {
+        if (migration->writing &&
+            pkt->checkFunctional(nullptr, page, pkt->isSecure(), pageSize,
+                                 buf)) {
+            pkt->makeResponse();
+            return;
+        }
+        AddrMapper::recvFunctional(pkt);
+        return;
+    }
+
+    pkt->checkFunctional(nullptr, page, pkt->isSecure(), pageSize, buf);
+
+    if (!migration->writing) {
+        AddrMapper::recvFunctional(pkt);
+        return;
+    }
+
+    Addr orig_addr = pkt->getAddr();
+    Addr new_frame = hot ? migration->fastFrame : migration->slowFrame;
+    pkt->setAddr(new_frame + (orig_addr - page));
+    if (blockedCopy)
+        pkt->checkFunctional(blockedCopy);
+    masterPort.sendFunctional(pkt);
+    pkt->setAddr(orig_addr);
+}
+
+bool
+TieredMemory::recvTimingReq(PacketPtr pkt)
+{
+    Addr page = pageOf(pkt->getAddr());
+
+    // hold off everything while a copy request waits for the master
+    // port
+    if (blockedCopy) {
+        retryPending = true;
+        return false;
+    }
+
+    // queue the requests to the pages being migrated until the
+    // migration is done, and the later ones behind them
+    if (isMigrating(page) || heldReqs.count(page)) {
+        DPRINTF(TieredMemory, "Holding %s %#x to page %#x\n",
+                pkt->cmdString(), pkt->getAddr(), page);
+        ++migrationStalls;
+        heldReqs[page].push_back(pkt);
+        return true;
+    }
+
+    if (!AddrMapper::recvTimingReq(pkt)) {
+        retryPending = true;
+        return false;
+    }
+
+    recordAccess(page);
+    return true;
+}
+
+void
+TieredMemory::recordAccess(Addr page)
+{
+    Addr frame = frameOf(page);
+
+    if (fastRange.contains(frame))
+        ++fastAccesses;
+    else
+        ++slowAccesses;
+
+    uint32_t& accesses = pageAccesses[page];
+    ++accesses;
+
+    // with the threshold policy, a slow page is migrated as soon as
+    // it turns hot
+    if (policy == Enums::threshold && accesses == hotThreshold &&
+        slowRange.contains(frame)) {
+        DPRINTF(TieredMemory, "Page %#x turned hot\n", page);
+        hotPages.push_back(page);
+        startMigration();
+    }
+}
+
+bool
+TieredMemory::releaseHeld()
+{
+    for (auto h = heldReqs.begin(); h != heldReqs.end(); ) {
+        // the page may turn hot again, and be migrated anew
+        auto& queue = h->second;
+        while (!queue.empty() && !isMigrating(h->first)) {
+            if (!AddrMapper::recvTimingReq(queue.front()))
+                return false;
+            queue.pop_front();
+            recordAccess(h->first);
+        }
+
+        if (queue.empty())
+            h = heldReqs.erase(h);
+        else
+            ++h;
+    }
+
+    return true;
+}
+
+bool
+TieredMemory::recvTimingResp(PacketPtr pkt)
+{
+    CopyState* copy_state = dynamic_cast<CopyState*>(pkt->senderState);
+
+    if (copy_state == NULL)
+        return AddrMapper::recvTimingResp(pkt);
+
+    pkt->popSenderState();
+    recvCopyResp(pkt, copy_state->block);
+    delete copy_state;
+    return true;
+}
+
+void
+TieredMemory::recvReqRetry()
+{
+    if (blockedCopy) {
+        PacketPtr pkt = blockedCopy;
+        blockedCopy = nullptr;
+
+        if (!masterPort.sendTimingReq(pkt)) {
+            blockedCopy = pkt;
+            return;
+        }
+
+        sendCopyReqs();
+
+        // still blocked, wait for the next retry
+        if (blockedCopy)
+            return;
+    }
+
+    // the held requests go before the ones we refused
+    if (!releaseHeld())
+        return;
+
+    retryBlocked();
+    checkDrained();
+}
+
+void
+TieredMemory::retryBlocked()
+{
+    if (retryPending) {
+        retryPending = false;
+        slavePort.sendRetryReq();
+    }
+}
+
+void
+TieredMemory::checkDrained()
+{
+    if (drainState() == DrainState::Draining && !migration &&
+        heldReqs.empty()) {
+        DPRINTF(Drain, "Tiered memory done migrating\n");
+        signalDrainDone();
+    }
+}
+
+Addr
+TieredMemory::findColdFrame()
+{
+    Addr cold_frame = coldHand;
+    uint32_t cold_accesses = std::numeric_limits<uint32_t>::max();
+
+    for (unsigned i = 0; i < coldFrameProbes; ++i) {
+        Addr frame = coldHand;
+
+        coldHand += pageSize;
+        if (!fastRange.contains(coldHand))
+            coldHand = fastRange.start();
+
+        uint32_t accesses = accessesTo(pageIn(frame));
+        if (accesses < cold_accesses) {
+            cold_frame = frame;
+            cold_accesses = accesses;
+
+            // cannot get any colder than this
+            if (accesses == 0)
+                break;
+        }
+    }
+
+    return cold_frame;
+}
+
+void
+TieredMemory::startMigration()
+{
+    // copies are timing requests, and nothing new starts when draining
+    if (migration || !system->isTimingMode() ||
+        drainState() != DrainState::Running)
+        return;
+
+    while (!hotPages.empty() && migrationsThisEpoch < migrationsPerEpoch) {
+        Addr hot_page = hotPages.front();
+        hotPages.pop_front();
+
+        // the page may have moved since it was found hot
+        Addr slow_frame = frameOf(hot_page);
+        if (!slowRange.contains(slow_frame))
+            continue;
+
+        Addr fast_frame = findColdFrame();
+        Addr cold_page = pageIn(fast_frame);
+
+        // no point in swapping the page with a hotter one
+        if (accessesTo(cold_page) >= accessesTo(hot_page))
+            continue;
+
+        migration = new Migration;
+        migration->hotPage = hot_page;
+        migration->coldPage = cold_page;
+        migration->slowFrame = slow_frame;
+        migration->fastFrame = fast_frame;
+        migration->data.resize(2 * pageSize);
+        migration->writing = false;
+        migration->nextBlock = 0;
+        migration->outstanding = 0;
+        migration->done = 0;
+        migration->startTick = curTick();
+
+        ++migrationsThisEpoch;
+
+        DPRINTF(TieredMemory, "Migrating page %#x from %#x to %#x and "
+                "page %#x the other way\n", hot_page, slow_frame,
+                fast_frame, cold_page);
+
+        sendCopyReqs();
+        return;
+    }
+}
+
+void
+TieredMemory::sendCopyReqs()
+{
+    assert(migration);
+
+    while (!blockedCopy && migration->outstanding < maxCopyReqs &&
+           migration->nextBlock < 2 * blocksPerPage) {
+        unsigned block = migration->nextBlock;
+
+        // the first half of the buffer is read from the slow frame
+        // and written to the fast one, the second half the other way
+        // round
+        bool slow_half = block < blocksPerPage;
+        Addr frame = slow_half != migration->writing ?
+            migration->slowFrame : migration->fastFrame;
+        Addr addr = frame + (block % blocksPerPage) * blockSize;
+
+        Request* req = new Request(addr, blockSize, 0, masterId);
+        PacketPtr pkt;
+
+        if (migration->writing) {
+            pkt = new Packet(req, MemCmd::WriteReq);
+            pkt->allocate();
+            pkt->setData(&migration->data[block * blockSize]);
+        } else {
+            pkt = new Packet(req, MemCmd::ReadReq);
+            pkt->allocate();
+        }
+
+        pkt->pushSenderState(new CopyState(block));
+
+        ++migration->nextBlock;
+        ++migration->outstanding;
+
+        if (!masterPort.sendTimingReq(pkt))
+            blockedCopy = pkt;
+    }
+}
+
+void
+TieredMemory::recvCopyResp(PacketPtr pkt, unsigned block)
+{
+    assert(migration && migration->outstanding != 0);
+
+    if (!migration->writing)
+        pkt->writeData(&migration->data[block * blockSize]);
+
+    delete pkt->req;
+    delete pkt;
+
+    --migration->outstanding;
+    ++migration->done;
+
+    if (migration->done == 2 * blocksPerPage) {
+        if (migration->writing) {
+            // all copied, the remapping takes a while longer
+            schedule(commitEvent, curTick() + migrationLatency);
+            return;
+        }
+
+        // both pages are read, and can now be overwritten
+        migration->writing = true;
+        migration->nextBlock = 0;
+        migration->done = 0;
+    }
+
+    sendCopyReqs();
+}
+
+void
+TieredMemory::commitMigration()
+{
+    assert(migration && migration->outstanding == 0);
+
+    setFrame(migration->hotPage, migration->fastFrame);
+    setFrame(migration->coldPage, migration->slowFrame);
+
+    ++migrations;
+    migrationBytes += 4 * pageSize;
+    totMigrationLat += curTick() - migration->startTick;
+
+    DPRINTF(TieredMemory, "Page %#x now in %#x, page %#x in %#x\n",
+            migration->hotPage, migration->fastFrame, migration->coldPage,
+            migration->slowFrame);
+
+    delete migration;
+    migration = nullptr;
+
+    // let the requests to the two pages through again, and wait for
+    // a retry if the master port refuses one of them
+    releaseHeld();
+
+    if (drainState() == DrainState::Draining)
+        checkDrained();
+    else
+        startMigration();
+}
+
+void
+TieredMemory::processEpochEvent()
+{
+    // with the epoch policy, migrate the hottest pages of the slow
+    // tier, up to the number of migrations allowed per epoch
+    if (policy == Enums::epoch) {
+        std::vector<std::pair<uint32_t, Addr>> hot;
+
+        for (const auto& a : pageAccesses) {
+            if (a.second >= hotThreshold &&
+                slowRange.contains(frameOf(a.first)))
+                hot.emplace_back(a.second, a.first);
+        }
+
+        size_t nbr_hot = std::min<size_t>(hot.size(), migrationsPerEpoch);
+        std::partial_sort(hot.begin(), hot.begin() + nbr_hot, hot.end(),
+                          std::greater<std::pair<uint32_t, Addr>>());
+
+        hotPages.clear();
+        for (size_t i = 0; i < nbr_hot; ++i)
+            hotPages.push_back(hot[i].second);
+    }
+
+    // age the access counts, so they follow the recent accesses
+    for (auto a = pageAccesses.begin(); a != pageAccesses.end(); ) {
+        a->second /= 2;
+        if (a->second == 0)
+            a = pageAccesses.erase(a);
+        else
+            ++a;
+    }
+
+    migrationsThisEpoch = 0;
+    startMigration();
+
+    schedule(epochEvent, curTick() + epoch);
+}
+
+DrainState
+TieredMemory::drain()
+{
+    if (migration) {
+        DPRINTF(Drain, "Tiered memory not drained, migrating page %#x\n",
+                migration->hotPage);
+        return DrainState::Draining;
+    }
+
+    if (!heldReqs.empty()) {
+        DPRINTF(Drain, "Tiered memory not drained, %d pages with held "
+                "requests\n", heldReqs.size());
+        return DrainState::Draining;
+    }
+
+    return DrainState::Drained;
+}
+
+void
+TieredMemory::drainResume()
+{
+    startMigration();
+}
+
+void
+TieredMemory::serialize(CheckpointOut &cp) const
+{
+    // the data of the moved pages lives in their new frames
+    std::vector<Addr> pages;
+    std::vector<Addr> frames;
+
+    for (const auto& p : pageToFrame) {
+        pages.push_back(p.first);
+        frames.push_back(p.second);
+    }
+
+    SERIALIZE_CONTAINER(pages);
+    SERIALIZE_CONTAINER(frames);
+}
+
+void
+TieredMemory::unserialize(CheckpointIn &cp)
+{
+    std::vector<Addr> pages;
+    std::vector<Addr> frames;
+
+    UNSERIALIZE_CONTAINER(pages);
+    UNSERIALIZE_CONTAINER(frames);
+
+    fatal_if(pages.size() != frames.size(), "%s: corrupt page mapping in "
+             "checkpoint\n", name());
+
+    for (size_t i = 0; i < pages.size(); ++i)
+        setFrame(pages[i], frames[i]);
+}
+
+void
+TieredMemory::regStats()
+{
+    AddrMapper::regStats();
+
+    using namespace Stats;
+
+    fastAccesses
+        .name(name() + ".fastAccesses")
+        .desc("Demand accesses served by the fast tier");
+
+    slowAccesses
+        .name(name() + ".slowAccesses")
+        .desc("Demand accesses served by the slow tier");
+
+    fastHitRate
+        .name(name() + ".fastHitRate")
+        .desc("Fraction of the demand accesses served by the fast tier")
+        .precision(4);
+
+    fastHitRate = fastAccesses / (fastAccesses + slowAccesses);
+
+    migrations
+        .name(name() + ".migrations")
+        .desc("Number of page swaps between the tiers");
+
+    migrationBytes
+        .name(name() + ".migrationBytes")
+        .desc("Bytes read and written to swap pages");
+
+    migrationStalls
+        .name(name() + ".migrationStalls")
+        .desc("Requests held as their page was being migrated");
+
+    totMigrationLat
+        .name(name() + ".totMigrationLat")
+        .desc("Total ticks spent swapping pages");
+
+    avgMigrationLat
+        .name(name() + ".avgMigrationLat")
+        .desc("Average ticks per page swap")
+        .precision(2);
+
+    avgMigrationLat = totMigrationLat / migrations;
+}
+
+TieredMemory*
+TieredMemoryParams::create()
+{
+    return new TieredMemory(this);
+}
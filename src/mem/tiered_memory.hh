@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * TieredMemory declaration
+ */
+
+#ifndef __MEM_TIERED_MEMORY_HH__
+#define __MEM_TIERED_MEMORY_HH__
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "enums/TierPolicy.hh"
+#include "mem/addr_mapper.hh"
+#include "params/TieredMemory.hh"
+
+class System;
+
+/**
+ * A tiered memory presents a flat physical address space made of a
+ * fast (DRAM) and a slow (e.g. NVM) tier, each served by its own
+ * controller behind the master port. Initially every page lives in
+ * the frame with the same address. The accesses to every page are
+ * counted over an epoch, and hot pages of the slow tier are swapped
+ * with cold pages of the fast tier, after which the flat addresses of
+ * the two pages are remapped to their new frames.
+ *
+ * The pages are copied with timing requests through the master port,
+ * so a migration takes bandwidth from both tiers, and demand requests
+ * to the two pages are queued until the copy and remapping are done,
+ * while the other pages remain accessible. Functional accesses follow
+ * the copy held in the migration buffer. Migrations are only done in
+ * timing mode, one at a time.
+ */
+class TieredMemory : public AddrMapper
+{
+
+  public:
+
+    TieredMemory(const TieredMemoryParams* p);
+
+    ~TieredMemory();
+
+    void init();
+
+    void startup();
+
+    void regStats();
+
+    DrainState drain() override;
+
+    void drainResume() override;
+
+    void serialize(CheckpointOut &cp) const override;
+
+    void unserialize(CheckpointIn &cp) override;
+
+    AddrRangeList getAddrRanges() const;
+
+  protected:
+
+    Addr remapAddr(Addr addr) const;
+
+    void recvFunctional(PacketPtr pkt);
+
+    bool recvTimingReq(PacketPtr pkt);
+
+    bool recvTimingResp(PacketPtr pkt);
+
+    void recvReqRetry();
+
+  private:
+
+    /**
+     * Sender state of the copy requests of a migration, identifying
+     * the block they carry.
+     */
+    class CopyState : public Packet::SenderState
+    {
+
+      public:
+
+        CopyState(unsigned _block) : block(_block)
+        { }
+
+        /** Block of the migration buffer */
+        const unsigned block;
+
+    };
+
+    /**
+     * A swap of a hot page of the slow tier and a cold page of the
+     * fast tier. The buffer holds the content of the slow frame
+     * followed by the one of the fast frame, read in the first phase
+     * and written to the other frame in the second.
+     */
+    struct Migration
+    {
+        Addr hotPage;
+        Addr coldPage;
+        Addr slowFrame;
+        Addr fastFrame;
+
+        std::vector<uint8_t> data;
+
+        bool writing;
+        unsigned nextBlock;
+        unsigned outstanding;
+        unsigned done;
+
+        Tick startTick;
+    };
+
+    /** Page of an address */
+    Addr pageOf(Addr addr) const { return addr & ~(pageSize - 1); }
+
+    /** Frame holding a page, and page held by a frame */
+    Addr frameOf(Addr page) const;
+    Addr pageIn(Addr frame) const;
+
+    /** Remember that a page now lives in a frame */
+    void setFrame(Addr page, Addr frame);
+
+    /** Recent accesses to a page, halved every epoch */
+    uint32_t accessesTo(Addr page) const;
+
+    /** Is a page being migrated, and thus not accessible */
+    bool isMigrating(Addr page) const;
+
+    /** Account for a demand request sent to a page */
+    void recordAccess(Addr page);
+
+    /**
+     * Send the held requests of the pages no longer being migrated,
+     * and return false if the master port refused one of them.
+     */
+    bool releaseHeld();
+
+    /**
+     * Pick a cold frame of the fast tier, looking at a few frames
+     * from a clock hand and taking the least accessed one.
+     */
+    Addr findColdFrame();
+
+    /** Start the next queued migration, if any and allowed */
+    void startMigration();
+
+    /** Send as many copy requests as the limit on them allows */
+    void sendCopyReqs();
+
+    /** Handle the response to a copy request */
+    void recvCopyResp(PacketPtr pkt, unsigned block);
+
+    /** The pages are copied, remap them and release the requests */
+    void commitMigration();
+
+    /** Select the migrations and start a new epoch */
+    void processEpochEvent();
+
+    /** Retry the requests held off while blocked */
+    void retryBlocked();
+
+    /** Signal the end of a drain once nothing is left in flight */
+    void checkDrained();
+
+    /** The system, to know if we are in timing mode */
+    System* const system;
+
+    /** Master ID of the copy requests */
+    const MasterID masterId;
+
+    const AddrRange fastRange;
+    const AddrRange slowRange;
+    const Addr pageSize;
+
+    const Enums::TierPolicy policy;
+    const Tick epoch;
+    const uint32_t hotThreshold;
+    const uint32_t migrationsPerEpoch;
+
+    const unsigned blockSize;
+    const unsigned blocksPerPage;
+    const unsigned maxCopyReqs;
+    const Tick migrationLatency;
+
+    /**
+     * Pages living in another frame than their own, and the reverse
+     * mapping; pages that were never moved are not in the maps.
+     */
+    std::unordered_map<Addr, Addr> pageToFrame;
+    std::unordered_map<Addr, Addr> frameToPage;
+
+    /** Recent accesses per page, halved every epoch */
+    std::unordered_map<Addr, uint32_t> pageAccesses;
+
+    /** Hot pages waiting to be migrated */
+    std::deque<Addr> hotPages;
+
+    /** Migrations started in the current epoch */
+    uint32_t migrationsThisEpoch;
+
+    /** Clock hand walking the fast frames for cold victims */
+    Addr coldHand;
+
+    /** The migration in progress, if any */
+    Migration *migration;
+
+    /**
+     * Requests to the pages being migrated, queued per page until the
+     * migration is done, and until all of them are sent so that the
+     * later requests to the page stay behind them.
+     */
+    std::unordered_map<Addr, std::deque<PacketPtr>> heldReqs;
+
+    /** A copy request refused by the master port */
+    PacketPtr blockedCopy;
+
+    /** A request was refused and waits for a retry */
+    bool retryPending;
+
+    EventWrapper<TieredMemory, &TieredMemory::commitMigration>
+    commitEvent;
+
+    EventWrapper<TieredMemory, &TieredMemory::processEpochEvent>
+    epochEvent;
+
+    Stats::Scalar fastAccesses;
+    Stats::Scalar slowAccesses;
+    Stats::Formula fastHitRate;
+    Stats::Scalar migrations;
+    Stats::Scalar migrationBytes;
+    Stats::Scalar migrationStalls;
+    Stats::Scalar totMigrationLat;
+    Stats::Formula avgMigrationLat;
+
+};
+
+#endif //__MEM_TIERED_MEMORY_HH__
@@ -49,6 +49,8 @@
 
 #include "mem/xbar.hh"
 
+#include <algorithm>
+
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -60,11 +62,12 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       frontendLatency(p->frontend_latency),
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
-      width(p->width),
+      width(p->width), useDecodedMap(false),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
-      useDefaultRange(p->use_default_range)
+      useDefaultRange(p->use_default_range),
+      lazyRelease(p->lazy_release)
 {}
 
 BaseXBar::~BaseXBar()
@@ -74,6 +77,9 @@ BaseXBar::~BaseXBar()
 
     for (auto s: slavePorts)
         delete s;
+
+    for (auto r: freeRoutes)
+        delete r;
 }
 
 void
@@ -147,7 +153,7 @@ template <typename SrcType, typename DstType>
 BaseXBar::Layer<SrcType,DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
     port(_port), xbar(_xbar), _name(_name), state(IDLE),
-    waitingForPeer(NULL), releaseEvent(this)
+    waitingForPeer(NULL), busyUntil(0), releaseEvent(this)
 {
 }
 
@@ -162,7 +168,14 @@ void BaseXBar::Layer<SrcType,DstType>::occupyLayer(Tick until)
 
     // until should never be 0 as express snoops never occupy the layer
     assert(until != 0);
-    xbar.schedule(releaseEvent, until);
+    busyUntil = until;
+
+    // only schedule the release if a port is waiting for it, or we
+    // are draining, and otherwise let the next packet release the
+    // layer
+    if (!xbar.lazyRelease || !waitingForLayer.empty() ||
+        drainState() == DrainState::Draining)
+        scheduleRelease();
 
     // account for the occupied ticks
     occupancy += until - curTick();
@@ -181,6 +194,10 @@ BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
     // this state again in zero time if the peer does not immediately
     // call the layer when receiving the retry
 
+    // the layer might still be marked busy even if its occupancy is
+    // over
+    releaseIfDone();
+
     // first we see if the layer is busy, next we check if the
     // destination port is already engaged in a transaction waiting
     // for a retry from the peer
@@ -194,11 +211,20 @@ BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
         // that transaction to go through, and then the layer to free
         // up)
         waitingForLayer.push_back(src_port);
+
+        // make sure the port gets a retry once the layer is released
+        if (state == BUSY)
+            scheduleRelease();
+
         return false;
     }
 
     state = BUSY;
 
+    // the layer is occupied until we know for how long, to prevent
+    // any follow-on calls from releasing it
+    busyUntil = MaxTick;
+
     return true;
 }
 
@@ -260,6 +286,29 @@ BaseXBar::Layer<SrcType,DstType>::releaseLayer()
     }
 }
 
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType,DstType>::releaseIfDone()
+{
+    if (state == BUSY && busyUntil <= curTick() &&
+        !releaseEvent.scheduled()) {
+        assert(waitingForLayer.empty() || waitingForPeer != NULL);
+        state = IDLE;
+    }
+}
+
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType,DstType>::scheduleRelease()
+{
+    assert(state == BUSY);
+
+    // if we are still forwarding the packet, the release is scheduled
+    // once the layer is occupied
+    if (busyUntil != MaxTick && !releaseEvent.scheduled())
+        xbar.schedule(releaseEvent, std::max(busyUntil, curTick()));
+}
+
 template <typename SrcType, typename DstType>
 void
 BaseXBar::Layer<SrcType,DstType>::retryWaiting()
@@ -303,6 +352,11 @@ BaseXBar::Layer<SrcType,DstType>::recvRetry()
     // something to this port
     assert(waitingForPeer != NULL);
 
+    // the layer might still be marked busy even if its occupancy is
+    // over, and this has to be settled while the port is still
+    // waiting for the peer
+    releaseIfDone();
+
     // add the port where the failed packet originated to the front of
     // the waiting ports for the layer, this allows us to call retry
     // on the port immediately if the crossbar layer is idle
@@ -317,6 +371,7 @@ BaseXBar::Layer<SrcType,DstType>::recvRetry()
         retryWaiting();
     } else {
         assert(state == BUSY);
+        scheduleRelease();
     }
 }
 
@@ -332,12 +387,24 @@ BaseXBar::findPort(Addr addr)
     if (dest_id != InvalidPortID)
         return dest_id;
 
-    // Check the address map interval tree
-    auto i = portMap.find(addr);
-    if (i != portMap.end()) {
-        dest_id = i->second;
-        updatePortCache(dest_id, i->first);
-        return dest_id;
+    if (useDecodedMap) {
+        // Find the last range starting at or below the address
+        auto d = std::upper_bound(decodedMap.begin(), decodedMap.end(), addr,
+                                  [](Addr a,
+                                     const std::pair<AddrRange, PortID>& r)
+                                  { return a < r.first.start(); });
+        if (d != decodedMap.begin() && (--d)->first.contains(addr)) {
+            updatePortCache(d->second, d->first);
+            return d->second;
+        }
+    } else {
+        // Check the address map interval tree
+        auto i = portMap.find(addr);
+        if (i != portMap.end()) {
+            dest_id = i->second;
+            updatePortCache(dest_id, i->first);
+            return dest_id;
+        }
     }
 
     // Check if this matches the default range
@@ -518,9 +585,28 @@ BaseXBar::recvRangeChange(PortID master_port_id)
             s->sendRangeChange();
     }
 
+    decodePortMap();
     clearPortCache();
 }
 
+void
+BaseXBar::decodePortMap()
+{
+    decodedMap.clear();
+    useDecodedMap = true;
+
+    // the map iterates over the ranges in the order of their start
+    // address, and does not hold any overlapping ranges
+    for (const auto& r: portMap) {
+        if (r.first.interleaved()) {
+            decodedMap.clear();
+            useDecodedMap = false;
+            return;
+        }
+        decodedMap.emplace_back(r.first, r.second);
+    }
+}
+
 AddrRangeList
 BaseXBar::getAddrRanges() const
 {
@@ -594,8 +680,11 @@ BaseXBar::Layer<SrcType,DstType>::drain()
     //We should check that we're not "doing" anything, and that noone is
     //waiting. We might be idle but have someone waiting if the device we
     //contacted for a retry didn't actually retry.
+    releaseIfDone();
     if (state != IDLE) {
         DPRINTF(Drain, "Crossbar not drained\n");
+        // make sure we signal the drain once released
+        scheduleRelease();
         return DrainState::Draining;
     } else {
         return DrainState::Drained;
@@ -52,9 +52,10 @@
 #define __MEM_XBAR_HH__
 
 #include <deque>
-#include <unordered_map>
+#include <vector>
 
 #include "base/addr_range_map.hh"
+#include "base/cast.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "mem/qport.hh"
@@ -229,6 +230,17 @@ class BaseXBar : public MemObject
          */
         SrcType* waitingForPeer;
 
+        /**
+         * The tick until which the layer is occupied. Unless the
+         * crossbar is told otherwise, the release event is only
+         * scheduled when a port is waiting for the layer, or when
+         * draining, and the layer is otherwise
+         * released lazily by the next packet that finds its
+         * occupancy over, so an uncontended layer does not need an
+         * event per packet.
+         */
+        Tick busyUntil;
+
         /**
          * Release the layer after being occupied and return to an
          * idle state where we proceed to send a retry to any
@@ -236,6 +248,16 @@ class BaseXBar : public MemObject
          */
         void releaseLayer();
 
+        /**
+         * Release the layer on the spot if its occupancy is over and
+         * no release event is pending, which implies that no port is
+         * waiting for it.
+         */
+        void releaseIfDone();
+
+        /** Schedule the release event once the occupancy is known */
+        void scheduleRelease();
+
         /** event used to schedule a release of the layer */
         EventWrapper<Layer, &Layer::releaseLayer> releaseEvent;
 
@@ -322,12 +344,80 @@ class BaseXBar : public MemObject
     AddrRangeMap<PortID> portMap;
 
     /**
-     * Remember where request packets came from so that we can route
-     * responses to the appropriate port. This relies on the fact that
-     * the underlying Request pointer inside the Packet stays
-     * constant.
+     * The port map decoded into a vector sorted on the start address,
+     * searched by findPort with a binary search. As an interleaved
+     * range does not own all the addresses it spans, the vector is
+     * only used when none of the ranges are interleaved.
+     */
+    std::vector<std::pair<AddrRange, PortID>> decodedMap;
+    bool useDecodedMap;
+
+    /** Rebuild the decoded port map after a range change */
+    void decodePortMap();
+
+    /**
+     * Sender state pushed on the requests we forward and expect a
+     * response to, remembering the port the response goes back
+     * through, so that the response is routed without a lookup.
+     */
+    class RouteState : public Packet::SenderState
+    {
+
+      public:
+
+        /** Port the response is routed to */
+        PortID port;
+
+        /**
+         * For the coherent crossbar, whether this is the route of the
+         * response to a snoop we forwarded, rather than to a request
+         */
+        bool snoop;
+
+    };
+
+    /**
+     * Route states not in use, recycled to avoid an allocation per
+     * packet.
+     */
+    std::vector<RouteState*> freeRoutes;
+
+    /**
+     * Remember where a request came from by pushing a route state on
+     * the packet. The state is taken back when routing the response.
+     *
+     * @param pkt Request to be forwarded
+     * @param port_id Port the response is routed to
+     * @param snoop Set if the packet is a snoop request
+     */
+    void pushRoute(PacketPtr pkt, PortID port_id, bool snoop = false)
+    {
+        RouteState* route;
+        if (freeRoutes.empty()) {
+            route = new RouteState;
+        } else {
+            route = freeRoutes.back();
+            freeRoutes.pop_back();
+        }
+        route->port = port_id;
+        route->snoop = snoop;
+        pkt->pushSenderState(route);
+    }
+
+    /** The route state on top of a packet, pushed by pushRoute */
+    const RouteState& getRoute(PacketPtr pkt) const
+    {
+        return *safe_cast<RouteState*>(pkt->senderState);
+    }
+
+    /**
+     * Pop the route state of a packet once the packet has been
+     * routed, or is not going to be.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    void popRoute(PacketPtr pkt)
+    {
+        freeRoutes.push_back(safe_cast<RouteState*>(pkt->popSenderState()));
+    }
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
@@ -437,6 +527,12 @@ class BaseXBar : public MemObject
        addresses not handled by another port to default device. */
     const bool useDefaultRange;
 
+    /**
+     * Release the layers lazily, and only schedule a release event
+     * when a port is waiting, rather than after every packet.
+     */
+    bool lazyRelease;
+
     BaseXBar(const BaseXBarParams *p);
 
     /**
@@ -466,6 +562,12 @@ class BaseXBar : public MemObject
 
     virtual void regStats();
 
+    /**
+     * Choose between lazy and event-driven release of the layers,
+     * which has to be done before the simulation starts.
+     */
+    void setLazyRelease(bool lazy) { lazyRelease = lazy; }
+
 };
 
 #endif //__MEM_XBAR_HH__
@@ -731,6 +731,7 @@ class AddrRange(ParamValue):
         self.xorHighBit = 0
         self.intlvBits = 0
         self.intlvMatch = 0
+        self.masks = []
 
         def handle_kwargs(self, kwargs):
             # An address range needs to have an upper limit, specified
@@ -752,6 +753,14 @@ class AddrRange(ParamValue):
                 self.intlvBits = int(kwargs.pop('intlvBits'))
             if 'intlvMatch' in kwargs:
                 self.intlvMatch = int(kwargs.pop('intlvMatch'))
+            # every interleaving bit may instead be the parity of the
+            # address bits set in a mask, from the least significant
+            # bit up
+            if 'masks' in kwargs:
+                if self.intlvHighBit or self.xorHighBit or self.intlvBits:
+                    raise TypeError, "Masks replace the interleaving bits"
+                self.masks = [ long(Addr(m)) for m in kwargs.pop('masks') ]
+                self.intlvBits = len(self.masks)
 
         if len(args) == 0:
             self.start = Addr(kwargs.pop('start'))
@@ -780,7 +789,8 @@ class AddrRange(ParamValue):
     def __str__(self):
         return '%s:%s:%s:%s:%s:%s' \
             % (self.start, self.end, self.intlvHighBit, self.xorHighBit,\
-               self.intlvBits, self.intlvMatch)
+               self.intlvBits, self.intlvMatch) + \
+            ''.join(':%s' % m for m in self.masks)
 
     def size(self):
         # Divide the size by the size of the interleaving slice
@@ -798,6 +808,7 @@ class AddrRange(ParamValue):
     @classmethod
     def cxx_ini_predecls(cls, code):
         code('#include <sstream>')
+        code('#include <vector>')
 
     @classmethod
     def cxx_ini_parse(cls, code, src, dest, ret):
@@ -818,9 +829,18 @@ class AddrRange(ParamValue):
         code('    _stream.get(_sep);')
         code('    _stream >> _intlvMatch;')
         code('}')
+        code('std::vector<Addr> _masks;')
+        code('while (!_stream.fail() && !_stream.eof()) {')
+        code('    Addr _mask;')
+        code('    _stream.get(_sep);')
+        code('    _stream >> _mask;')
+        code('    _masks.push_back(_mask);')
+        code('}')
         code('bool _ret = !_stream.fail() &&'
             '_stream.eof() && _sep == \':\';')
-        code('if (_ret)')
+        code('if (_ret && !_masks.empty())')
+        code('   ${dest} = AddrRange(_start, _end, _masks, _intlvMatch);')
+        code('else if (_ret)')
         code('   ${dest} = AddrRange(_start, _end, _intlvHighBit, \
                 _xorHighBit, _intlvBits, _intlvMatch);')
         code('${ret} _ret;')
@@ -830,6 +850,10 @@ class AddrRange(ParamValue):
         # by swig
         from _m5.range import AddrRange
 
+        if self.masks:
+            return AddrRange(long(self.start), long(self.end), self.masks,
+                             int(self.intlvMatch))
+
         return AddrRange(long(self.start), long(self.end),
                          int(self.intlvHighBit), int(self.xorHighBit),
                          int(self.intlvBits), int(self.intlvMatch))
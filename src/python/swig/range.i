@@ -36,7 +36,12 @@
 %}
 
 %include <stdint.i>
+%include <std_vector.i>
 
 %rename(assign) *::operator=;
 %include "base/types.hh"
+
+// the masks of an interleaved range are passed as a list
+%template(vector_Addr) std::vector<Addr>;
+
 %include "base/addr_range.hh"
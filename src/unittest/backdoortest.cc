@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * Checks that a memory invalidates its backdoor when the backing
+ * store is replaced, and when a load-locked starts to be tracked, and
+ * that the requestors holding the backdoor forget it.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "mem/abstract_mem.hh"
+#include "mem/backdoor.hh"
+#include "sim/clock_domain.hh"
+#include "sim/voltage_domain.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+namespace {
+
+const Addr memSize = 0x1000;
+
+/** A memory without ports, as only the backdoor is looked at */
+class TestMemory : public AbstractMemory
+{
+  public:
+
+    TestMemory(const Params* p) : AbstractMemory(p) { }
+
+    /** Track a load-locked as an access by a locked read would */
+    void
+    loadLocked(Addr addr, ContextID cid)
+    {
+        Request req(addr, 4, Request::LLSC, 0, 0, cid);
+        Packet pkt(&req, MemCmd::LoadLockedReq);
+        trackLoadLocked(&pkt);
+    }
+};
+
+/** Read a word through the backdoors held by a requestor */
+bool
+readThrough(const MemBackdoorSet& backdoors, Addr addr, uint32_t& data)
+{
+    Request req(addr, sizeof(data), 0, 0);
+    Packet pkt(&req, MemCmd::ReadReq);
+    pkt.dataStatic(&data);
+    return backdoors.access(&pkt);
+}
+
+/** Get the backdoor of a memory, if it grants one */
+MemBackdoorPtr
+getBackdoor(TestMemory& memory)
+{
+    MemBackdoorPtr backdoor = NULL;
+    memory.getBackdoor(backdoor);
+    return backdoor;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    VoltageDomainParams voltage_p;
+    voltage_p.name = "voltage_domain";
+    voltage_p.eventq_index = 0;
+    voltage_p.voltage.push_back(1.0);
+    VoltageDomain voltage_domain(&voltage_p);
+
+    SrcClockDomainParams clock_p;
+    clock_p.name = "clk_domain";
+    clock_p.eventq_index = 0;
+    clock_p.clock.push_back(1000);
+    clock_p.voltage_domain = &voltage_domain;
+    clock_p.domain_id = -1;
+    clock_p.init_perf_level = 0;
+    SrcClockDomain clk_domain(&clock_p);
+
+    AbstractMemoryParams memory_p;
+    memory_p.name = "memory";
+    memory_p.eventq_index = 0;
+    memory_p.clk_domain = &clk_domain;
+    memory_p.power_model = NULL;
+    memory_p.default_p_state = Enums::PwrState::UNDEFINED;
+    memory_p.p_state_clk_gate_min = 1000;
+    memory_p.p_state_clk_gate_max = 1000000000000;
+    memory_p.p_state_clk_gate_bins = 20;
+    memory_p.range = AddrRange(0, memSize - 1);
+    memory_p.null = false;
+    memory_p.in_addr_map = true;
+    memory_p.kvm_map = true;
+    memory_p.conf_table_reported = false;
+    TestMemory memory(&memory_p);
+
+    std::vector<uint8_t> store(memSize, 0);
+    std::vector<uint8_t> new_store(memSize, 0);
+    const uint32_t value = 0x12345678;
+    std::memcpy(&new_store[0x40], &value, sizeof(value));
+
+    setCase("No backdoor without a backing store");
+    {
+        EXPECT_EQ(getBackdoor(memory), NULL);
+    }
+
+    setCase("Replacing the backing store");
+    {
+        memory.setBackingStore(store.data());
+        MemBackdoorPtr backdoor = getBackdoor(memory);
+        EXPECT_TRUE(backdoor != NULL);
+
+        MemBackdoorSet backdoors;
+        backdoors.add(backdoor);
+        uint32_t data = 1;
+        EXPECT_TRUE(readThrough(backdoors, 0x40, data));
+        EXPECT_EQ(data, 0);
+
+        // the requestor has to ask again, and is given the new store
+        memory.setBackingStore(new_store.data());
+        EXPECT_TRUE(!readThrough(backdoors, 0x40, data));
+        backdoor = getBackdoor(memory);
+        EXPECT_TRUE(backdoor != NULL);
+        backdoors.add(backdoor);
+        EXPECT_TRUE(readThrough(backdoors, 0x40, data));
+        EXPECT_EQ(data, value);
+    }
+
+    setCase("Requestors destroyed before the memory");
+    {
+        // the sets are gone, so invalidating must not call them
+        {
+            MemBackdoorSet backdoors;
+            backdoors.add(getBackdoor(memory));
+        }
+        memory.setBackingStore(store.data());
+
+        MemBackdoorSet backdoors;
+        backdoors.add(getBackdoor(memory));
+        uint32_t data = 1;
+        EXPECT_TRUE(readThrough(backdoors, 0x40, data));
+        EXPECT_EQ(data, 0);
+    }
+
+    setCase("Load-locked");
+    {
+        MemBackdoorSet backdoors;
+        backdoors.add(getBackdoor(memory));
+
+        // the accesses through the backdoor would not clear the lock,
+        // so it is taken away, and not granted again while locked
+        memory.loadLocked(0x80, 0);
+        uint32_t data = 1;
+        EXPECT_TRUE(!readThrough(backdoors, 0x40, data));
+        EXPECT_EQ(getBackdoor(memory), NULL);
+        EXPECT_EQ(memory.getLockedAddrList().size(), 1);
+
+        // a new lock by the same context only moves the record
+        memory.loadLocked(0xc0, 0);
+        EXPECT_EQ(memory.getLockedAddrList().size(), 1);
+        EXPECT_EQ(getBackdoor(memory), NULL);
+    }
+
+    return UnitTest::printResults();
+}
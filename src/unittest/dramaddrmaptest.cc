@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * Decodes known addresses with the XOR masks of the custom DRAM
+ * address mapping, picks their channel with an address range
+ * interleaved by the same masks, and checks the checks of the masks.
+ */
+
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "mem/dram_addr_map.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+namespace {
+
+/** The masks of the fields, from the least significant bit up */
+const std::vector<Addr> channelMasks = { 0x2040 };
+const std::vector<Addr> rankMasks = { 0x10000 };
+const std::vector<Addr> bankGroupMasks = { 0x20080, 0x40100 };
+const std::vector<Addr> bankMasks = { 0x84000, 0x108000 };
+const std::vector<Addr> rowMasks = { 0x20000, 0x40000, 0x80000, 0x100000 };
+
+struct Location
+{
+    Addr addr;
+    unsigned channel;
+    unsigned rank;
+    unsigned bankGroup;
+    unsigned bank;
+    unsigned row;
+};
+
+/**
+ * Addresses whose channel is bit 6 XOR bit 13, rank bit 16, bank group
+ * bits 7 and 8 XOR bits 17 and 18, bank bits 14 and 15 XOR bits 19 and
+ * 20, and row bits 17 to 20
+ */
+const Location locations[] = {
+    { 0x0,      0, 0, 0, 0, 0 },
+    { 0x40,     1, 0, 0, 0, 0 },
+    { 0x2040,   0, 0, 0, 0, 0 },
+    { 0x2000,   1, 0, 0, 0, 0 },
+    { 0x180,    0, 0, 3, 0, 0 },
+    { 0x20000,  0, 0, 1, 0, 1 },
+    { 0x20080,  0, 0, 0, 0, 1 },
+    { 0x60180,  0, 0, 0, 0, 3 },
+    { 0x1c000,  0, 1, 0, 3, 0 },
+    { 0x18c000, 0, 0, 0, 0, 12 },
+    { 0x184000, 0, 0, 0, 2, 12 },
+    { 0x1fffc0, 0, 1, 0, 0, 15 },
+};
+
+} // anonymous namespace
+
+int
+main()
+{
+    DRAMAddrMap addr_map(channelMasks, rankMasks, bankGroupMasks,
+                         bankMasks, rowMasks);
+
+    setCase("Decoding known addresses");
+    {
+        for (const auto& l : locations) {
+            EXPECT_EQ(DRAMAddrMap::hash(l.addr, addr_map.channelMasks),
+                      l.channel);
+            EXPECT_EQ(addr_map.rank(l.addr), l.rank);
+            EXPECT_EQ(addr_map.bankGroup(l.addr), l.bankGroup);
+            EXPECT_EQ(addr_map.bank(l.addr), l.bank);
+            EXPECT_EQ(addr_map.row(l.addr), l.row);
+        }
+    }
+
+    setCase("Spreading the lines over the bank groups and banks");
+    {
+        // every line of the 2MB the masks cover goes to one of the 16
+        // banks, and the hashing leaves them equally used
+        std::vector<unsigned> lines(16, 0);
+        for (Addr addr = 0; addr < 0x200000; addr += 64)
+            ++lines[addr_map.bank(addr) * 4 + addr_map.bankGroup(addr)];
+        for (auto n : lines)
+            EXPECT_EQ(n, 0x200000 / 64 / 16);
+    }
+
+    setCase("Picking the channel with interleaved address ranges");
+    {
+        std::vector<AddrRange> channels;
+        for (uint8_t i = 0; i < 2; ++i)
+            channels.push_back(AddrRange(0, 0x1fffff, channelMasks, i));
+
+        for (const auto& l : locations) {
+            EXPECT_TRUE(channels[l.channel].contains(l.addr));
+            EXPECT_TRUE(!channels[1 - l.channel].contains(l.addr));
+        }
+
+        // a line never crosses a channel
+        EXPECT_EQ(channels[0].granularity(), 64);
+        EXPECT_EQ(channels[0].stripes(), 2);
+        EXPECT_TRUE(channels[0].hashed());
+        EXPECT_TRUE(channels[0].mergesWith(channels[1]));
+        EXPECT_TRUE(!channels[0].intersects(channels[1]));
+
+        AddrRange merged(channels);
+        EXPECT_TRUE(!merged.interleaved());
+        EXPECT_TRUE(merged.contains(0x40) && merged.contains(0x2040));
+    }
+
+    setCase("Checking the number of masks");
+    {
+        EXPECT_TRUE(DRAMAddrMap::fits(rankMasks, 2));
+        EXPECT_TRUE(DRAMAddrMap::fits(rowMasks, 16));
+        EXPECT_TRUE(DRAMAddrMap::fits(std::vector<Addr>(), 1));
+        EXPECT_TRUE(!DRAMAddrMap::fits(rankMasks, 4));
+        EXPECT_TRUE(!DRAMAddrMap::fits(bankGroupMasks, 2));
+        EXPECT_TRUE(!DRAMAddrMap::fits(bankGroupMasks, 3));
+        EXPECT_TRUE(!DRAMAddrMap::fits(std::vector<Addr>(1, 0), 2));
+    }
+
+    return UnitTest::printResults();
+}
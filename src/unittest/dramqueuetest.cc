@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026 agent
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: agent
+ */
+
+/**
+ * @file
+ * Checks DRAMPacketQueue against the std::deque the DRAM controller
+ * used before, with the packets moved to the front as the schedulers
+ * do, and the bank and row queries answered by walking the deque.
+ */
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <random>
+
+#include "mem/dram_packet_queue.hh"
+#include "unittest/unittest.hh"
+
+using UnitTest::setCase;
+
+namespace {
+
+const unsigned numBanks = 8;
+const unsigned numRows = 4;
+
+struct TestPacket
+{
+    TestPacket(uint16_t bank_id, uint32_t _row)
+        : bankId(bank_id), row(_row), queueSeq(0)
+    { }
+
+    uint16_t bankId;
+    uint32_t row;
+    int64_t queueSeq;
+    std::list<TestPacket*>::iterator queuePos;
+};
+
+typedef DRAMPacketQueue<TestPacket> TestQueue;
+typedef std::deque<TestPacket*> RefQueue;
+
+void
+moveToFront(TestQueue& queue, RefQueue& ref, TestPacket* pkt)
+{
+    queue.moveToFront(pkt);
+    ref.erase(std::find(ref.begin(), ref.end(), pkt));
+    ref.push_front(pkt);
+}
+
+void
+popFront(TestQueue& queue, RefQueue& ref)
+{
+    queue.pop_front();
+    ref.pop_front();
+}
+
+/** Compare the order of the queue and every bank and row query */
+bool
+matches(const TestQueue& queue, const RefQueue& ref)
+{
+    if (queue.size() != ref.size() ||
+        !std::equal(queue.begin(), queue.end(), ref.begin()))
+        return false;
+
+    for (uint16_t b = 0; b < numBanks; ++b) {
+        auto in_bank = [b](const TestPacket* p) { return p->bankId == b; };
+        if (queue.bankEntries(b) != std::count_if(ref.begin(), ref.end(),
+                                                  in_bank))
+            return false;
+
+        // one more row than is ever queued, to check the empty rows
+        for (uint32_t r = 0; r <= numRows; ++r) {
+            auto hit = [b, r](const TestPacket* p)
+                { return p->bankId == b && p->row == r; };
+            auto miss = [b, r](const TestPacket* p)
+                { return p->bankId == b && p->row != r; };
+
+            auto oldest_hit = std::find_if(ref.begin(), ref.end(), hit);
+            auto oldest_miss = std::find_if(ref.begin(), ref.end(), miss);
+            if (queue.rowEntries(b, r) != std::count_if(ref.begin(),
+                                                        ref.end(), hit) ||
+                queue.oldestInRow(b, r) !=
+                (oldest_hit == ref.end() ? NULL : *oldest_hit) ||
+                queue.oldestNotInRow(b, r) !=
+                (oldest_miss == ref.end() ? NULL : *oldest_miss))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    // the packets are only referenced by the queues, and a deque does
+    // not move them when growing
+    std::deque<TestPacket> packets;
+    auto new_packet = [&packets](uint16_t bank_id, uint32_t row)
+    {
+        packets.emplace_back(bank_id, row);
+        return &packets.back();
+    };
+
+    setCase("Arrival order");
+    {
+        TestQueue queue(numBanks);
+        RefQueue ref;
+        for (uint32_t r = 0; r < numRows; ++r) {
+            for (uint16_t b = 0; b < numBanks; ++b) {
+                TestPacket* pkt = new_packet(b, r);
+                queue.push_back(pkt);
+                ref.push_back(pkt);
+            }
+        }
+        EXPECT_TRUE(matches(queue, ref));
+
+        while (!ref.empty()) {
+            EXPECT_EQ(queue.front(), ref.front());
+            popFront(queue, ref);
+            EXPECT_TRUE(matches(queue, ref));
+        }
+        EXPECT_TRUE(queue.empty());
+    }
+
+    setCase("Moving packets that are not the oldest of their row");
+    {
+        TestQueue queue(numBanks);
+        RefQueue ref;
+        for (int i = 0; i < 4; ++i) {
+            TestPacket* pkt = new_packet(1, 2);
+            queue.push_back(pkt);
+            ref.push_back(pkt);
+        }
+
+        // the youngest, then one in the middle, without issuing them
+        moveToFront(queue, ref, ref.back());
+        EXPECT_TRUE(matches(queue, ref));
+        moveToFront(queue, ref, ref[2]);
+        EXPECT_TRUE(matches(queue, ref));
+        EXPECT_EQ(queue.oldestInRow(1, 2), ref.front());
+
+        while (!ref.empty()) {
+            popFront(queue, ref);
+            EXPECT_TRUE(matches(queue, ref));
+        }
+    }
+
+    setCase("Random pushes, scheduler choices and pops");
+    {
+        std::mt19937 rng(1);
+        auto random = [&rng](unsigned n)
+            { return std::uniform_int_distribution<unsigned>(0, n - 1)(rng); };
+
+        TestQueue queue(numBanks);
+        RefQueue ref;
+        unsigned mismatches = 0;
+        for (int i = 0; i < 200000; ++i) {
+            unsigned op = random(8);
+            if (ref.empty() || (op < 4 && ref.size() < 64)) {
+                TestPacket* pkt = new_packet(random(numBanks),
+                                             random(numRows));
+                queue.push_back(pkt);
+                ref.push_back(pkt);
+            } else if (op < 7) {
+                // FR-FCFS takes the oldest packet of a row, or of a
+                // bank missing a row, the other schedulers any packet
+                uint16_t b = random(numBanks);
+                uint32_t r = random(numRows);
+                TestPacket* pkt = op == 4 ? queue.oldestInRow(b, r) :
+                    op == 5 ? queue.oldestNotInRow(b, r) :
+                    ref[random(ref.size())];
+                if (pkt != NULL) {
+                    moveToFront(queue, ref, pkt);
+                    // the controller issues the packet straight away,
+                    // but the queue should not depend on it
+                    if (random(4))
+                        popFront(queue, ref);
+                }
+            } else {
+                popFront(queue, ref);
+            }
+
+            if (!matches(queue, ref))
+                ++mismatches;
+        }
+        EXPECT_EQ(mismatches, 0);
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,75 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.util import fatal
+import os, sys
+
+from ruby_network_tester import create_root
+
+# Garnet mesh evaluated with parallel_routers. The simulation is forked
+# before it starts, the child evaluates the routers with 4 host threads
+# and the parent with 1, and the statistics of both, but for the host
+# ones, have to be the same.
+root = create_root(network = 'garnet2.0', topology = 'Mesh_XY',
+                   num_cpus = 4, mesh_rows = 2, garnet_parallel = True)
+
+def read_stats(outdir):
+    stats = open(os.path.join(outdir, 'stats.txt')).readlines()
+    return [l for l in stats if 'host_' not in l.split(' ', 1)[0]]
+
+def run_test(root):
+    m5.instantiate()
+
+    parent_outdir = m5.options.outdir
+    child_outdir = os.path.join(parent_outdir, 'threads4')
+    pid = m5.fork(child_outdir)
+    if pid == 0:
+        root.system.ruby.network.setRouterThreads(4)
+
+    exit_event = m5.simulate(maxtick)
+    m5.stats.dump()
+
+    if pid == 0:
+        sys.exit(0)
+
+    print 'Exiting @ tick', m5.curTick(), 'because', exit_event.getCause()
+
+    (_, status) = os.waitpid(pid, 0)
+    if status != 0:
+        fatal("The simulation with 4 router threads failed")
+
+    stats_one = read_stats(parent_outdir)
+    stats_four = read_stats(child_outdir)
+    if len(stats_one) != len(stats_four):
+        fatal("The statistics with 1 and 4 router threads do not "
+              "have the same length")
+    for (one, four) in zip(stats_one, stats_four):
+        if one != four:
+            fatal("Statistics differ between 1 and 4 router "
+                  "threads:\n%s%s", one, four)
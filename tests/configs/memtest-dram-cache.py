@@ -0,0 +1,80 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../configs/')
+from common.Caches import *
+
+# MemTest checks every value it reads, here from a DRAM cache that is
+# small enough for the testers to miss and evict dirty lines, and that
+# sits behind a crossbar that is not the point of coherency, so that
+# the clean evictions and write-backs of the L1s reach it. Half of the
+# L1s write back their clean lines, and half only tell of them.
+nb_cores = 8
+cpus = [ MemTest() for i in xrange(nb_cores) ]
+
+system = System(cpu = cpus,
+                physmem = SimpleMemory(),
+                membus = SystemXBar(point_of_coherency = False))
+# Dummy voltage domain for all our clock domains
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+# Create a seperate clock domain for components that should run at
+# CPUs frequency
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+# the stacked DRAM sits outside the address map, and holds 113 sets of
+# two ways
+cache_range = AddrRange(0x10000000, size = '16kB')
+system.dram_cache = DRAMCache(cache_range = cache_range, assoc = 2)
+system.cache_mem = SimpleMemory(range = cache_range, in_addr_map = False)
+
+system.membus.master = system.dram_cache.slave
+system.dram_cache.cache_port = system.cache_mem.port
+system.dram_cache.far_port = system.physmem.port
+
+for i, cpu in enumerate(cpus):
+    # All cpus are associated with cpu_clk_domain
+    cpu.clk_domain = system.cpu_clk_domain
+    cpu.l1c = L1Cache(size = '4kB', assoc = 4,
+                      writeback_clean = (i % 2 == 1))
+    cpu.l1c.cpu_side = cpu.port
+    cpu.l1c.mem_side = system.membus.slave
+
+system.system_port = system.membus.slave
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
@@ -0,0 +1,99 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+import optparse
+
+addToPath('../configs/')
+
+from ruby import Ruby
+from common import Options
+
+def create_root(**network_options):
+    """Build the Ruby random tester on a network shaped by the given Ruby
+    and network options, which override the defaults of the command
+    line options, e.g. network='garnet2.0', topology='Mesh_XY'.
+    """
+
+    parser = optparse.OptionParser()
+    Options.addNoISAOptions(parser)
+    Ruby.define_options(parser)
+    (options, args) = parser.parse_args()
+
+    # small caches keep the network busy
+    options.l1d_size = "256B"
+    options.l1i_size = "256B"
+    options.l2_size = "512B"
+    options.l1d_assoc = 2
+    options.l1i_assoc = 2
+    options.l2_assoc = 2
+    options.ports = 32
+
+    for (name, value) in network_options.items():
+        setattr(options, name, value)
+
+    tester = RubyTester(checks_to_complete = 100, wakeup_frequency = 10,
+                        num_cpus = options.num_cpus)
+
+    system = System(cpu = tester)
+    system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
+    system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                       voltage_domain = system.voltage_domain)
+    system.mem_ranges = AddrRange('256MB')
+
+    Ruby.create_system(options, False, system)
+
+    system.ruby.clk_domain = SrcClockDomain(clock = '1GHz',
+                                            voltage_domain =
+                                            system.voltage_domain)
+
+    tester.num_cpus = len(system.ruby._cpu_ports)
+
+    # random delays on the messages make the tester more effective
+    system.ruby.randomization = True
+
+    for ruby_port in system.ruby._cpu_ports:
+        if ruby_port.support_data_reqs and ruby_port.support_inst_reqs:
+            tester.cpuInstDataPort = ruby_port.slave
+        elif ruby_port.support_data_reqs:
+            tester.cpuDataPort = ruby_port.slave
+        elif ruby_port.support_inst_reqs:
+            tester.cpuInstPort = ruby_port.slave
+
+        ruby_port.no_retry_on_stall = True
+        ruby_port.using_ruby_tester = True
+
+    root = Root(full_system = False, system = system)
+    root.system.mem_mode = 'timing'
+
+    # Not much point in this being higher than the L1 latency
+    m5.ticks.setGlobalFrequency('1ns')
+
+    return root
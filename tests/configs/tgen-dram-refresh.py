@@ -0,0 +1,127 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+import os
+
+# the traffic generator is only available if we have protobuf support,
+# so potentially skip this test
+require_sim_object("TrafficGen")
+
+# The same LPDDR5 configuration with all-bank, same-bank and per-bank
+# refresh, and with per-bank refresh plus refresh management, each
+# controller driven by its own generator with saturating random reads.
+# The partial refreshes have to happen, and have to get at least the
+# bandwidth of the all-bank refresh, and only the last controller
+# issues refresh management commands.
+runs = [('all_bank', 0), ('same_bank', 0), ('per_bank', 0), ('per_bank', 8)]
+
+# long enough for more than a hundred tREFI
+duration = 500000000
+
+ranges = [AddrRange(i * 0x10000000, size = '256MB')
+          for i in range(len(runs))]
+
+# one configuration file per generator, as they cover different
+# ranges, issuing a 64 byte read every tBURST
+cpu = []
+for (i, r) in enumerate(ranges):
+    cfg_file_name = os.path.join(m5.options.outdir,
+                                 "tgen-dram-refresh-%d.cfg" % i)
+    cfg_file = open(cfg_file_name, 'w')
+    cfg_file.write("STATE 0 %d RANDOM 100 %d %d 64 5000 5000 0\n" %
+                   (duration, r.start, r.end))
+    cfg_file.write("INIT 0\n")
+    cfg_file.write("TRANSITION 0 0 1\n")
+    cfg_file.close()
+    cpu.append(TrafficGen(config_file = cfg_file_name))
+
+# system simulated
+system = System(cpu = cpu, membus = IOXBar(width = 32),
+                mem_ranges = ranges,
+                clk_domain = SrcClockDomain(clock = '1GHz',
+                                            voltage_domain =
+                                            VoltageDomain()))
+
+system.physmem = [LPDDR5_6400_1x16_BG_BL32(range = r, refresh_mode = mode,
+                                           rfm_raaimt = rfm, null = True)
+                  for (r, (mode, rfm)) in zip(ranges, runs)]
+
+for (c, m) in zip(system.cpu, system.physmem):
+    c.port = system.membus.slave
+    m.port = system.membus.master
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+def run_test(root):
+    m5.instantiate()
+
+    exit_event = m5.simulate(duration)
+    m5.stats.dump()
+
+    print 'Exiting @ tick', m5.curTick(), 'because', exit_event.getCause()
+
+    stats = {}
+    for line in open(os.path.join(m5.options.outdir, 'stats.txt')):
+        if line.startswith('---------- End'):
+            break
+        fields = line.split()
+        if len(fields) > 1 and fields[0].startswith('system.physmem'):
+            stats[fields[0]] = float(fields[1])
+
+    def ctrl_stat(i, name):
+        return stats.get('system.physmem%d.%s' % (i, name), 0)
+
+    base_bw = ctrl_stat(0, 'avgRdBW')
+    if base_bw == 0:
+        fatal("The all-bank refresh controller did not read anything")
+
+    for (i, (mode, rfm)) in enumerate(runs):
+        bw = ctrl_stat(i, 'avgRdBW')
+        refs = ctrl_stat(i, 'bankSetRefreshes')
+        rfms = ctrl_stat(i, 'refreshMgmtCmds')
+        print '%s refresh, RAAIMT %d: %.2f MB/s, %d bank refreshes, ' \
+            '%d RFMs' % (mode, rfm, bw, refs, rfms)
+
+        if (mode == 'all_bank') != (refs == 0):
+            fatal("%s refresh did %d bank refreshes" % (mode, refs))
+        if (rfm == 0) != (rfms == 0):
+            fatal("RAAIMT %d gave %d RFMs" % (rfm, rfms))
+        if rfm == 0 and bw < base_bw:
+            fatal("%s refresh got %.2f MB/s, less than the %.2f MB/s of "
+                  "all-bank refresh" % (mode, bw, base_bw))
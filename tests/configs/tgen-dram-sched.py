@@ -0,0 +1,79 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.objects import *
+
+# traffic generators are only available if we have protobuf support,
+# so potentially skip this test
+require_sim_object("TrafficGen")
+
+# Two streaming and two light random requestors share four DRAM
+# channels, each channel using one of the application-aware scheduling
+# policies, so that every policy sees all the requestors at once
+policies = ['bliss', 'atlas', 'tcm', 'parbs']
+
+# even if these are only traffic generators, call them cpu to make
+# sure the scripts are happy
+cpu = [TrafficGen(config_file =
+                  srcpath("tests/quick/se/70.tgen/tgen-dram-sched-%s.cfg" %
+                          kind))
+       for kind in ['stream', 'stream', 'random', 'random']]
+
+# system simulated
+system = System(cpu = cpu, membus = IOXBar(width = 16),
+                clk_domain = SrcClockDomain(clock = '1GHz',
+                                            voltage_domain =
+                                            VoltageDomain()))
+
+# interleave the channels at the granularity of a burst, as
+# MemConfig does for the default address mapping
+system.physmem = [DDR3_1600_8x8(range = AddrRange(0, size = '128MB',
+                                                  intlvHighBit = 7,
+                                                  xorHighBit = 21,
+                                                  intlvBits = 2,
+                                                  intlvMatch = i),
+                                channels = len(policies),
+                                mem_sched_policy = policy)
+                  for i, policy in enumerate(policies)]
+
+for gen in system.cpu:
+    gen.port = system.membus.slave
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+for ctrl in system.physmem:
+    ctrl.port = system.membus.master
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
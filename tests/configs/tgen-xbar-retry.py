@@ -0,0 +1,116 @@
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+import os, sys
+
+# the traffic generator is only available if we have protobuf support,
+# so potentially skip this test
+require_sim_object("TrafficGen")
+
+# two traffic generators, one behind the coherent and one behind the
+# non-coherent crossbar, both issuing reads faster than the memory
+# controller behind them can accept them, so that the crossbars keep
+# seeing refused requests and peer retries
+cpu = [TrafficGen(config_file=srcpath(
+            "tests/quick/se/70.tgen/tgen-xbar-retry-%s.cfg" % xbar))
+       for xbar in ["coherent", "noncoherent"]]
+
+# system simulated
+system = System(cpu = cpu, membus = SystemXBar(),
+                mem_ranges = [AddrRange(0, size = '64MB'),
+                              AddrRange('64MB', size = '64MB')],
+                clk_domain = SrcClockDomain(clock = '1GHz',
+                                            voltage_domain =
+                                            VoltageDomain()))
+
+system.iobus = IOXBar()
+
+# a single-entry read queue keeps the controllers full and makes them
+# refuse most of the requests
+system.physmem = [DDR3_1600_8x8(range = r, read_buffer_size = 1)
+                  for r in system.mem_ranges]
+
+system.cpu[0].port = system.membus.slave
+system.cpu[1].port = system.iobus.slave
+
+# connect the system port even if it is not used in this example
+system.system_port = system.membus.slave
+
+system.physmem[0].port = system.membus.master
+system.physmem[1].port = system.iobus.master
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+# The simulation is forked before it starts, the child releases the
+# crossbar layers with an event after every packet, and the parent
+# lazily, and the crossbar statistics of both, including the layer
+# occupancy and utilisation, have to be the same.
+def read_xbar_stats(outdir):
+    stats = open(os.path.join(outdir, 'stats.txt')).readlines()
+    return [l for l in stats
+            if l.startswith('system.membus.') or l.startswith('system.iobus.')]
+
+def run_test(root):
+    m5.instantiate()
+
+    parent_outdir = m5.options.outdir
+    child_outdir = os.path.join(parent_outdir, 'eager')
+    pid = m5.fork(child_outdir)
+    if pid == 0:
+        root.system.membus.setLazyRelease(False)
+        root.system.iobus.setLazyRelease(False)
+
+    exit_event = m5.simulate(maxtick)
+    m5.stats.dump()
+
+    if pid == 0:
+        sys.exit(0)
+
+    print 'Exiting @ tick', m5.curTick(), 'because', exit_event.getCause()
+
+    (_, status) = os.waitpid(pid, 0)
+    if status != 0:
+        fatal("The simulation with eager layer release failed")
+
+    stats_lazy = read_xbar_stats(parent_outdir)
+    stats_eager = read_xbar_stats(child_outdir)
+    if not stats_lazy or len(stats_lazy) != len(stats_eager):
+        fatal("The crossbar statistics with lazy and eager layer "
+              "release do not have the same length")
+    for (lazy, eager) in zip(stats_lazy, stats_eager):
+        if lazy != eager:
+            fatal("Crossbar statistics differ between lazy and eager "
+                  "layer release:\n%s%s", lazy, eager)
@@ -151,11 +151,19 @@ generic_configs = (
     'o3-timing-mp',
 
     'rubytest',
+    'garnet-threads',
+    'generated-torus',
+    'generated-dragonfly',
+    'generated-torus-simple',
     'memcheck',
     'memtest',
     'memtest-filter',
+    'memtest-dram-cache',
     'tgen-simple-mem',
     'tgen-dram-ctrl',
+    'tgen-dram-sched',
+    'tgen-dram-refresh',
+    'tgen-xbar-retry',
 
     'learning-gem5-p1-simple',
     'learning-gem5-p1-two-level',
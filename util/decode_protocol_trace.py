@@ -0,0 +1,156 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+# This script dumps a binary SLICC transition trace, as written by
+# RubySystem when protocol_trace_file is set, to ASCII. It assumes that
+# protoc has been executed and already generated the Python package for
+# the trace messages. This can be done manually using:
+# protoc --python_out=. --proto_path=src/proto src/proto/protocol_trace.proto
+#
+# The ASCII format matches the output of the ProtocolTrace debug flag,
+# with one line per transition attempt: tick, version, machine, event,
+# state>next_state, address, and the result for stalled transitions.
+# Optional arguments restrict the output to a machine type and to a
+# block address.
+
+import protolib
+import sys
+
+from optparse import OptionParser
+
+# Import the trace proto definitions. If they are not found, attempt
+# to generate them automatically. This assumes that the script is
+# executed from the gem5 root.
+try:
+    import protocol_trace_pb2
+except:
+    print "Did not find protocol trace definitions, attempting to generate"
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/protocol_trace.proto'])
+    if not error:
+        print "Generated protocol trace proto definitions"
+
+        try:
+            import google.protobuf
+        except:
+            print "Please install Python protobuf module"
+            exit(-1)
+
+        import protocol_trace_pb2
+    else:
+        print "Failed to import protocol trace proto definitions"
+        exit(-1)
+
+# TransitionResult enum in src/mem/protocol/RubySlicc_Exports.sm
+results = ["Valid", "ResourceStall", "ProtocolStall", "Reject"]
+
+def main():
+    parser = OptionParser(usage="%prog [options] <protobuf input> " \
+                          "<ASCII output>")
+    parser.add_option("--machine", default=None,
+                      help="only dump transitions of this machine type")
+    parser.add_option("--addr", default=None,
+                      help="only dump transitions of this address")
+    (options, args) = parser.parse_args()
+
+    if len(args) != 2:
+        parser.print_usage()
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(args[0])
+
+    try:
+        ascii_out = open(args[1], 'w')
+    except IOError:
+        print "Failed to open ", args[1], " for writing"
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", args[0]
+        exit(-1)
+
+    print "Parsing protocol trace header"
+
+    header = protocol_trace_pb2.ProtocolTraceHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print "Object id:", header.obj_id
+    print "Tick frequency:", header.tick_freq
+
+    machines = {}
+    for machine in header.machines:
+        machines[machine.type] = machine
+        print "Machine %s: %d states, %d events" % \
+            (machine.name, len(machine.states), len(machine.events))
+
+    filter_addr = None
+    if options.addr is not None:
+        filter_addr = int(options.addr, 0)
+
+    print "Parsing transitions"
+
+    num_transitions = 0
+    num_dumped = 0
+    trans = protocol_trace_pb2.ProtocolTransition()
+
+    # Decode the transition messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, trans):
+        num_transitions += 1
+        machine = machines[trans.machine_type]
+        if options.machine is not None and machine.name != options.machine:
+            continue
+        if filter_addr is not None and trans.addr != filter_addr:
+            continue
+
+        num_dumped += 1
+        ascii_out.write('%15d %3d %10s%20s %6s>%-6s %#x' %
+                        (trans.tick, trans.version, machine.name,
+                         machine.events[trans.event],
+                         machine.states[trans.state],
+                         machine.states[trans.next_state], trans.addr))
+        if trans.HasField('result'):
+            ascii_out.write(' %s\n' % results[trans.result])
+        else:
+            ascii_out.write('\n')
+
+    print "Parsed transitions:", num_transitions
+    print "Dumped transitions:", num_dumped
+
+    # We're done
+    ascii_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
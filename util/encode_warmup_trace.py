@@ -0,0 +1,155 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2026 agent
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Authors: agent
+
+# This script converts a protobuf packet trace, e.g. captured by a
+# CommMonitor in front of a CPU while fast-forwarding, to a functional
+# warmup trace for Ruby, as read by the warmup_trace parameter of
+# RubySystem. It assumes that protoc has been executed and already
+# generated the Python package for the packet messages. This can be
+# done manually using:
+# protoc --python_out=. --proto_path=src/proto src/proto/packet.proto
+#
+# The warmup trace is a gzipped sequence of WarmupTraceRecords (see
+# src/mem/ruby/system/RubySystem.hh), each made of the 64-bit address,
+# the 32-bit index of the requesting controller in RubySystem and the
+# 32-bit RubyRequestType of the access, back to back in host byte
+# order. The packets of a trace all come from the same requestor, and
+# the controller index is given on the command line, e.g. 0 for the
+# first L1 controller. Reads become loads, or instruction fetches if
+# their request flags say so, writes become stores, and the other
+# commands are skipped.
+
+import gzip
+import protolib
+import struct
+import sys
+
+# Import the packet proto definitions. If they are not found, attempt
+# to generate them automatically. This assumes that the script is
+# executed from the gem5 root.
+try:
+    import packet_pb2
+except:
+    print "Did not find packet proto definitions, attempting to generate"
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/packet.proto'])
+    if not error:
+        print "Generated packet proto definitions"
+
+        try:
+            import google.protobuf
+        except:
+            print "Please install Python protobuf module"
+            exit(-1)
+
+        import packet_pb2
+    else:
+        print "Failed to import packet proto definitions"
+        exit(-1)
+
+# ReadReq is 1 and WriteReq is 4 in src/mem/packet.hh Command enum
+read_req = 1
+write_req = 4
+
+# INST_FETCH in src/mem/request.hh
+inst_fetch = 0x100
+
+# LD, ST and IFETCH in the RubyRequestType enumeration of
+# src/mem/protocol/RubySlicc_Exports.sm
+ruby_ld = 0
+ruby_st = 1
+ruby_ifetch = 5
+
+# WarmupTraceRecord, in host byte order without padding
+record = struct.Struct('=QII')
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print "Usage: ", sys.argv[0], " <protobuf input> <warmup trace " \
+            "output> [controller index]"
+        exit(-1)
+
+    cntrl_id = int(sys.argv[3]) if len(sys.argv) == 4 else 0
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        warmup_out = gzip.open(sys.argv[2], 'wb')
+    except IOError:
+        print "Failed to open ", sys.argv[2], " for writing"
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", sys.argv[1]
+        exit(-1)
+
+    print "Parsing packet header"
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print "Object id:", header.obj_id
+
+    print "Parsing packets"
+
+    num_packets = 0
+    num_records = 0
+    packet = packet_pb2.Packet()
+
+    # Decode the packet messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, packet):
+        num_packets += 1
+        if packet.cmd == read_req:
+            if packet.HasField('flags') and packet.flags & inst_fetch:
+                req_type = ruby_ifetch
+            else:
+                req_type = ruby_ld
+        elif packet.cmd == write_req:
+            req_type = ruby_st
+        else:
+            continue
+
+        warmup_out.write(record.pack(packet.addr, cntrl_id, req_type))
+        num_records += 1
+
+    print "Parsed packets:", num_packets
+    print "Warmup records:", num_records
+
+    # We're done
+    warmup_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()